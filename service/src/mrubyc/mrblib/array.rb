@@ -9,33 +9,6 @@
 
 class Array
 
-  #
-  # collect
-  #
-  def collect
-    i = 0
-    ary = []
-    while i < length
-      ary[i] = yield self[i]
-      i += 1
-    end
-    return ary
-  end
-  alias map collect
-
-  #
-  # collect!
-  #
-  def collect!
-    i = 0
-    while i < length
-      self[i] = yield self[i]
-      i += 1
-    end
-    return self
-  end
-  alias map! collect!
-
   #
   # delete_if
   #
@@ -51,42 +24,6 @@ class Array
     return self
   end
 
-  #
-  # each
-  #
-  def each
-    i = 0
-    while i < length
-      yield self[i]
-      i += 1
-    end
-    return self
-  end
-
-  #
-  # each index
-  #
-  def each_index
-    i = 0
-    while i < length
-      yield i
-      i += 1
-    end
-    return self
-  end
-
-  #
-  # each with index
-  #
-  def each_with_index
-    i = 0
-    while i < length
-      yield self[i], i
-      i += 1
-    end
-    return self
-  end
-
   #
   # reject!
   #
@@ -103,36 +40,4 @@ class Array
     return self.dup.delete_if( &block )
   end
 
-  #
-  # sort!
-  #
-  def sort!( &block )
-    n = length - 1
-    i = 0
-    while i < n
-      j = i
-      while j < n
-        j += 1
-        v_i = self[i]
-        v_j = self[j]
-        if block
-          next if block.call(v_i, v_j) <= 0
-        else
-          next if v_i <= v_j
-        end
-        self[i] = v_j
-        self[j] = v_i
-      end
-      i += 1
-    end
-    return self
-  end
-
-  #
-  # sort
-  #
-  def sort( &block )
-    return self.dup.sort!( &block )
-  end
-
 end
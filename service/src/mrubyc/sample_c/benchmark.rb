@@ -0,0 +1,40 @@
+#
+# benchmark program for sample_benchmark.c
+#
+
+def fib(n)
+  if n < 2
+    n
+  else
+    fib(n-1) + fib(n-2)
+  end
+end
+
+class Counter
+  def initialize
+    @count = 0
+  end
+  def up(n)
+    @count += n
+  end
+  attr_reader :count
+end
+
+# method calls
+fib(24)
+
+# loop, instance variable and arithmetic
+c = Counter.new
+i = 0
+while i < 100000
+  c.up(i % 7)
+  i += 1
+end
+
+# array and string
+a = []
+100.times {|j| a << j * 2 }
+s = ""
+a.each {|v| s << v.to_s if v % 10 == 0 }
+
+puts "fib=#{fib(15)} count=#{c.count} size=#{s.size}"
@@ -0,0 +1,107 @@
+/*
+ * This sample program measures the instruction throughput of mruby/c VM.
+ * It executes ONE mruby/c program (e.g. benchmark.rb) and prints
+ * the number of executed instructions per second.
+ *
+ * Build both library and this sample with MRBC_COUNT_INSTRUCTIONS.
+ *   $ make clean all CFLAGS=-DMRBC_COUNT_INSTRUCTIONS
+ *   $ mrbc sample_c/benchmark.rb
+ *   $ sample_c/sample_benchmark sample_c/benchmark.mrb
+ *
+ * sort_benchmark.rb measures Array#sort in the same way.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "mrubyc.h"
+
+#define MEMORY_SIZE (1024*256)
+static uint8_t memory_pool[MEMORY_SIZE];
+
+uint8_t * load_mrb_file(const char *filename)
+{
+  FILE *fp = fopen(filename, "rb");
+
+  if( fp == NULL ) {
+    fprintf(stderr, "File not found\n");
+    return NULL;
+  }
+
+  // get filesize
+  fseek(fp, 0, SEEK_END);
+  size_t size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+
+  // allocate memory
+  uint8_t *p = malloc(size);
+  if( p != NULL ) {
+    fread(p, sizeof(uint8_t), size, fp);
+  } else {
+    fprintf(stderr, "Memory allocate error.\n");
+  }
+  fclose(fp);
+
+  return p;
+}
+
+
+void mrubyc(uint8_t *mrbbuf)
+{
+  hal_init();
+  mrbc_init_alloc(memory_pool, MEMORY_SIZE);
+  mrbc_init_global();
+  mrbc_init_class();
+
+  mrbc_vm *vm = mrbc_vm_open(NULL);
+  if( vm == NULL ) {
+    fprintf(stderr, "Error: Can't assign VM-ID.\n");
+    return;
+  }
+
+  if( mrbc_load_mrb(vm, mrbbuf) != 0 ) {
+    fprintf(stderr, "Error: Illegal bytecode.\n");
+    mrbc_vm_close( vm );
+    return;
+  }
+  mrbc_vm_begin( vm );
+
+  struct timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  while( mrbc_vm_run( vm ) == 0 && !vm->exc ) {
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  double sec = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+#if defined(MRBC_COUNT_INSTRUCTIONS)
+  printf("%lu instructions, %.3f sec, %.0f instructions/sec\n",
+	 (unsigned long)vm->inst_count, sec, vm->inst_count / sec);
+#else
+  printf("%.3f sec (build with MRBC_COUNT_INSTRUCTIONS to count instructions)\n", sec);
+#endif
+
+  // catch exception from mruby/c vm
+  if( vm->exc ){
+    printf("unhandled exception\n");
+  }
+
+  mrbc_vm_end( vm );
+  mrbc_vm_close( vm );
+}
+
+
+int main(int argc, char *argv[])
+{
+  if( argc != 2 ) {
+    printf("Usage: %s <xxxx.mrb>\n", argv[0]);
+    return 1;
+  }
+
+  uint8_t *mrbbuf = load_mrb_file( argv[1] );
+  if( mrbbuf == 0 ) return 1;
+
+  mrubyc( mrbbuf );
+  free( mrbbuf );
+
+  return 0;
+}
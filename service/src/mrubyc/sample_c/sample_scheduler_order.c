@@ -0,0 +1,96 @@
+/*
+ * This sample program checks the order in which the scheduler runs tasks.
+ * Five tasks run the same bytecode with different priorities and sleep
+ * times, and each task records its name with "mark".
+ *
+ *  - Lower priority value runs first. Priorities 24 and 31 share one
+ *    ready queue level, and 24 must still run first.
+ *  - relinquish moves a task behind the others of the same priority.
+ *  - Sleeping tasks wake up in order of their wake-up time, not of
+ *    priority. 40ms and 168ms fall into the same timer wheel slot.
+ *
+ * The compiled mruby bytecode file should be prepared by "mrbc" command
+ * as followings:
+ *
+ *    mrbc -E -Bcode sample_scheduler_order_bytecode.rb
+ *
+ * Exit status is 0 if the order is as expected.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mrubyc.h"
+
+#include "sample_scheduler_order_bytecode.c"
+
+#define MEMORY_SIZE (1024*40)
+static uint8_t memory_pool[MEMORY_SIZE];
+
+static struct {
+  char name;
+  uint8_t priority;
+  int wait_ms;
+  mrbc_tcb tcb;
+} tasks[] = {
+  { 'C',  31,  80 },
+  { 'A',  10, 168 },
+  { 'D', 200,  40 },
+  { 'E',  24, 120 },
+  { 'B',  10, 200 },
+};
+#define NUM_TASKS (sizeof(tasks) / sizeof(tasks[0]))
+
+// two marks in priority order, then one mark in wake-up order.
+static const char expected[] = "ABABEECCDD" "DCEAB";
+static char result[sizeof(expected)];
+static int result_len;
+
+
+static int find_task(mrbc_vm *vm)
+{
+  int i;
+  for( i = 0; i < NUM_TASKS; i++ ) {
+    if( &tasks[i].tcb.vm == vm ) return i;
+  }
+  return -1;
+}
+
+
+static void c_mark(mrbc_vm *vm, mrbc_value v[], int argc)
+{
+  result[result_len++] = tasks[find_task(vm)].name;
+  if( result_len < sizeof(expected) - 1 ) return;
+
+  if( strcmp(result, expected) == 0 ) {
+    printf("OK: %s\n", result);
+    exit(0);
+  }
+  printf("NG: %s (expected %s)\n", result, expected);
+  exit(1);
+}
+
+
+static void c_wait_ms(mrbc_vm *vm, mrbc_value v[], int argc)
+{
+  SET_INT_RETURN( tasks[find_task(vm)].wait_ms );
+}
+
+
+int main(void)
+{
+  int i;
+
+  mrbc_init(memory_pool, MEMORY_SIZE);
+  mrbc_define_method(0, mrbc_class_object, "mark", c_mark);
+  mrbc_define_method(0, mrbc_class_object, "wait_ms", c_wait_ms);
+
+  for( i = 0; i < NUM_TASKS; i++ ) {
+    mrbc_init_tcb( &tasks[i].tcb );
+    tasks[i].tcb.priority = tasks[i].priority;
+    if( mrbc_create_task(code, &tasks[i].tcb) == NULL ) return 1;
+  }
+
+  mrbc_run();
+  return 1;
+}
@@ -0,0 +1,23 @@
+/* dumped in big endian order.
+   use `mrbc -e` option for better performance on little endian CPU. */
+#include <stdint.h>
+#ifdef __cplusplus
+extern const uint8_t code[];
+#endif
+const uint8_t
+#if defined __GNUC__
+__attribute__((aligned(4)))
+#elif defined _MSC_VER
+__declspec(align(4))
+#endif
+code[] = {
+0x52,0x49,0x54,0x45,0x30,0x30,0x30,0x36,0x08,0xec,0x00,0x00,0x00,0x90,0x4d,0x41,
+0x54,0x5a,0x30,0x30,0x30,0x30,0x49,0x52,0x45,0x50,0x00,0x00,0x00,0x72,0x30,0x30,
+0x30,0x32,0x00,0x00,0x00,0xdf,0x00,0x01,0x00,0x04,0x00,0x00,0x00,0x00,0x00,0x27,
+0x10,0x01,0x2e,0x01,0x00,0x00,0x10,0x01,0x2e,0x01,0x01,0x00,0x10,0x01,0x2e,0x01,
+0x00,0x00,0x10,0x01,0x10,0x02,0x2e,0x02,0x02,0x00,0x2e,0x01,0x03,0x01,0x10,0x01,
+0x2e,0x01,0x00,0x00,0x37,0x01,0x67,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x04,0x00,
+0x04,0x6d,0x61,0x72,0x6b,0x00,0x00,0x0a,0x72,0x65,0x6c,0x69,0x6e,0x71,0x75,0x69,
+0x73,0x68,0x00,0x00,0x07,0x77,0x61,0x69,0x74,0x5f,0x6d,0x73,0x00,0x00,0x08,0x73,
+0x6c,0x65,0x65,0x70,0x5f,0x6d,0x73,0x00,0x45,0x4e,0x44,0x00,0x00,0x00,0x00,0x08,
+};
@@ -0,0 +1,9 @@
+#
+# mrbc -E -Bcode sample_scheduler_order_bytecode.rb
+#
+
+mark
+relinquish
+mark
+sleep_ms wait_ms
+mark
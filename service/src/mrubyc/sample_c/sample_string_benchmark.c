@@ -0,0 +1,69 @@
+/*
+ * This sample program measures the string building throughput of mruby/c.
+ * It builds a 1KB string by appending one character at a time,
+ * and prints the number of strings built per second.
+ *
+ *   $ sample_c/sample_string_benchmark [loop count]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "mrubyc.h"
+
+#define MEMORY_SIZE (1024*40)
+static uint8_t memory_pool[MEMORY_SIZE];
+
+#define STRING_LENGTH 1024
+
+
+double elapsed(const struct timespec *t0)
+{
+  struct timespec t1;
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  return (t1.tv_sec - t0->tv_sec) + (t1.tv_nsec - t0->tv_nsec) / 1e9;
+}
+
+
+void bench(const char *title, int by_string, long loop)
+{
+  struct timespec t0;
+  mrbc_value ch = by_string ? mrbc_string_new_cstr(0, "x") : mrbc_fixnum_value('x');
+  long i;
+  int j;
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for( i = 0; i < loop; i++ ) {
+    mrbc_value s = mrbc_string_new(0, NULL, 0);
+    for( j = 0; j < STRING_LENGTH; j++ ) {
+      if( mrbc_string_append( &s, &ch ) != 0 ) {
+	printf("Out of memory.\n");
+	exit(1);
+      }
+    }
+    mrbc_string_delete( &s );
+  }
+  double sec = elapsed(&t0);
+
+  printf("%-8s %ld strings, %.3f sec, %.0f strings/sec, %.0f chars/sec\n",
+	 title, loop, sec, loop / sec, loop * STRING_LENGTH / sec);
+
+  if( by_string ) mrbc_string_delete( &ch );
+}
+
+
+int main(int argc, char *argv[])
+{
+  long loop = (argc >= 2) ? atol(argv[1]) : 10000;
+
+  hal_init();
+  mrbc_init_alloc(memory_pool, MEMORY_SIZE);
+  mrbc_init_global();
+  mrbc_init_class();
+
+  bench("fixnum", 0, loop);
+  bench("string", 1, loop);
+
+  return 0;
+}
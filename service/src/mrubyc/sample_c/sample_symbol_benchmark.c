@@ -0,0 +1,85 @@
+/*
+ * This sample program measures the symbol lookup throughput of mruby/c.
+ * It converts built-in, runtime and unregistered names to symbol IDs
+ * repeatedly, and prints the number of lookups per second.
+ *
+ *   $ sample_c/sample_symbol_benchmark [loop count]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "mrubyc.h"
+
+#define MEMORY_SIZE (1024*40)
+static uint8_t memory_pool[MEMORY_SIZE];
+
+static const char *builtin_names[] = {
+  "initialize", "each", "to_s", "+", "<=>", "Array", "size", "[]=",
+  "each_with_index", "StandardError", "upcase", "inspect", "!=", "push",
+  "sqrt", "times",
+};
+
+static const char *runtime_names[] = {
+  "set_therm", "get_therm", "day", "night", "arm", "disarm",
+  "play", "volume", "@temp", "@mode", "@count", "alarm_on",
+  "payload", "token", "command", "response",
+};
+
+static const char *unknown_names[] = {
+  "no_such_1", "no_such_2", "x", "zz", "initialize_x", "each!", "to_ss",
+  "Arrays",
+};
+
+#define COUNTOF(a) (sizeof(a) / sizeof((a)[0]))
+
+
+double elapsed(const struct timespec *t0)
+{
+  struct timespec t1;
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  return (t1.tv_sec - t0->tv_sec) + (t1.tv_nsec - t0->tv_nsec) / 1e9;
+}
+
+
+void bench(const char *title, const char **names, int num, long loop)
+{
+  struct timespec t0;
+  volatile long sum = 0;
+  long i;
+  int j;
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for( i = 0; i < loop; i++ ) {
+    for( j = 0; j < num; j++ ) {
+      sum += mrbc_search_symid( names[j] );
+    }
+  }
+  double sec = elapsed(&t0);
+
+  printf("%-8s %ld lookups, %.3f sec, %.0f lookups/sec\n",
+	 title, loop * num, sec, loop * num / sec);
+}
+
+
+int main(int argc, char *argv[])
+{
+  long loop = (argc >= 2) ? atol(argv[1]) : 1000000;
+  int i;
+
+  hal_init();
+  mrbc_init_alloc(memory_pool, MEMORY_SIZE);
+  mrbc_init_global();
+  mrbc_init_class();
+
+  for( i = 0; i < COUNTOF(runtime_names); i++ ) {
+    mrbc_str_to_symid( runtime_names[i] );
+  }
+
+  bench("builtin", builtin_names, COUNTOF(builtin_names), loop);
+  bench("runtime", runtime_names, COUNTOF(runtime_names), loop);
+  bench("unknown", unknown_names, COUNTOF(unknown_names), loop);
+
+  return 0;
+}
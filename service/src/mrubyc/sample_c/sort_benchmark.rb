@@ -0,0 +1,23 @@
+#
+# sort benchmark program for sample_benchmark.c
+#  sorts 1,000 Fixnums and 1,000 short Strings.
+#
+
+seed = 1
+nums = []
+strs = []
+1000.times {
+  seed = (seed * 75 + 74) % 65537
+  nums << seed
+  strs << "k" + seed.to_s
+}
+
+a = nil
+b = nil
+5.times {
+  a = nums.sort
+  b = strs.sort
+}
+c = nums.sort {|x,y| y <=> x }
+
+puts "fixnum=#{a[0]}..#{a[-1]} string=#{b[0]}..#{b[-1]} block=#{c[0]}"
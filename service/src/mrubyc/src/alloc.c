@@ -38,6 +38,19 @@
     *prev: linked list, pointer to the previous free block of same block size.
     *top : pointer to this block's top.
 
+  SLAB PAGE (see struct SLAB_PAGE)
+   Small requests are served from slab pages, that are carved out of
+   the TLSF memory blocks. A page has SLAB_SLOTS_PER_PAGE slots of the
+   same size class, and a bitmap to track free slots.
+
+     | USED_BLOCK |  SLAB_PAGE          | slot 0          | slot 1     |...
+     +------------+---------------------+-----------------+------------+---
+     |size        |*next|*prev|bitmap|..|size| (contents) |size| (cont.|
+                                     USED|   0|            |   0|
+
+    slot's size member has the offset to SLAB_PAGE, and USED flag is 0.
+    (a TLSF block that is passed to free or realloc always has USED flag)
+
   </pre>
 */
 
@@ -96,11 +109,37 @@
 // #define MRBC_MIN_MEMORY_BLOCK_SIZE (1 << MRBC_ALLOC_IGNORE_LSBS)
 #endif
 
+/*
+  Slab size classes.
+  class N serves the request size up to (N+1) * 8 bytes.
+  define as 0 to disable the slab allocator.
+  each class in use pins a page of 16 slots, so hal_x86 (30KB heap)
+  leaves it off by default.
+*/
+#if !defined(MRBC_ALLOC_SLAB_NUM_CLASSES)
+# if defined(MRBC_USE_HAL_X86)
+#  define MRBC_ALLOC_SLAB_NUM_CLASSES 0
+# else
+#  define MRBC_ALLOC_SLAB_NUM_CLASSES 6
+# endif
+#endif
+#define SLAB_GRANULE_BITS	3
+#define SLAB_SLOTS_PER_PAGE	16
+#define SLAB_MAX_SIZE		(MRBC_ALLOC_SLAB_NUM_CLASSES << SLAB_GRANULE_BITS)
+#define SLAB_ALL_FREE		0xffff
+#define MSB_BIT1_SLAB		0x8000
+
 
 /***** Macros ***************************************************************/
 #define FLI(x) ((x) >> MRBC_ALLOC_SLI_BIT_WIDTH)
 #define SLI(x) ((x) & ((1 << MRBC_ALLOC_SLI_BIT_WIDTH) - 1))
 
+#define SLAB_CLASS(size)	((size) == 0 ? 0 : ((size) - 1) >> SLAB_GRANULE_BITS)
+#define SLAB_CLASS_SIZE(c)	(((c) + 1) << SLAB_GRANULE_BITS)
+#define SLAB_SLOT_SIZE(c)	(sizeof(USED_BLOCK) + SLAB_CLASS_SIZE(c))
+#define SLAB_PAGE_SIZE(c)	(sizeof(SLAB_PAGE) + SLAB_SLOT_SIZE(c) * SLAB_SLOTS_PER_PAGE)
+#define SLAB_SLOT_TOP(p)	((uint8_t *)(p) + sizeof(SLAB_PAGE))
+
 
 /***** Typedefs *************************************************************/
 /*
@@ -196,6 +235,18 @@ typedef struct FREE_BLOCK {
 #endif
 
 
+/*
+  define slab page header
+*/
+typedef struct SLAB_PAGE {
+  struct SLAB_PAGE *next;	//!< circular link of the same class pages.
+  struct SLAB_PAGE *prev;
+  uint16_t free_bitmap;		//!< 1 is free slot. MSB is slot 0.
+  uint8_t  class_idx;		//!< size class.
+  uint8_t  pad[1];
+} SLAB_PAGE;
+
+
 /*
   define memory pool header
 */
@@ -210,6 +261,18 @@ typedef struct MEMORY_POOL {
 
   // free memory block index
   FREE_BLOCK *free_blocks[SIZE_FREE_BLOCKS +1];	// +1=sentinel
+
+#if MRBC_ALLOC_SLAB_NUM_CLASSES > 0
+  // slab pages of each size class.
+  //  pages that have free slot are placed before the full pages.
+  SLAB_PAGE *slab_pages[MRBC_ALLOC_SLAB_NUM_CLASSES];
+#endif
+
+#if defined(MRBC_DEBUG)
+  // # of mrbc_raw_alloc() and mrbc_raw_free() calls.
+  uint32_t alloc_count;
+  uint32_t free_count;
+#endif
 } MEMORY_POOL;
 
 #define BLOCK_TOP(p) ((void *)((uint8_t *)(p) + sizeof(MEMORY_POOL)))
@@ -405,67 +468,16 @@ static inline void merge_block(FREE_BLOCK *target, FREE_BLOCK *next)
 }
 
 
-/***** Global functions *****************************************************/
-//================================================================
-/*! initialize
-
-  @param  ptr	pointer to free memory block.
-  @param  size	size. (max 64KB. see MRBC_ALLOC_MEMSIZE_T)
-*/
-void mrbc_init_alloc(void *ptr, unsigned int size)
-{
-  assert( MRBC_MIN_MEMORY_BLOCK_SIZE >= sizeof(FREE_BLOCK) );
-  assert( MRBC_MIN_MEMORY_BLOCK_SIZE >= (1 << MRBC_ALLOC_IGNORE_LSBS) );
-  assert( (sizeof(MEMORY_POOL) & 0x03) == 0 );
-  assert( size != 0 );
-  assert( size <= (MRBC_ALLOC_MEMSIZE_T)(~0) );
-
-  if( memory_pool != NULL ) return;
-  size &= ~(unsigned int)0x03;	// align 4 byte.
-  memory_pool = ptr;
-  memset( memory_pool, 0, sizeof(MEMORY_POOL) );
-  memory_pool->size = size;
-
-  // initialize memory pool
-  //  large free block + zero size used block (sentinel).
-  MRBC_ALLOC_MEMSIZE_T sentinel_size = sizeof(USED_BLOCK);
-  sentinel_size += (-sentinel_size & 3);
-  MRBC_ALLOC_MEMSIZE_T free_size = size - sizeof(MEMORY_POOL) - sentinel_size;
-  FREE_BLOCK *free_block = BLOCK_TOP(memory_pool);
-  USED_BLOCK *used_block = (USED_BLOCK *)((uint8_t *)free_block + free_size);
-
-  free_block->size = free_size | 0x02;		// flag prev=1, used=0
-  used_block->size = sentinel_size | 0x01;	// flag prev=0, used=1
-
-  add_free_block( memory_pool, free_block );
-}
-
-
-//================================================================
-/*! cleanup memory pool
-*/
-void mrbc_cleanup_alloc(void)
-{
-#if defined(MRBC_DEBUG)
-  if( memory_pool ) {
-    memset( memory_pool, 0, memory_pool->size );
-  }
-#endif
-
-  memory_pool = 0;
-}
-
-
 //================================================================
-/*! allocate memory
+/*! allocate TLSF memory block
 
+  @param  pool	Pointer to memory pool.
   @param  size	request size.
   @return void * pointer to allocated memory.
   @retval NULL	error.
 */
-void * mrbc_raw_alloc(unsigned int size)
+static void * alloc_block(MEMORY_POOL *pool, unsigned int size)
 {
-  MEMORY_POOL *pool = memory_pool;
   MRBC_ALLOC_MEMSIZE_T alloc_size = size + sizeof(USED_BLOCK);
 
   // align 4 byte
@@ -519,12 +531,6 @@ void * mrbc_raw_alloc(unsigned int size)
     target = target->next_free;
   }
 
-  // else out of memory
-  static const char msg[] = "Fatal error: Out of memory.\n";
-  hal_write(1, msg, sizeof(msg)-1);
-#if defined(MRBC_OUT_OF_MEMORY)
-  MRBC_OUT_OF_MEMORY();
-#endif
   return NULL;  // ENOMEM
 
 
@@ -572,6 +578,249 @@ void * mrbc_raw_alloc(unsigned int size)
 }
 
 
+#if MRBC_ALLOC_SLAB_NUM_CLASSES > 0
+//================================================================
+/*! link the slab page to the top of class list.
+
+  @param  pool	Pointer to memory pool.
+  @param  page	Pointer to slab page.
+*/
+static void link_slab_page(MEMORY_POOL *pool, SLAB_PAGE *page)
+{
+  SLAB_PAGE **head = &pool->slab_pages[page->class_idx];
+
+  if( *head == NULL ) {
+    page->next = page->prev = page;
+  } else {
+    page->next = *head;
+    page->prev = (*head)->prev;
+    page->prev->next = page;
+    page->next->prev = page;
+  }
+  *head = page;
+}
+
+
+//================================================================
+/*! unlink the slab page from class list.
+
+  @param  pool	Pointer to memory pool.
+  @param  page	Pointer to slab page.
+*/
+static void unlink_slab_page(MEMORY_POOL *pool, SLAB_PAGE *page)
+{
+  SLAB_PAGE **head = &pool->slab_pages[page->class_idx];
+
+  if( page->next == page ) {
+    *head = NULL;
+    return;
+  }
+  page->prev->next = page->next;
+  page->next->prev = page->prev;
+  if( *head == page ) *head = page->next;
+}
+
+
+//================================================================
+/*! allocate memory from slab
+
+  @param  pool	Pointer to memory pool.
+  @param  size	request size.
+  @return void * pointer to allocated memory.
+  @retval NULL	error.
+*/
+static void * slab_alloc(MEMORY_POOL *pool, unsigned int size)
+{
+  unsigned int cls = SLAB_CLASS(size);
+  SLAB_PAGE *page = pool->slab_pages[cls];
+
+  // all pages are full, add a new page.
+  if( page == NULL || page->free_bitmap == 0 ) {
+    page = alloc_block( pool, SLAB_PAGE_SIZE(cls) );
+    if( page == NULL ) return NULL;	// ENOMEM
+
+    page->free_bitmap = SLAB_ALL_FREE;
+    page->class_idx = cls;
+    link_slab_page( pool, page );
+  }
+
+  int idx = nlz16( page->free_bitmap );
+  page->free_bitmap &= ~(MSB_BIT1_SLAB >> idx);
+
+  // page become full, move it to the tail.
+  if( page->free_bitmap == 0 ) pool->slab_pages[cls] = page->next;
+
+  USED_BLOCK *slot = (USED_BLOCK *)(SLAB_SLOT_TOP(page) + SLAB_SLOT_SIZE(cls) * idx);
+  slot->size = (uint8_t *)slot - (uint8_t *)page;	// USED flag is 0.
+#if defined(MRBC_ALLOC_VMID)
+  slot->vm_id = 0;
+#endif
+
+#ifdef MRBC_DEBUG
+  memset( (uint8_t *)slot + sizeof(USED_BLOCK), 0xaa, SLAB_CLASS_SIZE(cls) );
+#endif
+
+  return (uint8_t *)slot + sizeof(USED_BLOCK);
+}
+
+
+//================================================================
+/*! release slab memory
+
+  @param  pool	Pointer to memory pool.
+  @param  slot	Pointer to slot header.
+*/
+static void slab_free(MEMORY_POOL *pool, USED_BLOCK *slot)
+{
+  SLAB_PAGE *page = (SLAB_PAGE *)((uint8_t *)slot - BLOCK_SIZE(slot));
+  SLAB_PAGE *head = pool->slab_pages[page->class_idx];
+  int idx = ((uint8_t *)slot - SLAB_SLOT_TOP(page)) / SLAB_SLOT_SIZE(page->class_idx);
+  int was_full = (page->free_bitmap == 0);
+
+  assert( (page->free_bitmap & (MSB_BIT1_SLAB >> idx)) == 0 );
+  page->free_bitmap |= (MSB_BIT1_SLAB >> idx);
+  if( page == head ) return;
+
+  if( was_full ) {
+    // page has a free slot again, move it to the top.
+    unlink_slab_page( pool, page );
+    link_slab_page( pool, page );
+
+  } else if( page->free_bitmap == SLAB_ALL_FREE ) {
+    // release an empty page, except the top page.
+    unlink_slab_page( pool, page );
+    mrbc_raw_free( (uint8_t *)page );
+  }
+}
+
+
+#if defined(MRBC_ALLOC_VMID)
+//================================================================
+/*! re-order the slab pages in class list after bulk release.
+
+  @param  pool	Pointer to memory pool.
+  @param  cls	size class.
+*/
+static void slab_reorder(MEMORY_POOL *pool, unsigned int cls)
+{
+  SLAB_PAGE *page = pool->slab_pages[cls];
+  if( page == NULL ) return;
+
+  // detach all pages, and link it again.
+  int n = 0;
+  do {
+    n++;
+    page = page->next;
+  } while( page != pool->slab_pages[cls] );
+  pool->slab_pages[cls] = NULL;
+
+  while( n-- > 0 ) {
+    SLAB_PAGE *next = page->next;
+
+    if( page->free_bitmap == 0 ) {
+      // full page is linked at the tail.
+      link_slab_page( pool, page );
+      pool->slab_pages[cls] = page->next;
+    } else if( page->free_bitmap != SLAB_ALL_FREE ||
+	       pool->slab_pages[cls] == NULL ) {
+      link_slab_page( pool, page );
+    } else {
+      mrbc_raw_free( (uint8_t *)page );
+    }
+    page = next;
+  }
+}
+#endif	// defined(MRBC_ALLOC_VMID)
+#endif	// MRBC_ALLOC_SLAB_NUM_CLASSES > 0
+
+
+/***** Global functions *****************************************************/
+//================================================================
+/*! initialize
+
+  @param  ptr	pointer to free memory block.
+  @param  size	size. (max 64KB. see MRBC_ALLOC_MEMSIZE_T)
+*/
+void mrbc_init_alloc(void *ptr, unsigned int size)
+{
+  assert( MRBC_MIN_MEMORY_BLOCK_SIZE >= sizeof(FREE_BLOCK) );
+  assert( MRBC_MIN_MEMORY_BLOCK_SIZE >= (1 << MRBC_ALLOC_IGNORE_LSBS) );
+  assert( (sizeof(MEMORY_POOL) & 0x03) == 0 );
+  assert( size != 0 );
+  assert( size <= (MRBC_ALLOC_MEMSIZE_T)(~0) );
+
+  if( memory_pool != NULL ) return;
+  size &= ~(unsigned int)0x03;	// align 4 byte.
+  memory_pool = ptr;
+  memset( memory_pool, 0, sizeof(MEMORY_POOL) );
+  memory_pool->size = size;
+
+  // initialize memory pool
+  //  large free block + zero size used block (sentinel).
+  MRBC_ALLOC_MEMSIZE_T sentinel_size = sizeof(USED_BLOCK);
+  sentinel_size += (-sentinel_size & 3);
+  MRBC_ALLOC_MEMSIZE_T free_size = size - sizeof(MEMORY_POOL) - sentinel_size;
+  FREE_BLOCK *free_block = BLOCK_TOP(memory_pool);
+  USED_BLOCK *used_block = (USED_BLOCK *)((uint8_t *)free_block + free_size);
+
+  free_block->size = free_size | 0x02;		// flag prev=1, used=0
+  used_block->size = sentinel_size | 0x01;	// flag prev=0, used=1
+
+  add_free_block( memory_pool, free_block );
+}
+
+
+//================================================================
+/*! cleanup memory pool
+*/
+void mrbc_cleanup_alloc(void)
+{
+#if defined(MRBC_DEBUG)
+  if( memory_pool ) {
+    memset( memory_pool, 0, memory_pool->size );
+  }
+#endif
+
+  memory_pool = 0;
+}
+
+
+//================================================================
+/*! allocate memory
+
+  @param  size	request size.
+  @return void * pointer to allocated memory.
+  @retval NULL	error.
+*/
+void * mrbc_raw_alloc(unsigned int size)
+{
+  MEMORY_POOL *pool = memory_pool;
+  void *ptr;
+
+#if defined(MRBC_DEBUG)
+  pool->alloc_count++;
+#endif
+
+#if MRBC_ALLOC_SLAB_NUM_CLASSES > 0
+  if( size <= SLAB_MAX_SIZE ) {
+    ptr = slab_alloc( pool, size );
+    if( ptr != NULL ) return ptr;
+  }
+#endif
+
+  ptr = alloc_block( pool, size );
+  if( ptr != NULL ) return ptr;
+
+  // else out of memory
+  static const char msg[] = "Fatal error: Out of memory.\n";
+  hal_write(1, msg, sizeof(msg)-1);
+#if defined(MRBC_OUT_OF_MEMORY)
+  MRBC_OUT_OF_MEMORY();
+#endif
+  return NULL;  // ENOMEM
+}
+
+
 //================================================================
 /*! allocate memory that cannot free and realloc
 
@@ -633,6 +882,17 @@ void mrbc_raw_free(void *ptr)
   // get target block
   FREE_BLOCK *target = (FREE_BLOCK *)((uint8_t *)ptr - sizeof(USED_BLOCK));
 
+#if defined(MRBC_DEBUG)
+  pool->free_count++;
+#endif
+
+#if MRBC_ALLOC_SLAB_NUM_CLASSES > 0
+  if( IS_FREE_BLOCK(target) ) {		// slab slot
+    slab_free( pool, (USED_BLOCK *)target );
+    return;
+  }
+#endif
+
   // check next block, merge?
   FREE_BLOCK *next = PHYS_NEXT(target);
 
@@ -673,6 +933,22 @@ void * mrbc_raw_realloc(void *ptr, unsigned int size)
   MRBC_ALLOC_MEMSIZE_T alloc_size = size + sizeof(USED_BLOCK);
   FREE_BLOCK *next;
 
+#if MRBC_ALLOC_SLAB_NUM_CLASSES > 0
+  if( IS_FREE_BLOCK(target) ) {		// slab slot
+    unsigned int slot_size = SLAB_CLASS_SIZE(((SLAB_PAGE *)((uint8_t *)target - BLOCK_SIZE(target)))->class_idx);
+    if( size <= slot_size ) return ptr;
+
+    void *new_ptr = mrbc_raw_alloc(size);
+    if( new_ptr == NULL ) return NULL;  // ENOMEM
+
+    memcpy(new_ptr, ptr, slot_size);
+    SET_VM_ID(new_ptr, GET_VM_ID(ptr));
+    slab_free( pool, target );
+
+    return new_ptr;
+  }
+#endif
+
   // align 4 byte
   alloc_size += (-alloc_size & 3);
 
@@ -759,6 +1035,28 @@ void mrbc_free_all(const struct VM *vm)
   USED_BLOCK *next;
   int vm_id = vm->vm_id;
 
+#if MRBC_ALLOC_SLAB_NUM_CLASSES > 0
+  unsigned int cls;
+  for( cls = 0; cls < MRBC_ALLOC_SLAB_NUM_CLASSES; cls++ ) {
+    SLAB_PAGE *page = pool->slab_pages[cls];
+    if( page == NULL ) continue;
+
+    do {
+      uint8_t *slot = SLAB_SLOT_TOP(page);
+      int i;
+      for( i = 0; i < SLAB_SLOTS_PER_PAGE; i++, slot += SLAB_SLOT_SIZE(cls) ) {
+	if( (page->free_bitmap & (MSB_BIT1_SLAB >> i)) == 0 &&
+	    ((USED_BLOCK *)slot)->vm_id == vm_id ) {
+	  page->free_bitmap |= (MSB_BIT1_SLAB >> i);
+	}
+      }
+      page = page->next;
+    } while( page != pool->slab_pages[cls] );
+
+    slab_reorder( pool, cls );
+  }
+#endif
+
   while( target < (USED_BLOCK *)BLOCK_END(pool) ) {
     next = PHYS_NEXT(target);
     if( IS_USED_BLOCK(target) && (target->vm_id == vm_id) ) {
@@ -798,34 +1096,56 @@ int mrbc_get_vm_id(void *ptr)
 //================================================================
 /*! statistics
 
-  @param  total		returns total memory.
-  @param  used		returns used memory.
-  @param  free		returns free memory.
-  @param  fragmentation	returns memory fragmentation
+  @param  ret		pointer to return value.
+  (note)
+  slab pages are counted as used memory.
 */
-void mrbc_alloc_statistics(int *total, int *used, int *free, int *fragmentation)
+void mrbc_alloc_statistics(struct MRBC_ALLOC_STATISTICS *ret)
 {
   MEMORY_POOL *pool = memory_pool;
-  *total = pool->size;
-  *used = 0;
-  *free = 0;
-  *fragmentation = -1;
+  ret->total = pool->size;
+  ret->used = 0;
+  ret->free = 0;
+  ret->fragmentation = -1;
+  ret->slab_pages = 0;
+  ret->slab_slots = 0;
+  ret->slab_used = 0;
+  ret->alloc_count = pool->alloc_count;
+  ret->free_count = pool->free_count;
 
   USED_BLOCK *block = BLOCK_TOP(pool);
   int flag_used_free = IS_USED_BLOCK(block);
 
   while( block < (USED_BLOCK *)BLOCK_END(pool) ) {
     if( IS_FREE_BLOCK(block) ) {
-      *free += BLOCK_SIZE(block);
+      ret->free += BLOCK_SIZE(block);
     } else {
-      *used += BLOCK_SIZE(block);
+      ret->used += BLOCK_SIZE(block);
     }
     if( flag_used_free != IS_USED_BLOCK(block) ) {
-      (*fragmentation)++;
+      ret->fragmentation++;
       flag_used_free = IS_USED_BLOCK(block);
     }
     block = PHYS_NEXT(block);
   }
+
+#if MRBC_ALLOC_SLAB_NUM_CLASSES > 0
+  int cls;
+  for( cls = 0; cls < MRBC_ALLOC_SLAB_NUM_CLASSES; cls++ ) {
+    SLAB_PAGE *page = pool->slab_pages[cls];
+    if( page == NULL ) continue;
+
+    do {
+      uint16_t used_bitmap = ~page->free_bitmap;
+      ret->slab_pages++;
+      ret->slab_slots += SLAB_SLOTS_PER_PAGE;
+      for( ; used_bitmap != 0; used_bitmap &= used_bitmap - 1 ) {
+	ret->slab_used++;
+      }
+      page = page->next;
+    } while( page != pool->slab_pages[cls] );
+  }
+#endif
 }
 
 
@@ -32,6 +32,21 @@ extern "C" {
 /***** Typedefs *************************************************************/
 struct VM;
 
+//================================================================
+/*! Return value of mrbc_alloc_statistics()
+*/
+struct MRBC_ALLOC_STATISTICS {
+  int total;		//!< total memory.
+  int used;		//!< used memory.
+  int free;		//!< free memory.
+  int fragmentation;	//!< memory fragmentation.
+  int slab_pages;	//!< # of slab pages.
+  int slab_slots;	//!< # of slab slots.
+  int slab_used;	//!< # of slab slots in use.
+  int alloc_count;	//!< # of allocations.
+  int free_count;	//!< # of releases.
+};
+
 /***** Global variables *****************************************************/
 /***** Function prototypes and inline functions *****************************/
 #if !defined(MRBC_ALLOC_LIBC)
@@ -48,7 +63,7 @@ void *mrbc_raw_realloc(void *ptr, unsigned int size);
 #define mrbc_realloc(vm,ptr,size)	mrbc_raw_realloc(ptr, size)
 
 // for statistics or debug. (need #define MRBC_DEBUG)
-void mrbc_alloc_statistics(int *total, int *used, int *free, int *fragmentation);
+void mrbc_alloc_statistics(struct MRBC_ALLOC_STATISTICS *ret);
 void mrbc_alloc_print_memory_pool(void);
 
 
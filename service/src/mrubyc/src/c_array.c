@@ -22,6 +22,7 @@
 #include "c_array.h"
 #include "c_string.h"
 #include "console.h"
+#include "error.h"
 #include "opcode.h"
 
 /*
@@ -52,8 +53,76 @@
     mrbc_array_clear
     mrbc_array_compare
     mrbc_array_minmax
+    mrbc_array_sort
     mrbc_array_dup
+
+ (buffer layout)
+  The unused cells are kept on both side of the data, so that
+  push/pop/shift/unshift take amortized constant time.
+
+    ARRAY_BUFFER(h)     h->data
+    |<---- h->head ---->|<---------- h->data_size ---------->|
+    |   (unused cells)  | data[0] .. data[n_stored-1] |      |
+*/
+
+
+//================================================================
+/*! next buffer size to grow (x1.5)
+
+  @param  h	pointer to array handle.
+  @return	new data_size.
+*/
+static int array_grow_size( const mrbc_array *h )
+{
+  int size = h->data_size + (h->data_size >> 1);
+  if( size < h->data_size + 6 ) size = h->data_size + 6;
+  return size;
+}
+
+
+//================================================================
+/*! move the data to the top of the buffer.
+
+  @param  h	pointer to array handle.
 */
+static void array_rewind( mrbc_array *h )
+{
+  if( h->head == 0 ) return;
+
+  mrbc_value *buf = ARRAY_BUFFER(h);
+  memmove( buf, h->data, sizeof(mrbc_value) * h->n_stored );
+  h->data = buf;
+  h->data_size += h->head;
+  h->head = 0;
+}
+
+
+//================================================================
+/*! make the unused cells before data[0].
+
+  @param  ary	pointer to target value
+  @return	mrbc_error_code
+*/
+static int array_make_head( mrbc_value *ary )
+{
+  mrbc_array *h = ary->array;
+  int head = h->n_stored >> 1;
+  if( head < 4 ) head = 4;
+
+  mrbc_value *buf = mrbc_raw_alloc( sizeof(mrbc_value) * (head + h->data_size) );
+  if( !buf ) return E_NOMEMORY_ERROR;	// ENOMEM
+  mrbc_set_vm_id( buf, mrbc_get_vm_id(h) );
+
+  memcpy( buf + head, h->data, sizeof(mrbc_value) * h->n_stored );
+  if( ARRAY_BUFFER(h) != ARRAY_INLINE_DATA(h) ) {
+    mrbc_raw_free( ARRAY_BUFFER(h) );
+  }
+
+  h->data = buf + head;
+  h->head = head;
+
+  return 0;
+}
 
 
 //================================================================
@@ -70,19 +139,31 @@ mrbc_value mrbc_array_new(struct VM *vm, int size)
   /*
     Allocate handle and data buffer.
   */
-  mrbc_array *h = mrbc_alloc(vm, sizeof(mrbc_array));
-  if( !h ) return value;	// ENOMEM
+  mrbc_array *h;
+  mrbc_value *data;
+
+  if( size <= MRBC_ARRAY_INLINE_SIZE ) {
+    // small array. allocate at once.
+    h = mrbc_alloc(vm, sizeof(mrbc_array) + sizeof(mrbc_value) * size);
+    if( !h ) return value;	// ENOMEM
+    data = ARRAY_INLINE_DATA(h);
+
+  } else {
+    h = mrbc_alloc(vm, sizeof(mrbc_array));
+    if( !h ) return value;	// ENOMEM
 
-  mrbc_value *data = mrbc_alloc(vm, sizeof(mrbc_value) * size);
-  if( !data ) {			// ENOMEM
-    mrbc_raw_free( h );
-    return value;
+    data = mrbc_alloc(vm, sizeof(mrbc_value) * size);
+    if( !data ) {		// ENOMEM
+      mrbc_raw_free( h );
+      return value;
+    }
   }
 
   MRBC_INIT_OBJECT_HEADER( h, "AR" );
   h->data_size = size;
   h->n_stored = 0;
   h->data = data;
+  h->head = 0;
 
   value.array = h;
   return value;
@@ -131,15 +212,30 @@ void mrbc_array_clear_vm_id(mrbc_value *ary)
 /*! resize buffer
 
   @param  ary	pointer to target value
-  @param  size	size
+  @param  size	size (from data[0])
   @return	mrbc_error_code
 */
 int mrbc_array_resize(mrbc_value *ary, int size)
 {
   mrbc_array *h = ary->array;
+  mrbc_value *data2;
 
-  mrbc_value *data2 = mrbc_raw_realloc(h->data, sizeof(mrbc_value) * size);
-  if( !data2 ) return E_NOMEMORY_ERROR;	// ENOMEM
+  if( ARRAY_BUFFER(h) == ARRAY_INLINE_DATA(h) ) {
+    if( size <= h->data_size ) return 0;	// can't shrink inline buffer.
+
+    // move to the separated buffer.
+    data2 = mrbc_raw_alloc(sizeof(mrbc_value) * size);
+    if( !data2 ) return E_NOMEMORY_ERROR;	// ENOMEM
+    memcpy( data2, h->data, sizeof(mrbc_value) * h->n_stored );
+    mrbc_set_vm_id( data2, mrbc_get_vm_id(h) );
+    h->head = 0;
+
+  } else {
+    data2 = mrbc_raw_realloc(ARRAY_BUFFER(h),
+			     sizeof(mrbc_value) * (h->head + size));
+    if( !data2 ) return E_NOMEMORY_ERROR;	// ENOMEM
+    data2 += h->head;
+  }
 
   h->data = data2;
   h->data_size = size;
@@ -218,9 +314,12 @@ int mrbc_array_push(mrbc_value *ary, mrbc_value *set_val)
   mrbc_array *h = ary->array;
 
   if( h->n_stored >= h->data_size ) {
-    int size = h->data_size + 6;
-    if( mrbc_array_resize(ary, size) != 0 )
+    // reuse the cells released by shift, or grow the buffer.
+    if( h->head != 0 && h->head >= (h->n_stored >> 1) ) {
+      array_rewind( h );
+    } else if( mrbc_array_resize(ary, array_grow_size(h)) != 0 ) {
       return E_NOMEMORY_ERROR;		// ENOMEM
+    }
   }
 
   h->data[h->n_stored++] = *set_val;
@@ -253,7 +352,19 @@ mrbc_value mrbc_array_pop(mrbc_value *ary)
 */
 int mrbc_array_unshift(mrbc_value *ary, mrbc_value *set_val)
 {
-  return mrbc_array_insert(ary, 0, set_val);
+  mrbc_array *h = ary->array;
+
+  if( h->head == 0 && array_make_head(ary) != 0 ) {
+    return E_NOMEMORY_ERROR;		// ENOMEM
+  }
+
+  h->data--;
+  h->head--;
+  h->data_size++;
+  h->data[0] = *set_val;
+  h->n_stored++;
+
+  return 0;
 }
 
 
@@ -270,7 +381,10 @@ mrbc_value mrbc_array_shift(mrbc_value *ary)
   if( h->n_stored <= 0 ) return mrbc_nil_value();
 
   mrbc_value ret = h->data[0];
-  memmove(h->data, h->data+1, sizeof(mrbc_value) * --h->n_stored);
+  h->data++;
+  h->head++;
+  h->data_size--;
+  h->n_stored--;
 
   return ret;
 }
@@ -293,12 +407,25 @@ int mrbc_array_insert(mrbc_value *ary, int idx, mrbc_value *set_val)
     if( idx < 0 ) return E_INDEX_ERROR;		// raise?
   }
 
+  // insert into the front half. move the front datas.
+  if( idx <= (h->n_stored >> 1) && (idx == 0 || h->head != 0) ) {
+    if( idx == 0 ) return mrbc_array_unshift(ary, set_val);
+
+    memmove(h->data - 1, h->data, sizeof(mrbc_value) * idx);
+    h->data--;
+    h->head--;
+    h->data_size++;
+    h->data[idx] = *set_val;
+    h->n_stored++;
+    return 0;
+  }
+
   // need resize?
   int size = 0;
   if( idx >= h->data_size ) {
     size = idx + 1;
   } else if( h->n_stored >= h->data_size ) {
-    size = h->data_size + 1;
+    size = array_grow_size(h);
   }
   if( size && mrbc_array_resize(ary, size) != 0 ) {
     return E_NOMEMORY_ERROR;			// ENOMEM
@@ -342,6 +469,17 @@ mrbc_value mrbc_array_remove(mrbc_value *ary, int idx)
   if( idx < 0 || idx >= h->n_stored ) return mrbc_nil_value();
 
   mrbc_value val = h->data[idx];
+
+  // remove from the front half. move the front datas.
+  if( idx < (h->n_stored >> 1) ) {
+    memmove(h->data + 1, h->data, sizeof(mrbc_value) * idx);
+    h->data++;
+    h->head++;
+    h->data_size--;
+    h->n_stored--;
+    return val;
+  }
+
   h->n_stored--;
   if( idx < h->n_stored ) {
     memmove(h->data + idx, h->data + idx + 1,
@@ -368,6 +506,7 @@ void mrbc_array_clear(mrbc_value *ary)
   }
 
   h->n_stored = 0;
+  array_rewind( h );
 }
 
 
@@ -429,6 +568,144 @@ void mrbc_array_minmax(mrbc_value *ary, mrbc_value **pp_min_value, mrbc_value **
 }
 
 
+//================================================================
+/*! compare for sort. (Fixnum fast path)
+*/
+static inline int array_sort_compare( const mrbc_value *v1, const mrbc_value *v2 )
+{
+  if( v1->tt == MRBC_TT_FIXNUM && v2->tt == MRBC_TT_FIXNUM ) {
+    return (v1->i > v2->i) - (v1->i < v2->i);
+  }
+  return mrbc_compare( v1, v2 );
+}
+
+
+//================================================================
+/*! insertion sort for the short range.
+*/
+static void array_insertion_sort( mrbc_value *data, int n )
+{
+  int i, j;
+  for( i = 1; i < n; i++ ) {
+    mrbc_value v = data[i];
+    for( j = i; j > 0 && array_sort_compare( &data[j-1], &v ) > 0; j-- ) {
+      data[j] = data[j-1];
+    }
+    data[j] = v;
+  }
+}
+
+
+//================================================================
+/*! heap sort, used when the quick sort goes too deep.
+*/
+static void array_sift_down( mrbc_value *data, int i, int n )
+{
+  mrbc_value v = data[i];
+  int child;
+
+  while( (child = i * 2 + 1) < n ) {
+    if( child + 1 < n && array_sort_compare( &data[child], &data[child+1] ) < 0 ) {
+      child++;
+    }
+    if( array_sort_compare( &v, &data[child] ) >= 0 ) break;
+    data[i] = data[child];
+    i = child;
+  }
+  data[i] = v;
+}
+
+static void array_heap_sort( mrbc_value *data, int n )
+{
+  int i;
+  for( i = n / 2 - 1; i >= 0; i-- ) {
+    array_sift_down( data, i, n );
+  }
+  for( i = n - 1; i > 0; i-- ) {
+    mrbc_value v = data[0];
+    data[0] = data[i];
+    data[i] = v;
+    array_sift_down( data, 0, i );
+  }
+}
+
+
+//================================================================
+/*! introsort. (quick sort + heap sort + insertion sort)
+
+  @param  data	pointer to the first element.
+  @param  n	number of elements.
+  @param  depth	remaining depth of quick sort.
+*/
+static void array_introsort( mrbc_value *data, int n, int depth )
+{
+#define SWAP(a,b) do { mrbc_value t_ = (a); (a) = (b); (b) = t_; } while(0)
+
+  while( n > 12 ) {
+    if( depth-- == 0 ) {
+      array_heap_sort( data, n );
+      return;
+    }
+
+    // median of three.
+    mrbc_value *lo = data, *mid = data + n / 2, *hi = data + n - 1;
+    if( array_sort_compare( mid, lo ) < 0 ) SWAP( *mid, *lo );
+    if( array_sort_compare( hi, mid ) < 0 ) {
+      SWAP( *hi, *mid );
+      if( array_sort_compare( mid, lo ) < 0 ) SWAP( *mid, *lo );
+    }
+    mrbc_value pivot = *mid;
+
+    // partition. data[0..j] <= pivot <= data[i..n-1]
+    int i = 0;
+    int j = n - 1;
+    while( 1 ) {
+      while( array_sort_compare( &data[i], &pivot ) < 0 ) i++;
+      while( array_sort_compare( &pivot, &data[j] ) < 0 ) j--;
+      if( i >= j ) break;
+      SWAP( data[i], data[j] );
+      i++;
+      j--;
+    }
+    if( i == j ) {
+      i++;
+      j--;
+    }
+
+    // recurse into the smaller part, and loop for the larger part.
+    if( j + 1 < n - i ) {
+      array_introsort( data, j + 1, depth );
+      data += i;
+      n -= i;
+    } else {
+      array_introsort( data + i, n - i, depth );
+      n = j + 1;
+    }
+  }
+
+  array_insertion_sort( data, n );
+#undef SWAP
+}
+
+
+//================================================================
+/*! sort (in place, not stable)
+
+  @param  ary	pointer to target value
+*/
+void mrbc_array_sort(mrbc_value *ary)
+{
+  mrbc_array *h = ary->array;
+  int depth = 0;
+  int n;
+
+  for( n = h->n_stored; n > 1; n >>= 1 ) {
+    depth += 2;
+  }
+  array_introsort( h->data, h->n_stored, depth );
+}
+
+
 //================================================================
 /*! duplicate (shallow copy)
 
@@ -891,6 +1168,295 @@ static void c_array_minmax(struct VM *vm, mrbc_value v[], int argc)
 }
 
 
+//================================================================
+/*! (method) sort!, sort with block.
+
+  Bottom-up merge sort, calls the block n*log(n) times at most.
+  Each pass merges the runs of width elements from src to dst, and
+  self and the work array v[3] are src and dst in turn. Both arrays
+  keep a reference to their elements, so that a break or an exception
+  in the block leaves them consistent.
+  v[2] is the state of the merge, [width, lo, i, j, src is self].
+*/
+enum { SORT_WIDTH, SORT_LO, SORT_I, SORT_J, SORT_IN_SELF, SORT_STATE_SIZE };
+
+static void c_array_sort_block_next(struct VM *vm, mrbc_value v[], int argc)
+{
+  mrbc_value *st = v[2].array->data;
+  int n = mrbc_array_size(&v[3]);
+  if( mrbc_array_size(&v[0]) != n ) goto DONE;	// modified in the block.
+
+  int width = st[SORT_WIDTH].i;
+  int lo = st[SORT_LO].i;
+  int i = st[SORT_I].i;
+  int j = st[SORT_J].i;
+  mrbc_value *src = v[0].array->data;
+  mrbc_value *dst = v[3].array->data;
+  if( !st[SORT_IN_SELF].i ) {
+    src = dst;
+    dst = v[0].array->data;
+  }
+  int mid = (lo + width < n) ? lo + width : n;
+  int hi = (mid + width < n) ? mid + width : n;
+  mrbc_value *x;
+
+  // the result of the block, src[i] <=> src[j].
+  if( v[MRBC_ITERATOR_REGS].tt != MRBC_TT_EMPTY ) {
+    mrbc_value *r = &v[MRBC_ITERATOR_REGS];
+    int cmp;
+    if( r->tt == MRBC_TT_FIXNUM ) {
+      cmp = (r->i > 0);
+#if MRBC_USE_FLOAT
+    } else if( r->tt == MRBC_TT_FLOAT ) {
+      cmp = (r->d > 0);
+#endif
+    } else {
+      mrbc_raise_exception( vm, mrbc_class_argumenterror );
+      return;
+    }
+    mrbc_decref_empty( r );
+
+    x = cmp ? &src[j++] : &src[i++];
+    mrbc_incref( x );
+    mrbc_decref( &dst[i + j - mid - 1] );
+    dst[i + j - mid - 1] = *x;
+  }
+
+  while( 1 ) {
+    if( i < mid && j < hi ) {
+      st[SORT_WIDTH].i = width;
+      st[SORT_LO].i = lo;
+      st[SORT_I].i = i;
+      st[SORT_J].i = j;
+      mrbc_value args[2] = { src[i], src[j] };
+      mrbc_iterator_yield( vm, v, c_array_sort_block_next, 2, args );
+      return;
+    }
+
+    // copy the rest of the run.
+    while( i < mid || j < hi ) {
+      x = (i < mid) ? &src[i++] : &src[j++];
+      mrbc_incref( x );
+      mrbc_decref( &dst[i + j - mid - 1] );
+      dst[i + j - mid - 1] = *x;
+    }
+
+    // next runs.
+    lo = hi;
+    if( lo >= n ) {
+      // next pass.
+      width *= 2;
+      st[SORT_IN_SELF].i = !st[SORT_IN_SELF].i;
+      if( width >= n ) break;
+      lo = 0;
+      x = src;
+      src = dst;
+      dst = x;
+    }
+    mid = (lo + width < n) ? lo + width : n;
+    hi = (mid + width < n) ? mid + width : n;
+    i = lo;
+    j = mid;
+  }
+
+  // the result is in the work array, move it back to self.
+  if( !st[SORT_IN_SELF].i ) {
+    for( i = 0; i < n; i++ ) {
+      mrbc_incref( &dst[i] );
+      mrbc_decref( &src[i] );
+      src[i] = dst[i];
+    }
+  }
+
+ DONE:
+  mrbc_iterator_end( v );
+}
+
+
+//================================================================
+/*! (method) sort!
+*/
+static void c_array_sort_self(struct VM *vm, mrbc_value v[], int argc)
+{
+  if( v[1].tt != MRBC_TT_PROC || mrbc_array_size(&v[0]) < 2 ) {
+    mrbc_array_sort( &v[0] );
+    return;
+  }
+
+  mrbc_value st = mrbc_array_new( vm, SORT_STATE_SIZE );
+  if( st.array == NULL ) return;		// ENOMEM
+  mrbc_value work = mrbc_array_dup( vm, &v[0] );
+  if( work.array == NULL ) {			// ENOMEM
+    mrbc_array_delete( &st );
+    return;
+  }
+
+  int i;
+  for( i = 0; i < SORT_STATE_SIZE; i++ ) {
+    st.array->data[i] = mrbc_fixnum_value(0);
+  }
+  st.array->n_stored = SORT_STATE_SIZE;
+  st.array->data[SORT_WIDTH].i = 1;
+  st.array->data[SORT_J].i = 1;
+  st.array->data[SORT_IN_SELF].i = 1;
+
+  mrbc_decref( &v[2] );
+  v[2] = st;
+  mrbc_decref( &v[3] );
+  v[3] = work;
+  mrbc_decref_empty( &v[MRBC_ITERATOR_REGS] );
+  c_array_sort_block_next( vm, v, 0 );
+}
+
+
+//================================================================
+/*! (method) sort
+*/
+static void c_array_sort(struct VM *vm, mrbc_value v[], int argc)
+{
+  mrbc_value ret = mrbc_array_dup( vm, &v[0] );
+  if( ret.array == NULL ) return;		// ENOMEM
+
+  mrbc_decref( &v[0] );
+  v[0] = ret;
+  c_array_sort_self( vm, v, argc );
+}
+
+
+//================================================================
+/*! (method) each
+*/
+static void c_array_each_next(struct VM *vm, mrbc_value v[], int argc)
+{
+  int i = v[2].i;
+
+  if( i < mrbc_array_size(&v[0]) ) {
+    v[2].i++;
+    mrbc_iterator_yield( vm, v, c_array_each_next, 1, &v[0].array->data[i] );
+    return;
+  }
+
+  mrbc_iterator_end( v );
+}
+
+static void c_array_each(struct VM *vm, mrbc_value v[], int argc)
+{
+  if( argc != 0 || mrbc_iterator_check_block( vm, v ) != 0 ) return;
+
+  mrbc_decref( &v[2] );
+  v[2] = mrbc_fixnum_value(0);
+  c_array_each_next( vm, v, 0 );
+}
+
+
+//================================================================
+/*! (method) each_index
+*/
+static void c_array_each_index_next(struct VM *vm, mrbc_value v[], int argc)
+{
+  if( v[2].i < mrbc_array_size(&v[0]) ) {
+    mrbc_value i = v[2];
+    v[2].i++;
+    mrbc_iterator_yield( vm, v, c_array_each_index_next, 1, &i );
+    return;
+  }
+
+  mrbc_iterator_end( v );
+}
+
+static void c_array_each_index(struct VM *vm, mrbc_value v[], int argc)
+{
+  if( argc != 0 || mrbc_iterator_check_block( vm, v ) != 0 ) return;
+
+  mrbc_decref( &v[2] );
+  v[2] = mrbc_fixnum_value(0);
+  c_array_each_index_next( vm, v, 0 );
+}
+
+
+//================================================================
+/*! (method) each_with_index
+*/
+static void c_array_each_with_index_next(struct VM *vm, mrbc_value v[], int argc)
+{
+  int i = v[2].i;
+
+  if( i < mrbc_array_size(&v[0]) ) {
+    mrbc_value args[2];
+    args[0] = v[0].array->data[i];
+    args[1] = v[2];
+    v[2].i++;
+    mrbc_iterator_yield( vm, v, c_array_each_with_index_next, 2, args );
+    return;
+  }
+
+  mrbc_iterator_end( v );
+}
+
+static void c_array_each_with_index(struct VM *vm, mrbc_value v[], int argc)
+{
+  if( argc != 0 || mrbc_iterator_check_block( vm, v ) != 0 ) return;
+
+  mrbc_decref( &v[2] );
+  v[2] = mrbc_fixnum_value(0);
+  c_array_each_with_index_next( vm, v, 0 );
+}
+
+
+//================================================================
+/*! (method) collect, collect!
+
+  v[3] is the result array, or self in case of collect!.
+*/
+static void c_array_collect_next(struct VM *vm, mrbc_value v[], int argc)
+{
+  int i = v[2].i;
+
+  // store the return value of the block.
+  if( i > 0 ) {
+    mrbc_array_set( &v[3], i - 1, &v[MRBC_ITERATOR_REGS] );
+    v[MRBC_ITERATOR_REGS].tt = MRBC_TT_EMPTY;
+  }
+
+  if( i < mrbc_array_size(&v[0]) ) {
+    v[2].i++;
+    mrbc_iterator_yield( vm, v, c_array_collect_next, 1, &v[0].array->data[i] );
+    return;
+  }
+
+  mrbc_decref( &v[0] );
+  v[0] = v[3];
+  v[3].tt = MRBC_TT_EMPTY;
+  mrbc_iterator_end( v );
+}
+
+static void c_array_collect(struct VM *vm, mrbc_value v[], int argc)
+{
+  if( argc != 0 || mrbc_iterator_check_block( vm, v ) != 0 ) return;
+
+  mrbc_value ret = mrbc_array_new( vm, mrbc_array_size(&v[0]) );
+  if( ret.array == NULL ) return;		// ENOMEM
+
+  mrbc_decref( &v[2] );
+  v[2] = mrbc_fixnum_value(0);
+  mrbc_decref( &v[3] );
+  v[3] = ret;
+  c_array_collect_next( vm, v, 0 );
+}
+
+static void c_array_collect_self(struct VM *vm, mrbc_value v[], int argc)
+{
+  if( argc != 0 || mrbc_iterator_check_block( vm, v ) != 0 ) return;
+
+  mrbc_decref( &v[2] );
+  v[2] = mrbc_fixnum_value(0);
+  mrbc_decref( &v[3] );
+  v[3] = v[0];
+  mrbc_incref( &v[3] );
+  c_array_collect_next( vm, v, 0 );
+}
+
+
 #if MRBC_USE_STRING
 //================================================================
 /*! (method) inspect
@@ -994,6 +1560,15 @@ static void c_array_join(struct VM *vm, mrbc_value v[], int argc)
   METHOD( "min",	c_array_min )
   METHOD( "max",	c_array_max )
   METHOD( "minmax",	c_array_minmax )
+  METHOD( "sort!",	c_array_sort_self )
+  METHOD( "sort",	c_array_sort )
+  METHOD( "each",	c_array_each )
+  METHOD( "each_index",	c_array_each_index )
+  METHOD( "each_with_index", c_array_each_with_index )
+  METHOD( "collect",	c_array_collect )
+  METHOD( "map",	c_array_collect )
+  METHOD( "collect!",	c_array_collect_self )
+  METHOD( "map!",	c_array_collect_self )
 #if MRBC_USE_STRING
   METHOD( "inspect",	c_array_inspect )
   METHOD( "to_s",	c_array_inspect )
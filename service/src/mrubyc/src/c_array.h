@@ -28,12 +28,18 @@ extern "C" {
 typedef struct RArray {
   MRBC_OBJECT_HEADER;
 
-  uint16_t data_size;	//!< data buffer size.
+  uint16_t data_size;	//!< data buffer size. (from data[0])
   uint16_t n_stored;	//!< # of stored.
-  mrbc_value *data;	//!< pointer to allocated memory.
+  mrbc_value *data;	//!< pointer to the first element in the buffer.
+  uint16_t head;	//!< # of unused cells before data[0].
 
 } mrbc_array;
 
+// small array is stored just after the handle.
+#define ARRAY_INLINE_DATA(h)	((mrbc_value *)((mrbc_array *)(h) + 1))
+// top of the allocated memory, or inline buffer.
+#define ARRAY_BUFFER(h)		((h)->data - (h)->head)
+
 
 mrbc_value mrbc_array_new(struct VM *vm, int size);
 void mrbc_array_delete(mrbc_value *ary);
@@ -50,6 +56,7 @@ mrbc_value mrbc_array_remove(mrbc_value *ary, int idx);
 void mrbc_array_clear(mrbc_value *ary);
 int mrbc_array_compare(const mrbc_value *v1, const mrbc_value *v2);
 void mrbc_array_minmax(mrbc_value *ary, mrbc_value **pp_min_value, mrbc_value **pp_max_value);
+void mrbc_array_sort(mrbc_value *ary);
 mrbc_value mrbc_array_dup(struct VM *vm, const mrbc_value *ary);
 
 
@@ -69,7 +76,7 @@ static inline void mrbc_array_delete_handle(mrbc_value *ary)
 {
   mrbc_array *h = ary->array;
 
-  mrbc_raw_free(h->data);
+  if( ARRAY_BUFFER(h) != ARRAY_INLINE_DATA(h) ) mrbc_raw_free(ARRAY_BUFFER(h));
   mrbc_raw_free(h);
 }
 
@@ -41,7 +41,161 @@
     mrbc_hash_get	*K	T	Data remains in the container
     mrbc_hash_remove	*K	T	Data does not remain in the container
     mrbc_hash_i_next		*T	Data remains in the container
+
+ (search index)
+    A hash that has more than MRBC_HASH_INDEX_THRESHOLD pairs has
+    the index (open addressing table) to the pairs in data.
+    The data keeps insertion order, and a removed pair is left as
+    a tombstone (key and value are MRBC_TT_EMPTY) until compaction.
+
+    (note)
+    A key must not be modified after it is set to the hash.
+    Call mrbc_hash_rehash() if it is modified.
+*/
+
+// build the search index if the hash has more pairs than this.
+#if !defined(MRBC_HASH_INDEX_THRESHOLD)
+#define MRBC_HASH_INDEX_THRESHOLD 4
+#endif
+
+
+//================================================================
+/*! calculate hash value of the key.
+
+  @param  key	pointer to key value
+  @return	hash value.
+  @note	the values that mrbc_compare() treats as equal must have
+	the same hash value.
 */
+static uint32_t calc_hash(const mrbc_value *key)
+{
+  uint32_t h;
+
+  switch( mrbc_type(*key) ) {
+  case MRBC_TT_FIXNUM:
+  case MRBC_TT_SYMBOL:
+    h = key->i;
+    break;
+
+#if MRBC_USE_FLOAT
+  case MRBC_TT_FLOAT: {
+    // 2 ** (bit width of mrbc_int - 1)
+    const mrbc_float lim = (mrbc_float)((mrbc_int)1 << (sizeof(mrbc_int) * 8 - 2)) * 2;
+    if( -lim <= key->d && key->d < lim && key->d == (mrbc_int)key->d ) {
+      h = (mrbc_int)key->d;		// same as Fixnum.
+    } else {
+      uint32_t b[sizeof(mrbc_float) / sizeof(uint32_t)] = {0};
+      memcpy( b, &key->d, sizeof(mrbc_float) );
+      h = b[0] ^ b[sizeof(b) / sizeof(b[0]) - 1];
+    }
+  } break;
+#endif
+
+#if MRBC_USE_STRING
+  case MRBC_TT_STRING: {	// FNV-1a
+    const uint8_t *p = key->string->data;
+    int len = mrbc_string_size(key);
+    h = 2166136261U;
+    while( --len >= 0 ) {
+      h ^= *p++;
+      h *= 16777619U;
+    }
+  } return h;
+#endif
+
+  default:		// compare by contents or nil.
+    return 0;
+  }
+
+  // mix the bits.
+  h ^= h >> 16;
+  h *= 0x85ebca6bU;
+  h ^= h >> 13;
+  return h;
+}
+
+
+//================================================================
+/*! compare the keys.
+
+  @param  k1	pointer to stored key
+  @param  k2	pointer to key
+  @return	true if same key.
+*/
+static inline int key_equal(const mrbc_value *k1, const mrbc_value *k2)
+{
+  if( mrbc_type(*k1) == mrbc_type(*k2) &&
+      (mrbc_type(*k1) == MRBC_TT_FIXNUM || mrbc_type(*k1) == MRBC_TT_SYMBOL) ) {
+    return k1->i == k2->i;
+  }
+  return mrbc_compare(k1, k2) == 0;
+}
+
+
+//================================================================
+/*! register the pair to the index.
+
+  @param  h	pointer to hash handle.
+  @param  key	pointer to key value
+  @param  n	pair number.
+*/
+static void set_index(mrbc_hash *h, const mrbc_value *key, int n)
+{
+  int mask = h->index_size - 1;
+  int i = calc_hash(key) & mask;
+
+  while( h->index[i] != 0 ) {
+    i = (i + 1) & mask;
+  }
+  h->index[i] = n + 1;
+}
+
+
+//================================================================
+/*! remove tombstones and rebuild the index.
+
+  @param  h	pointer to hash handle.
+*/
+static void rebuild_index(mrbc_hash *h)
+{
+  // compaction.
+  if( h->n_deleted ) {
+    mrbc_value *p1 = h->data;
+    mrbc_value *p2 = h->data;
+    const mrbc_value *p_end = h->data + h->n_stored;
+    for( ; p1 < p_end; p1 += 2 ) {
+      if( p1->tt == MRBC_TT_EMPTY ) continue;
+      p2[0] = p1[0];
+      p2[1] = p1[1];
+      p2 += 2;
+    }
+    h->n_stored = p2 - h->data;
+    h->n_deleted = 0;
+  }
+
+  if( h->index ) mrbc_raw_free( h->index );
+  h->index = 0;
+  h->index_size = 0;
+
+  int n = h->n_stored / 2;
+  if( n <= MRBC_HASH_INDEX_THRESHOLD ) return;
+
+  // load factor is under 1/4 after rebuild, and 1/2 at the most.
+  int size = 8;
+  while( size < n * 4 ) size *= 2;
+  if( size > 0x8000 ) size = 0x8000;
+
+  h->index = mrbc_raw_alloc( sizeof(uint16_t) * size );
+  if( !h->index ) return;	// ENOMEM. search linearly.
+  mrbc_set_vm_id( h->index, mrbc_get_vm_id(h) );
+  memset( h->index, 0, sizeof(uint16_t) * size );
+  h->index_size = size;
+
+  int i;
+  for( i = 0; i < n; i++ ) {
+    set_index( h, &h->data[i * 2], i );
+  }
+}
 
 
 
@@ -72,6 +226,10 @@ mrbc_value mrbc_hash_new(struct VM *vm, int size)
   h->data_size = size * 2;
   h->n_stored = 0;
   h->data = data;
+  h->head = 0;
+  h->index = 0;
+  h->index_size = 0;
+  h->n_deleted = 0;
 
   value.hash = h;
   return value;
@@ -85,7 +243,7 @@ mrbc_value mrbc_hash_new(struct VM *vm, int size)
 */
 void mrbc_hash_delete(mrbc_value *hash)
 {
-  // TODO: delete other members (for search).
+  if( hash->hash->index ) mrbc_raw_free( hash->hash->index );
 
   mrbc_array_delete(hash);
 }
@@ -100,29 +258,28 @@ void mrbc_hash_delete(mrbc_value *hash)
 */
 mrbc_value * mrbc_hash_search(const mrbc_value *hash, const mrbc_value *key)
 {
-#ifndef MRBC_HASH_SEARCH_LINER
-#define MRBC_HASH_SEARCH_LINER
-#endif
+  mrbc_hash *h = hash->hash;
+
+  if( h->index ) {
+    int mask = h->index_size - 1;
+    int i = calc_hash(key) & mask;
+    int n;
+    while( (n = h->index[i]) != 0 ) {
+      mrbc_value *p = h->data + (n - 1) * 2;
+      if( p->tt != MRBC_TT_EMPTY && key_equal(p, key) ) return p;
+      i = (i + 1) & mask;
+    }
+    return NULL;
+  }
 
-#ifdef MRBC_HASH_SEARCH_LINER
-  mrbc_value *p1 = hash->hash->data;
-  const mrbc_value *p2 = p1 + hash->hash->n_stored;
+  mrbc_value *p1 = h->data;
+  const mrbc_value *p2 = p1 + h->n_stored;
 
   while( p1 < p2 ) {
-    if( mrbc_compare(p1, key) == 0 ) return p1;
+    if( p1->tt != MRBC_TT_EMPTY && key_equal(p1, key) ) return p1;
     p1 += 2;
   }
   return NULL;
-#endif
-
-#ifdef MRBC_HASH_SEARCH_LINER_ITERATOR
-  mrbc_hash_iterator ite = mrbc_hash_iterator_new(hash);
-  while( mrbc_hash_i_has_next(&ite) ) {
-    mrbc_value *v = mrbc_hash_i_next(&ite);
-    if( mrbc_compare( v, key ) == 0 ) return v;
-  }
-  return NULL;
-#endif
 }
 
 
@@ -141,7 +298,16 @@ int mrbc_hash_set(mrbc_value *hash, mrbc_value *key, mrbc_value *val)
   if( v == NULL ) {
     // set a new value
     if( (ret = mrbc_array_push(hash, key)) != 0 ) goto RETURN;
-    ret = mrbc_array_push(hash, val);
+    if( (ret = mrbc_array_push(hash, val)) != 0 ) goto RETURN;
+
+    // update the index.
+    mrbc_hash *h = hash->hash;
+    int n = h->n_stored / 2;
+    if( h->index && n * 2 <= h->index_size ) {
+      set_index( h, key, n - 1 );
+    } else if( n > MRBC_HASH_INDEX_THRESHOLD ) {
+      rebuild_index( h );
+    }
 
   } else {
     // replace a value
@@ -186,11 +352,17 @@ mrbc_value mrbc_hash_remove(mrbc_value *hash, mrbc_value *key)
   mrbc_value val = v[1];	// value
 
   mrbc_hash *h = hash->hash;
-  h->n_stored -= 2;
+  if( h->index ) {
+    // leave a tombstone, and compact if too many.
+    v[0].tt = MRBC_TT_EMPTY;
+    v[1].tt = MRBC_TT_EMPTY;
+    h->n_deleted++;
+    if( h->n_deleted * 2 > h->n_stored / 2 ) rebuild_index( h );
 
-  memmove(v, v+2, (char*)(h->data + h->n_stored) - (char*)v);
-
-  // TODO: re-index hash table if need.
+  } else {
+    h->n_stored -= 2;
+    memmove(v, v+2, (char*)(h->data + h->n_stored) - (char*)v);
+  }
 
   return val;
 }
@@ -205,7 +377,11 @@ void mrbc_hash_clear(mrbc_value *hash)
 {
   mrbc_array_clear(hash);
 
-  // TODO: re-index hash table if need.
+  mrbc_hash *h = hash->hash;
+  if( h->index ) mrbc_raw_free( h->index );
+  h->index = 0;
+  h->index_size = 0;
+  h->n_deleted = 0;
 }
 
 
@@ -219,11 +395,11 @@ void mrbc_hash_clear(mrbc_value *hash)
 */
 int mrbc_hash_compare(const mrbc_value *v1, const mrbc_value *v2)
 {
-  if( v1->hash->n_stored != v2->hash->n_stored ) return 1;
+  if( mrbc_hash_size(v1) != mrbc_hash_size(v2) ) return 1;
 
-  mrbc_value *d1 = v1->hash->data;
-  int i;
-  for( i = 0; i < mrbc_hash_size(v1); i++, d1++ ) {
+  mrbc_hash_iterator ite = mrbc_hash_iterator_new(v1);
+  while( mrbc_hash_i_has_next(&ite) ) {
+    mrbc_value *d1 = mrbc_hash_i_next(&ite);
     mrbc_value *d2 = mrbc_hash_search(v2, d1);	// check key
     if( d2 == NULL ) return 1;
     if( mrbc_compare( ++d1, ++d2 ) ) return 1;	// check data
@@ -241,10 +417,10 @@ int mrbc_hash_compare(const mrbc_value *v1, const mrbc_value *v2)
 */
 mrbc_value mrbc_hash_dup( struct VM *vm, mrbc_value *src )
 {
-  mrbc_value ret = mrbc_hash_new(vm, mrbc_hash_size(src));
+  mrbc_hash *h = src->hash;
+  mrbc_value ret = mrbc_hash_new(vm, h->n_stored / 2);
   if( ret.hash == NULL ) return ret;		// ENOMEM
 
-  mrbc_hash *h = src->hash;
   memcpy( ret.hash->data, h->data, sizeof(mrbc_value) * h->n_stored );
   ret.hash->n_stored = h->n_stored;
 
@@ -254,12 +430,37 @@ mrbc_value mrbc_hash_dup( struct VM *vm, mrbc_value *src )
     mrbc_incref(p1++);
   }
 
-  // TODO: dup other members.
+  ret.hash->n_deleted = h->n_deleted;
+  if( h->index || h->n_deleted ) rebuild_index( ret.hash );
 
   return ret;
 }
 
 
+//================================================================
+/*! rebuild the search index.
+
+  @param  hash	pointer to target hash.
+  @note	call this after setting the data directly, or modifying a key.
+*/
+void mrbc_hash_rehash(mrbc_value *hash)
+{
+  rebuild_index( hash->hash );
+}
+
+
+//================================================================
+/*! clear vm_id
+
+  @param  hash	pointer to target hash.
+*/
+void mrbc_hash_clear_vm_id(mrbc_value *hash)
+{
+  mrbc_array_clear_vm_id(hash);
+  if( hash->hash->index ) mrbc_set_vm_id( hash->hash->index, 0 );
+}
+
+
 
 
 //================================================================
@@ -333,8 +534,6 @@ static void c_hash_delete(struct VM *vm, mrbc_value v[], int argc)
 
   mrbc_value ret = mrbc_hash_remove(v, v+1);
 
-  // TODO: re-index hash table if need.
-
   SET_RETURN(ret);
 }
 
@@ -447,6 +646,37 @@ static void c_hash_size(struct VM *vm, mrbc_value v[], int argc)
 }
 
 
+//================================================================
+/*! (method) each
+*/
+static void c_hash_each_next(struct VM *vm, mrbc_value v[], int argc)
+{
+  const mrbc_hash *h = v[0].hash;
+  int n = h->n_stored / 2;
+  int i = v[2].i;
+
+  // skip deleted pairs.
+  while( i < n && h->data[i * 2].tt == MRBC_TT_EMPTY ) i++;
+
+  if( i < n ) {
+    v[2].i = i + 1;
+    mrbc_iterator_yield( vm, v, c_hash_each_next, 2, &h->data[i * 2] );
+    return;
+  }
+
+  mrbc_iterator_end( v );
+}
+
+static void c_hash_each(struct VM *vm, mrbc_value v[], int argc)
+{
+  if( argc != 0 || mrbc_iterator_check_block( vm, v ) != 0 ) return;
+
+  mrbc_decref( &v[2] );
+  v[2] = mrbc_fixnum_value(0);
+  c_hash_each_next( vm, v, 0 );
+}
+
+
 //================================================================
 /*! (method) merge
 */
@@ -559,6 +789,7 @@ static void c_hash_inspect(struct VM *vm, mrbc_value v[], int argc)
   METHOD( "size",	c_hash_size )
   METHOD( "length",	c_hash_size )
   METHOD( "count",	c_hash_size )
+  METHOD( "each",	c_hash_each )
   METHOD( "merge",	c_hash_merge )
   METHOD( "merge!",	c_hash_merge_self )
   METHOD( "to_h",	c_ineffect )
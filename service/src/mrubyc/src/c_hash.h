@@ -33,8 +33,11 @@ typedef struct RHash {
   uint16_t data_size;	//!< data buffer size.
   uint16_t n_stored;	//!< # of stored.
   mrbc_value *data;	//!< pointer to allocated memory.
+  uint16_t head;		//!< always 0. (see RArray)
 
-  // TODO: and other member for search.
+  uint16_t *index;	//!< search index. (open addressing, pair number + 1)
+  uint16_t index_size;	//!< size of index. (power of 2)
+  uint16_t n_deleted;	//!< # of deleted pairs (tombstones) in data.
 
 } mrbc_hash;
 
@@ -59,6 +62,8 @@ mrbc_value mrbc_hash_remove(mrbc_value *hash, mrbc_value *key);
 void mrbc_hash_clear(mrbc_value *hash);
 int mrbc_hash_compare(const mrbc_value *v1, const mrbc_value *v2);
 mrbc_value mrbc_hash_dup(struct VM *vm, mrbc_value *src);
+void mrbc_hash_rehash(mrbc_value *hash);
+void mrbc_hash_clear_vm_id(mrbc_value *hash);
 
 
 
@@ -66,14 +71,7 @@ mrbc_value mrbc_hash_dup(struct VM *vm, mrbc_value *src);
 /*! get size
 */
 static inline int mrbc_hash_size(const mrbc_value *hash) {
-  return hash->hash->n_stored / 2;
-}
-
-//================================================================
-/*! clear vm_id
-*/
-static inline void mrbc_hash_clear_vm_id(mrbc_value *hash) {
-  mrbc_array_clear_vm_id(hash);
+  return hash->hash->n_stored / 2 - hash->hash->n_deleted;
 }
 
 //================================================================
@@ -103,6 +101,10 @@ static inline mrbc_hash_iterator mrbc_hash_iterator_new( const mrbc_value *v )
 */
 static inline int mrbc_hash_i_has_next( mrbc_hash_iterator *ite )
 {
+  // skip deleted pairs.
+  while( ite->point < ite->p_end && ite->point->tt == MRBC_TT_EMPTY ) {
+    ite->point += 2;
+  }
   return ite->point < ite->p_end;
 }
 
@@ -22,6 +22,7 @@
 
 #include "value.h"
 #include "class.h"
+#include "vm.h"
 #include "console.h"
 #include "c_numeric.h"
 #include "c_string.h"
@@ -179,6 +180,31 @@ static void c_fixnum_abs(struct VM *vm, mrbc_value v[], int argc)
 }
 
 
+//================================================================
+/*! (method) times
+*/
+static void c_fixnum_times_next(struct VM *vm, mrbc_value v[], int argc)
+{
+  if( v[2].i < v[0].i ) {
+    mrbc_value i = v[2];
+    v[2].i++;
+    mrbc_iterator_yield( vm, v, c_fixnum_times_next, 1, &i );
+    return;
+  }
+
+  mrbc_iterator_end( v );
+}
+
+static void c_fixnum_times(struct VM *vm, mrbc_value v[], int argc)
+{
+  if( argc != 0 || mrbc_iterator_check_block( vm, v ) != 0 ) return;
+
+  mrbc_decref( &v[2] );
+  v[2] = mrbc_fixnum_value(0);
+  c_fixnum_times_next( vm, v, 0 );
+}
+
+
 #if MRBC_USE_FLOAT
 //================================================================
 /*! (method) to_f
@@ -197,9 +223,7 @@ static void c_fixnum_to_f(struct VM *vm, mrbc_value v[], int argc)
 */
 static void c_fixnum_chr(struct VM *vm, mrbc_value v[], int argc)
 {
-  char buf[2] = { GET_INT_ARG(0) };
-
-  mrbc_value value = mrbc_string_new(vm, buf, 1);
+  mrbc_value value = mrbc_string_char( GET_INT_ARG(0) );
   SET_RETURN(value);
 }
 
@@ -248,6 +272,7 @@ static void c_fixnum_to_s(struct VM *vm, mrbc_value v[], int argc)
   METHOD( "<<",		c_fixnum_lshift )
   METHOD( ">>",		c_fixnum_rshift )
   METHOD( "abs",	c_fixnum_abs )
+  METHOD( "times",	c_fixnum_times )
   METHOD( "to_i",	c_ineffect )
 #if MRBC_USE_FLOAT
   METHOD( "to_f",	c_fixnum_to_f )
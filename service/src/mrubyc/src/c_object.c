@@ -48,20 +48,22 @@ static void c_object_new(struct VM *vm, mrbc_value v[], int argc)
 {
   mrbc_value new_obj = mrbc_instance_new(vm, v->cls, 0);
 
-  char syms[]="______initialize";
-  mrbc_sym sym_id = str_to_symid(&syms[6]);
+  mrbc_sym sym_id = str_to_symid("initialize");
   mrbc_method method;
 
   if( mrbc_find_method( &method, v->cls, sym_id ) == 0 ) {
     SET_RETURN(new_obj);
     return;
   }
-  uint32_to_bin( 1,(uint8_t*)&syms[0]);
-  uint16_to_bin(10,(uint8_t*)&syms[4]);
 
-  uint8_t code[] = {
-    OP_SEND, 0, 0, argc,
-    OP_ABORT,
+  mrbc_inst code[] = {
+    { .op = OP_SEND, .a = 0, .bc = { .b = 0, .c = argc } },
+    { .op = OP_ABORT },
+  };
+  mrbc_method_cache method_cache = {
+    .cls = v->cls,
+    .epoch = mrbc_method_epoch,
+    .method = method,
   };
   mrbc_irep irep = {
 #if defined(MRBC_DEBUG)
@@ -70,12 +72,15 @@ static void c_object_new(struct VM *vm, mrbc_value v[], int argc)
     .nlocals = 0,
     .nregs = 0,
     .rlen = 0,
-    .ilen = sizeof(code)/sizeof(uint8_t),
+    .ilen = sizeof(code)/sizeof(mrbc_inst),
     .plen = 0,
-    .code = (uint8_t *)code,
+    .slen = 1,
+    .nsend = 1,
+    .code = code,
     .pools = NULL,
-    .ptr_to_sym = (uint8_t *)syms,
+    .syms = &sym_id,
     .reps = NULL,
+    .method_cache = &method_cache,
   };
 
   mrbc_class *cls = v->cls;
@@ -86,7 +91,7 @@ static void c_object_new(struct VM *vm, mrbc_value v[], int argc)
 
   mrbc_irep *org_pc_irep = vm->pc_irep;
   mrbc_value* org_regs = vm->current_regs;
-  uint8_t *org_inst = vm->inst;
+  mrbc_inst *org_inst = vm->inst;
 
   vm->pc_irep = &irep;
   vm->current_regs = v;
@@ -94,6 +99,8 @@ static void c_object_new(struct VM *vm, mrbc_value v[], int argc)
 
   while( mrbc_vm_run(vm) == 0 )
     ;
+  // stopped by error, stop the caller too.
+  if( vm->error_code ) vm->flag_preemption = 1;
 
   vm->pc_irep = org_pc_irep;
   vm->inst = org_inst;
@@ -171,7 +178,7 @@ static void c_object_dup(struct VM *vm, mrbc_value v[], int argc)
 {
   if( v->tt == MRBC_TT_OBJECT ) {
     mrbc_value new_obj = mrbc_instance_new(vm, v->instance->cls, 0);
-    mrbc_kv_dup( &v->instance->ivar, &new_obj.instance->ivar );
+    mrbc_instance_copy_ivar( &new_obj, v );
 
     mrbc_decref( v );
     *v = new_obj;
@@ -400,15 +407,16 @@ static void c_object_instance_variables(struct VM *vm, mrbc_value v[], int argc)
 {
   // temporary code for operation check.
 #if 1
-  mrbc_kv_handle *kvh = &v[0].instance->ivar;
+  const mrbc_instance *ins = v[0].instance;
+  int n = ins->shape ? ins->shape->num_ivar : 0;
 
-  console_printf( "n = %d/%d ", kvh->n_stored, kvh->data_size );
+  console_printf( "n = %d/%d ", n, ins->ivar_size );
   console_printf( "[" );
 
   int i;
-  for( i = 0; i < kvh->n_stored; i++ ) {
+  for( i = 0; i < n; i++ ) {
     console_printf( "%s:@%s", (i == 0 ? "" : ", "),
-		    symid_to_str( kvh->data[i].sym_id ));
+		    symid_to_str( mrbc_shape_slot_symid( ins->shape, i )));
   }
 
   console_printf( "]\n" );
@@ -423,14 +431,18 @@ static void c_object_instance_variables(struct VM *vm, mrbc_value v[], int argc)
 #if !defined(MRBC_ALLOC_LIBC)
 static void c_object_memory_statistics(struct VM *vm, mrbc_value v[], int argc)
 {
-  int total, used, free, frag;
-  mrbc_alloc_statistics(&total, &used, &free, &frag);
+  struct MRBC_ALLOC_STATISTICS mem;
+  mrbc_alloc_statistics(&mem);
 
   console_printf("Memory Statistics\n");
-  console_printf("  Total: %d\n", total);
-  console_printf("  Used : %d\n", used);
-  console_printf("  Free : %d\n", free);
-  console_printf("  Frag.: %d\n", frag);
+  console_printf("  Total: %d\n", mem.total);
+  console_printf("  Used : %d\n", mem.used);
+  console_printf("  Free : %d\n", mem.free);
+  console_printf("  Frag.: %d\n", mem.fragmentation);
+  console_printf("  Slab : %d/%d slots in %d pages\n",
+		 mem.slab_used, mem.slab_slots, mem.slab_pages);
+  console_printf("  Count: %d allocs, %d frees\n",
+		 mem.alloc_count, mem.free_count);
 
   SET_NIL_RETURN();
 }
@@ -524,12 +536,15 @@ static void c_object_sprintf(struct VM *vm, mrbc_value v[], int argc)
     return;
   }
 
+  const char *fstr = mrbc_string_cstr(format);
+  if( !fstr ) { return; }	// ENOMEM raise?
+
   int buflen = BUF_INC_STEP;
   char *buf = mrbc_alloc(vm, buflen);
   if( !buf ) { return; }	// ENOMEM raise?
 
   mrbc_printf pf;
-  mrbc_printf_init( &pf, buf, buflen, mrbc_string_cstr(format) );
+  mrbc_printf_init( &pf, buf, buflen, fstr );
 
   int i = 2;
   int ret;
@@ -547,13 +562,13 @@ static void c_object_sprintf(struct VM *vm, mrbc_value v[], int argc)
       if( v[i].tt == MRBC_TT_FIXNUM ) {
 	ret = mrbc_printf_char( &pf, v[i].i );
       } else if( v[i].tt == MRBC_TT_STRING ) {
-	ret = mrbc_printf_char( &pf, mrbc_string_cstr(&v[i])[0] );
+	ret = mrbc_printf_char( &pf, mrbc_string_size(&v[i]) ? v[i].string->data[0] : 0 );
       }
       break;
 
     case 's':
       if( v[i].tt == MRBC_TT_STRING ) {
-	ret = mrbc_printf_bstr( &pf, mrbc_string_cstr(&v[i]), mrbc_string_size(&v[i]),' ');
+	ret = mrbc_printf_bstr( &pf, (const char *)v[i].string->data, mrbc_string_size(&v[i]),' ');
       } else if( v[i].tt == MRBC_TT_SYMBOL ) {
 	ret = mrbc_printf_str( &pf, mrbc_symbol_cstr( &v[i] ), ' ');
       }
@@ -569,8 +584,9 @@ static void c_object_sprintf(struct VM *vm, mrbc_value v[], int argc)
 	ret = mrbc_printf_int( &pf, (mrbc_int)v[i].d, 10);
 #endif
       } else if( v[i].tt == MRBC_TT_STRING ) {
-	mrbc_int ival = atol(mrbc_string_cstr(&v[i]));
-	ret = mrbc_printf_int( &pf, ival, 10 );
+	const char *s = mrbc_string_cstr(&v[i]);
+	if( !s ) break;		// ENOMEM
+	ret = mrbc_printf_int( &pf, atol(s), 10 );
       }
       break;
 
@@ -643,7 +659,7 @@ static void c_object_sprintf(struct VM *vm, mrbc_value v[], int argc)
 static void c_object_printf(struct VM *vm, mrbc_value v[], int argc)
 {
   c_object_sprintf(vm, v, argc);
-  console_nprint( mrbc_string_cstr(v), mrbc_string_size(v) );
+  console_nprint( (const char *)v->string->data, mrbc_string_size(v) );
   SET_NIL_RETURN();
 }
 
@@ -15,9 +15,11 @@
 #include "value.h"
 #include "alloc.h"
 #include "class.h"
+#include "vm.h"
 #include "c_range.h"
 #include "c_string.h"
 #include "console.h"
+#include "error.h"
 #include "opcode.h"
 
 
@@ -151,6 +153,42 @@ static void c_range_exclude_end(struct VM *vm, mrbc_value v[], int argc)
 }
 
 
+//================================================================
+/*! (method) each
+
+  v[2] is the next value, v[3] is the end value (excluded).
+*/
+static void c_range_each_next(struct VM *vm, mrbc_value v[], int argc)
+{
+  if( v[2].i < v[3].i ) {
+    mrbc_value i = v[2];
+    v[2].i++;
+    mrbc_iterator_yield( vm, v, c_range_each_next, 1, &i );
+    return;
+  }
+
+  mrbc_iterator_end( v );
+}
+
+static void c_range_each(struct VM *vm, mrbc_value v[], int argc)
+{
+  if( argc != 0 || mrbc_iterator_check_block( vm, v ) != 0 ) return;
+
+  mrbc_range *h = v[0].range;
+  if( h->first.tt != MRBC_TT_FIXNUM || h->last.tt != MRBC_TT_FIXNUM ) {
+    mrbc_raise_exception( vm, mrbc_class_typeerror );	// can't iterate.
+    return;
+  }
+
+  mrbc_decref( &v[2] );
+  v[2] = h->first;
+  mrbc_decref( &v[3] );
+  v[3] = h->last;
+  if( !h->flag_exclude ) v[3].i++;
+  c_range_each_next( vm, v, 0 );
+}
+
+
 
 #if MRBC_USE_STRING
 //================================================================
@@ -189,6 +227,7 @@ static void c_range_inspect(struct VM *vm, mrbc_value v[], int argc)
   METHOD("first",	c_range_first )
   METHOD("last",	c_range_last )
   METHOD("exclude_end?", c_range_exclude_end )
+  METHOD("each",		c_range_each )
 #if MRBC_USE_STRING
   METHOD("inspect",	c_range_inspect )
   METHOD("to_s",	c_range_inspect )
@@ -25,9 +25,41 @@
 #include "c_array.h"
 #include "c_string.h"
 #include "console.h"
+#include "error.h"
 
 
 #if MRBC_USE_STRING
+/***** Constant values ******************************************************/
+// The buffer of growing string is allocated in multiples of this size.
+#define STRING_CAPACITY_ALIGN	8
+
+/***** Macros ***************************************************************/
+// short string is stored just after the handle.
+#define STRING_INLINE_DATA(h)	((uint8_t *)((mrbc_string *)(h) + 1))
+#define IS_INLINE_STRING(h)	(!(h)->base && (h)->data == STRING_INLINE_DATA(h))
+
+/*
+  Substring view.
+
+  A substring (split, slice, strip...) of a separated buffer shares
+  the buffer instead of copying bytes.  At the first time, the buffer
+  is moved to the hidden handle (base), and the source string also
+  becomes a view of it.  Views hold a reference to the base, and
+  the buffer is released with the last view.
+  A view is read only.  It takes its own buffer before modification.
+*/
+
+// one character strings, shared by all VMs and never released.
+#define IS_CHAR_STRING(h) ((void *)(h) >= (void *)string_char_table && \
+			   (void *)(h) < (void *)(string_char_table + 256))
+
+/***** Global variables *****************************************************/
+static struct {
+  mrbc_string h;
+  uint8_t data[2];	// inline buffer.
+} string_char_table[256];
+
+
 //================================================================
 /*! white space character test
 
@@ -46,6 +78,37 @@ static int is_space( int ch )
 }
 
 
+//================================================================
+/*! check modification of the shared one character string.
+
+  @param  h	pointer to string handle.
+  @return	0 if the string can be modified.
+*/
+static int is_frozen( const mrbc_string *h )
+{
+  return IS_CHAR_STRING(h);
+}
+
+
+//================================================================
+/*! raise RuntimeError, if the receiver can't be modified.
+
+  A shared one character string can't be copied on write, because
+  the other registers still hold the same handle.
+
+  @param  vm	pointer to VM.
+  @param  v	pointer to the receiver.
+  @return	0 if the string can be modified.
+*/
+static int check_frozen( struct VM *vm, mrbc_value *v )
+{
+  if( !is_frozen(v->string) ) return 0;
+
+  mrbc_raise_exception( vm, mrbc_class_runtimeerror );
+  return 1;
+}
+
+
 //================================================================
 /*! constructor
 
@@ -62,18 +125,32 @@ mrbc_value mrbc_string_new(struct VM *vm, const void *src, int len)
     Allocate handle and string buffer.
   */
   mrbc_string *h;
-  h = (mrbc_string *)mrbc_alloc(vm, sizeof(mrbc_string));
-  if( !h ) return value;		// ENOMEM
+  uint8_t *str;
+  int capacity = len;
+
+  if( len <= MRBC_STRING_INLINE_SIZE ) {
+    // short string. allocate at once.
+    capacity |= STRING_CAPACITY_ALIGN - 1;
+    h = (mrbc_string *)mrbc_alloc(vm, sizeof(mrbc_string) + capacity + 1);
+    if( !h ) return value;		// ENOMEM
+    str = STRING_INLINE_DATA(h);
+
+  } else {
+    h = (mrbc_string *)mrbc_alloc(vm, sizeof(mrbc_string));
+    if( !h ) return value;		// ENOMEM
 
-  uint8_t *str = mrbc_alloc(vm, len+1);
-  if( !str ) {				// ENOMEM
-    mrbc_raw_free( h );
-    return value;
+    str = mrbc_alloc(vm, len+1);
+    if( !str ) {			// ENOMEM
+      mrbc_raw_free( h );
+      return value;
+    }
   }
 
   MRBC_INIT_OBJECT_HEADER( h, "ST" );
   h->size = len;
+  h->capacity = capacity;
   h->data = str;
+  h->base = NULL;
 
   /*
     Copy a source string.
@@ -124,13 +201,44 @@ mrbc_value mrbc_string_new_alloc(struct VM *vm, void *buf, int len)
 
   MRBC_INIT_OBJECT_HEADER( h, "ST" );
   h->size = len;
+  h->capacity = len;
   h->data = buf;
+  h->base = NULL;
 
   value.string = h;
   return value;
 }
 
 
+//================================================================
+/*! get the one character string.
+
+  The string is preallocated and shared, so it is not allocated.
+  It can't be modified.
+
+  @param  ch	character code (0..255)
+  @return	string object
+*/
+mrbc_value mrbc_string_char(int ch)
+{
+  mrbc_value value = {.tt = MRBC_TT_STRING};
+  mrbc_string *h = &string_char_table[ch & 0xff].h;
+
+  if( !h->data ) {
+    MRBC_INIT_OBJECT_HEADER( h, "ST" );	// the table holds a reference.
+    h->size = 1;
+    h->capacity = 1;
+    h->data = STRING_INLINE_DATA(h);
+    h->data[0] = ch;
+    h->data[1] = '\0';
+  }
+
+  h->ref_count++;
+  value.string = h;
+  return value;
+}
+
+
 //================================================================
 /*! destructor
 
@@ -138,8 +246,15 @@ mrbc_value mrbc_string_new_alloc(struct VM *vm, void *buf, int len)
 */
 void mrbc_string_delete(mrbc_value *str)
 {
-  mrbc_raw_free(str->string->data);
-  mrbc_raw_free(str->string);
+  mrbc_string *h = str->string;
+
+  if( h->base ) {
+    mrbc_value base = {.tt = MRBC_TT_STRING, .string = h->base};
+    mrbc_decref( &base );
+  } else if( !IS_INLINE_STRING(h) ) {
+    mrbc_raw_free(h->data);
+  }
+  mrbc_raw_free(h);
 }
 
 
@@ -149,9 +264,11 @@ void mrbc_string_delete(mrbc_value *str)
 */
 void mrbc_string_clear(mrbc_value *str)
 {
-  mrbc_raw_realloc(str->string->data, 1);
-  str->string->data[0] = '\0';
+  if( is_frozen(str->string) ) return;
   str->string->size = 0;
+  if( mrbc_string_unshare(str) != 0 ) return;	// ENOMEM
+  str->string->data[0] = '\0';
+  mrbc_string_trim(str);
 }
 
 
@@ -160,8 +277,16 @@ void mrbc_string_clear(mrbc_value *str)
 */
 void mrbc_string_clear_vm_id(mrbc_value *str)
 {
-  mrbc_set_vm_id( str->string, 0 );
-  mrbc_set_vm_id( str->string->data, 0 );
+  mrbc_string *h = str->string;
+  if( IS_CHAR_STRING(h) ) return;
+
+  mrbc_set_vm_id( h, 0 );
+  if( h->base ) {
+    mrbc_value base = {.tt = MRBC_TT_STRING, .string = h->base};
+    mrbc_string_clear_vm_id( &base );
+  } else if( !IS_INLINE_STRING(h) ) {
+    mrbc_set_vm_id( h->data, 0 );
+  }
 }
 
 
@@ -170,17 +295,62 @@ void mrbc_string_clear_vm_id(mrbc_value *str)
 
   @param  vm	pointer to VM.
   @param  s1	pointer to target value
-  @return	new string as s1 + s2
+  @return	new string
 */
 mrbc_value mrbc_string_dup(struct VM *vm, mrbc_value *s1)
 {
-  mrbc_string *h1 = s1->string;
+  return mrbc_string_substr(vm, s1, 0, s1->string->size);
+}
 
-  mrbc_value value = mrbc_string_new(vm, NULL, h1->size);
-  if( value.string == NULL ) return value;		// ENOMEM
 
-  memcpy( value.string->data, h1->data, h1->size + 1 );
+//================================================================
+/*! substring
+
+  The result shares the buffer of src, unless src is a short string.
 
+  @param  vm	pointer to VM.
+  @param  src	pointer to source string
+  @param  pos	start position (0 <= pos <= size)
+  @param  len	length (0 <= len <= size - pos)
+  @return	new string
+*/
+mrbc_value mrbc_string_substr(struct VM *vm, mrbc_value *src, int pos, int len)
+{
+  mrbc_string *h = src->string;
+  if( len == 0 || IS_INLINE_STRING(h) ) {
+    return mrbc_string_new(vm, h->data + pos, len);
+  }
+
+  mrbc_value value = {.tt = MRBC_TT_STRING};
+  mrbc_string *view = (mrbc_string *)mrbc_alloc(vm, sizeof(mrbc_string));
+  if( !view ) return value;		// ENOMEM
+
+  // move the buffer of src to the hidden base handle.
+  if( !h->base ) {
+    mrbc_string *base = (mrbc_string *)mrbc_alloc(vm, sizeof(mrbc_string));
+    if( !base ) {			// ENOMEM
+      mrbc_raw_free( view );
+      return value;
+    }
+    MRBC_INIT_OBJECT_HEADER( base, "ST" );
+    base->size = h->size;
+    base->capacity = h->capacity;
+    base->data = h->data;
+    base->base = NULL;
+    mrbc_set_vm_id( base, mrbc_get_vm_id(h) );
+
+    h->capacity = 0;
+    h->base = base;
+  }
+
+  MRBC_INIT_OBJECT_HEADER( view, "ST" );
+  view->size = len;
+  view->capacity = 0;
+  view->data = h->data + pos;
+  view->base = h->base;
+  view->base->ref_count++;
+
+  value.string = view;
   return value;
 }
 
@@ -202,7 +372,8 @@ mrbc_value mrbc_string_add(struct VM *vm, const mrbc_value *s1, const mrbc_value
   if( value.string == NULL ) return value;		// ENOMEM
 
   memcpy( value.string->data,            h1->data, h1->size );
-  memcpy( value.string->data + h1->size, h2->data, h2->size + 1 );
+  memcpy( value.string->data + h1->size, h2->data, h2->size );
+  value.string->data[h1->size + h2->size] = '\0';
 
   return value;
 }
@@ -220,18 +391,18 @@ int mrbc_string_append(mrbc_value *s1, const mrbc_value *s2)
   int len1 = s1->string->size;
   int len2 = (s2->tt == MRBC_TT_STRING) ? s2->string->size : 1;
 
-  uint8_t *str = mrbc_raw_realloc(s1->string->data, len1+len2+1);
-  if( !str ) return E_NOMEMORY_ERROR;
+  int ret = mrbc_string_reserve(s1, len1 + len2);
+  if( ret != 0 ) return ret;
+  uint8_t *str = s1->string->data;
 
   if( s2->tt == MRBC_TT_STRING ) {
-    memcpy(str + len1, s2->string->data, len2 + 1);
+    memcpy(str + len1, s2->string->data, len2);
   } else if( s2->tt == MRBC_TT_FIXNUM ) {
     str[len1] = s2->i;
-    str[len1+1] = '\0';
   }
+  str[len1 + len2] = '\0';
 
   s1->string->size = len1 + len2;
-  s1->string->data = str;
 
   return 0;
 }
@@ -249,18 +420,117 @@ int mrbc_string_append_cstr(mrbc_value *s1, const char *s2)
   int len1 = s1->string->size;
   int len2 = strlen(s2);
 
-  uint8_t *str = mrbc_raw_realloc(s1->string->data, len1+len2+1);
-  if( !str ) return E_NOMEMORY_ERROR;
-
-  memcpy(str + len1, s2, len2 + 1);
+  int ret = mrbc_string_reserve(s1, len1 + len2);
+  if( ret != 0 ) return ret;
 
+  memcpy(s1->string->data + len1, s2, len2 + 1);
   s1->string->size = len1 + len2;
-  s1->string->data = str;
 
   return 0;
 }
 
 
+//================================================================
+/*! reserve the buffer for string length
+
+  The capacity grows geometrically (x1.5), so that appending
+  a character at a time takes amortized constant time.
+
+  @param  str	pointer to target value
+  @param  len	required string length.
+  @return	mrbc_error_code
+  @retval E_RUNTIME_ERROR	shared one character string can't be modified.
+*/
+int mrbc_string_reserve(mrbc_value *str, int len)
+{
+  mrbc_string *h = str->string;
+  if( is_frozen(h) ) return E_RUNTIME_ERROR;
+  if( len <= h->capacity && !h->base ) return 0;
+
+  unsigned int capacity = h->capacity + (h->capacity >> 1);
+  if( capacity < len ) capacity = len;
+  capacity |= STRING_CAPACITY_ALIGN - 1;	// (capacity + 1) is aligned.
+  if( capacity > UINT16_MAX ) capacity = UINT16_MAX;
+  if( capacity < len ) return E_NOMEMORY_ERROR;
+
+  uint8_t *data;
+  if( h->base ) {
+    mrbc_string *base = h->base;
+    if( base->ref_count == 1 ) {
+      // the last view. take over the buffer.
+      data = base->data;
+      memmove( data, h->data, h->size );
+      if( capacity > base->capacity ) {
+	uint8_t *p = mrbc_raw_realloc(data, capacity + 1);
+	if( !p ) return E_NOMEMORY_ERROR;
+	data = p;
+      } else {
+	capacity = base->capacity;
+      }
+      mrbc_raw_free( base );
+    } else {
+      data = mrbc_raw_alloc(capacity + 1);
+      if( !data ) return E_NOMEMORY_ERROR;
+      memcpy( data, h->data, h->size );
+      mrbc_set_vm_id( data, mrbc_get_vm_id(h) );
+      base->ref_count--;
+    }
+    data[h->size] = '\0';
+    h->base = NULL;
+
+  } else if( IS_INLINE_STRING(h) ) {
+    // move to the separated buffer.
+    data = mrbc_raw_alloc(capacity + 1);
+    if( !data ) return E_NOMEMORY_ERROR;
+    memcpy( data, h->data, h->size + 1 );
+    mrbc_set_vm_id( data, mrbc_get_vm_id(h) );
+  } else {
+    data = mrbc_raw_realloc(h->data, capacity + 1);
+    if( !data ) return E_NOMEMORY_ERROR;
+  }
+
+  h->data = data;
+  h->capacity = capacity;
+
+  return 0;
+}
+
+
+//================================================================
+/*! take own buffer, if the string is a view.
+
+  @param  str	pointer to target value
+  @return	mrbc_error_code
+*/
+int mrbc_string_unshare(mrbc_value *str)
+{
+  if( is_frozen(str->string) ) return E_RUNTIME_ERROR;
+  if( !str->string->base ) return 0;
+
+  return mrbc_string_reserve(str, str->string->size);
+}
+
+
+//================================================================
+/*! release the unused capacity.
+
+  Call it when the string will be kept long-term.
+  A view is copied, so as not to keep the whole source buffer.
+
+  @param  str	pointer to target value
+*/
+void mrbc_string_trim(mrbc_value *str)
+{
+  mrbc_string *h = str->string;
+  if( mrbc_string_unshare(str) != 0 ) return;	// ENOMEM
+  if( h->capacity == h->size ) return;
+  if( IS_INLINE_STRING(h) ) return;
+
+  h->data = mrbc_raw_realloc(h->data, h->size + 1);	// shrink.
+  h->capacity = h->size;
+}
+
+
 //================================================================
 /*! locate a substring in a string
 
@@ -271,13 +541,13 @@ int mrbc_string_append_cstr(mrbc_value *s1, const char *s2)
 */
 int mrbc_string_index(const mrbc_value *src, const mrbc_value *pattern, int offset)
 {
-  char *p1 = mrbc_string_cstr(src) + offset;
-  char *p2 = mrbc_string_cstr(pattern);
+  const uint8_t *p1 = src->string->data + offset;
+  const uint8_t *p2 = pattern->string->data;
   int try_cnt = mrbc_string_size(src) - mrbc_string_size(pattern) - offset;
 
   while( try_cnt >= 0 ) {
     if( memcmp( p1, p2, mrbc_string_size(pattern) ) == 0 ) {
-      return p1 - mrbc_string_cstr(src);	// matched.
+      return p1 - src->string->data;	// matched.
     }
     try_cnt--;
     p1++;
@@ -296,8 +566,8 @@ int mrbc_string_index(const mrbc_value *src, const mrbc_value *pattern, int offs
 */
 int mrbc_string_strip(mrbc_value *src, int mode)
 {
-  char *p1 = mrbc_string_cstr(src);
-  char *p2 = p1 + mrbc_string_size(src) - 1;
+  uint8_t *p1 = src->string->data;
+  uint8_t *p2 = p1 + mrbc_string_size(src) - 1;
 
   // left-side
   if( mode & 0x01 ) {
@@ -317,12 +587,20 @@ int mrbc_string_strip(mrbc_value *src, int mode)
 
   int new_size = p2 - p1 + 1;
   if( mrbc_string_size(src) == new_size ) return 0;
+  if( is_frozen(src->string) ) return 0;
 
-  char *buf = mrbc_string_cstr(src);
+  // view only narrows the range.
+  if( src->string->base ) {
+    src->string->data = p1;
+    src->string->size = new_size;
+    return 1;
+  }
+
+  uint8_t *buf = src->string->data;
   if( p1 != buf ) memmove( buf, p1, new_size );
   buf[new_size] = '\0';
-  mrbc_raw_realloc(buf, new_size+1);	// shrink suitable size.
   src->string->size = new_size;
+  mrbc_string_trim(src);	// shrink suitable size.
 
   return 1;
 }
@@ -336,8 +614,8 @@ int mrbc_string_strip(mrbc_value *src, int mode)
 */
 int mrbc_string_chomp(mrbc_value *src)
 {
-  char *p1 = mrbc_string_cstr(src);
-  char *p2 = p1 + mrbc_string_size(src) - 1;
+  uint8_t *p1 = src->string->data;
+  uint8_t *p2 = p1 + mrbc_string_size(src) - 1;
 
   if( *p2 == '\n' ) {
     p2--;
@@ -348,9 +626,9 @@ int mrbc_string_chomp(mrbc_value *src)
 
   int new_size = p2 - p1 + 1;
   if( mrbc_string_size(src) == new_size ) return 0;
+  if( is_frozen(src->string) ) return 0;
 
-  char *buf = mrbc_string_cstr(src);
-  buf[new_size] = '\0';
+  if( !src->string->base ) p1[new_size] = '\0';	// view is read only.
   src->string->size = new_size;
 
   return 1;
@@ -419,7 +697,7 @@ static void c_string_mul(struct VM *vm, mrbc_value v[], int argc)
   uint8_t *p = value.string->data;
   int i;
   for( i = 0; i < v[1].i; i++ ) {
-    memcpy( p, mrbc_string_cstr(&v[0]), mrbc_string_size(&v[0]) );
+    memcpy( p, v[0].string->data, mrbc_string_size(&v[0]) );
     p += mrbc_string_size(&v[0]);
   }
   *p = 0;
@@ -454,7 +732,19 @@ static void c_string_to_i(struct VM *vm, mrbc_value v[], int argc)
     }
   }
 
-  mrbc_int i = mrbc_atoi( mrbc_string_cstr(v), base );
+  // a view (e.g. token of split) is parsed on a copy, not to unshare it.
+  const char *s;
+  char buf[40];
+  if( v->string->base && mrbc_string_size(v) < sizeof(buf) ) {
+    memcpy( buf, v->string->data, mrbc_string_size(v) );
+    buf[mrbc_string_size(v)] = '\0';
+    s = buf;
+  } else {
+    s = mrbc_string_cstr(v);
+    if( !s ) return;		// ENOMEM
+  }
+
+  mrbc_int i = mrbc_atoi( s, base );
 
   SET_INT_RETURN( i );
 }
@@ -466,7 +756,10 @@ static void c_string_to_i(struct VM *vm, mrbc_value v[], int argc)
 */
 static void c_string_to_f(struct VM *vm, mrbc_value v[], int argc)
 {
-  mrbc_float d = atof(mrbc_string_cstr(v));
+  const char *s = mrbc_string_cstr(v);
+  if( !s ) return;		// ENOMEM
+
+  mrbc_float d = atof(s);
 
   SET_FLOAT_RETURN( d );
 }
@@ -478,6 +771,7 @@ static void c_string_to_f(struct VM *vm, mrbc_value v[], int argc)
 */
 static void c_string_append(struct VM *vm, mrbc_value v[], int argc)
 {
+  if( check_frozen( vm, &v[0] ) ) return;
   if( !mrbc_string_append( &v[0], &v[1] ) ) {
     // raise ? ENOMEM
   }
@@ -514,7 +808,12 @@ static void c_string_slice(struct VM *vm, mrbc_value v[], int argc)
   if( len < 0 ) goto RETURN_NIL;
   if( argc == 1 && len <= 0 ) goto RETURN_NIL;
 
-  mrbc_value ret = mrbc_string_new(vm, mrbc_string_cstr(v) + pos, len);
+  mrbc_value ret;
+  if( argc == 1 ) {
+    ret = mrbc_string_char( v->string->data[pos] );
+  } else {
+    ret = mrbc_string_substr(vm, v, pos, len);
+  }
   if( !ret.string ) goto RETURN_NIL;		// ENOMEM
 
   SET_RETURN(ret);
@@ -530,6 +829,7 @@ static void c_string_slice(struct VM *vm, mrbc_value v[], int argc)
 */
 static void c_string_insert(struct VM *vm, mrbc_value v[], int argc)
 {
+  if( check_frozen( vm, &v[0] ) ) return;
   int nth;
   int len;
   const mrbc_value *val;
@@ -572,14 +872,12 @@ static void c_string_insert(struct VM *vm, mrbc_value v[], int argc)
     return;
   }
 
-  uint8_t *str = mrbc_realloc(vm, mrbc_string_cstr(v), len1 + len2 - len + 1);
-  if( !str ) return;
+  if( mrbc_string_reserve(v, len1 + len2 - len) != 0 ) return;
+  uint8_t *str = v->string->data;
 
   memmove( str + nth + len2, str + nth + len, len1 - nth - len + 1 );
-  memcpy( str + nth, mrbc_string_cstr(val), len2 );
+  memcpy( str + nth, val->string->data, len2 );
   v->string->size = len1 + len2 - len;
-
-  v->string->data = str;
 }
 
 
@@ -601,6 +899,7 @@ static void c_string_chomp(struct VM *vm, mrbc_value v[], int argc)
 */
 static void c_string_clear(struct VM *vm, mrbc_value v[], int argc)
 {
+  if( check_frozen( vm, &v[0] ) ) return;
   mrbc_string_clear(&v[0]);
 }
 
@@ -610,6 +909,7 @@ static void c_string_clear(struct VM *vm, mrbc_value v[], int argc)
 */
 static void c_string_chomp_self(struct VM *vm, mrbc_value v[], int argc)
 {
+  if( check_frozen( vm, &v[0] ) ) return;
   if( mrbc_string_chomp(&v[0]) == 0 ) {
     SET_RETURN( mrbc_nil_value() );
   }
@@ -636,6 +936,61 @@ static void c_string_empty(struct VM *vm, mrbc_value v[], int argc)
 }
 
 
+//================================================================
+/*! (method) each_byte
+*/
+static void c_string_each_byte_next(struct VM *vm, mrbc_value v[], int argc)
+{
+  int i = v[2].i;
+
+  if( i < mrbc_string_size(&v[0]) ) {
+    mrbc_value ch = mrbc_fixnum_value( v[0].string->data[i] );
+    v[2].i++;
+    mrbc_iterator_yield( vm, v, c_string_each_byte_next, 1, &ch );
+    return;
+  }
+
+  mrbc_iterator_end( v );
+}
+
+static void c_string_each_byte(struct VM *vm, mrbc_value v[], int argc)
+{
+  if( argc != 0 || mrbc_iterator_check_block( vm, v ) != 0 ) return;
+
+  mrbc_decref( &v[2] );
+  v[2] = mrbc_fixnum_value(0);
+  c_string_each_byte_next( vm, v, 0 );
+}
+
+
+//================================================================
+/*! (method) each_char
+*/
+static void c_string_each_char_next(struct VM *vm, mrbc_value v[], int argc)
+{
+  int i = v[2].i;
+
+  if( i < mrbc_string_size(&v[0]) ) {
+    mrbc_value ch = mrbc_string_char( v[0].string->data[i] );
+    v[2].i++;
+    mrbc_iterator_yield( vm, v, c_string_each_char_next, 1, &ch );
+    mrbc_decref( &ch );
+    return;
+  }
+
+  mrbc_iterator_end( v );
+}
+
+static void c_string_each_char(struct VM *vm, mrbc_value v[], int argc)
+{
+  if( argc != 0 || mrbc_iterator_check_block( vm, v ) != 0 ) return;
+
+  mrbc_decref( &v[2] );
+  v[2] = mrbc_fixnum_value(0);
+  c_string_each_char_next( vm, v, 0 );
+}
+
+
 //================================================================
 /*! (method) getbyte
 */
@@ -650,7 +1005,7 @@ static void c_string_getbyte(struct VM *vm, mrbc_value v[], int argc)
     idx += len;
   }
   if( idx >= 0 ) {
-    SET_INT_RETURN( ((uint8_t *)mrbc_string_cstr(&v[0]))[idx] );
+    SET_INT_RETURN( v[0].string->data[idx] );
   } else {
     SET_NIL_RETURN();
   }
@@ -695,7 +1050,7 @@ static void c_string_inspect(struct VM *vm, mrbc_value v[], int argc)
 {
   char buf[10] = "\\x";
   mrbc_value ret = mrbc_string_new_cstr(vm, "\"");
-  const unsigned char *s = (const unsigned char *)mrbc_string_cstr(v);
+  const unsigned char *s = v->string->data;
   int i;
   for( i = 0; i < mrbc_string_size(v); i++ ) {
     if( s[i] < ' ' || 0x7f <= s[i] ) {	// tiny isprint()
@@ -718,7 +1073,7 @@ static void c_string_inspect(struct VM *vm, mrbc_value v[], int argc)
 */
 static void c_string_ord(struct VM *vm, mrbc_value v[], int argc)
 {
-  int i = ((uint8_t *)mrbc_string_cstr(v))[0];
+  int i = mrbc_string_size(v) ? v->string->data[0] : 0;
 
   SET_INT_RETURN( i );
 }
@@ -729,6 +1084,7 @@ static void c_string_ord(struct VM *vm, mrbc_value v[], int argc)
 */
 static void c_string_slice_self(struct VM *vm, mrbc_value v[], int argc)
 {
+  if( check_frozen( vm, &v[0] ) ) return;
   int target_len = mrbc_string_size(v);
   int pos = mrbc_fixnum(v[1]);
   int len;
@@ -754,14 +1110,18 @@ static void c_string_slice_self(struct VM *vm, mrbc_value v[], int argc)
   if( len < 0 ) goto RETURN_NIL;
   if( argc == 1 && len <= 0 ) goto RETURN_NIL;
 
-  mrbc_value ret = mrbc_string_new(vm, mrbc_string_cstr(v) + pos, len);
+  mrbc_value ret = mrbc_string_new(vm, v->string->data + pos, len);
   if( !ret.string ) goto RETURN_NIL;		// ENOMEM
 
   if( len > 0 ) {
-    memmove( mrbc_string_cstr(v) + pos, mrbc_string_cstr(v) + pos + len,
+    if( mrbc_string_unshare(v) != 0 ) {		// ENOMEM
+      mrbc_decref( &ret );
+      goto RETURN_NIL;
+    }
+    memmove( v->string->data + pos, v->string->data + pos + len,
 	     mrbc_string_size(v) - pos - len + 1 );
     v->string->size = mrbc_string_size(v) - len;
-    mrbc_raw_realloc( mrbc_string_cstr(v), mrbc_string_size(v)+1 );
+    mrbc_string_trim( v );
   }
 
   SET_RETURN(ret);
@@ -810,8 +1170,8 @@ static void c_string_split(struct VM *vm, mrbc_value v[], int argc)
     return;
   }
 
-  int flag_strip = (mrbc_string_cstr(&sep)[0] == ' ') &&
-		   (mrbc_string_size(&sep) == 1);
+  int flag_strip = (mrbc_string_size(&sep) == 1) &&
+		   (sep.string->data[0] == ' ');
   int offset = 0;
   int sep_len = mrbc_string_size(&sep);
   if( sep_len == 0 ) sep_len++;
@@ -821,7 +1181,7 @@ static void c_string_split(struct VM *vm, mrbc_value v[], int argc)
 
     if( flag_strip ) {
       for( ; offset < mrbc_string_size(&v[0]); offset++ ) {
-	if( !is_space( mrbc_string_cstr(&v[0])[offset] )) break;
+	if( !is_space( v[0].string->data[offset] )) break;
       }
       if( offset > mrbc_string_size(&v[0])) break;
     }
@@ -836,7 +1196,7 @@ static void c_string_split(struct VM *vm, mrbc_value v[], int argc)
     if( flag_strip ) {
       pos = offset;
       for( ; pos < mrbc_string_size(&v[0]); pos++ ) {
-	if( is_space( mrbc_string_cstr(&v[0])[pos] )) break;
+	if( is_space( v[0].string->data[pos] )) break;
       }
       len = pos - offset;
       goto SPLIT_ITEM;
@@ -857,7 +1217,7 @@ static void c_string_split(struct VM *vm, mrbc_value v[], int argc)
   SPLIT_ITEM:
     if( pos < 0 ) len = mrbc_string_size(&v[0]) - offset;
 
-    mrb_value v1 = mrbc_string_new(vm, mrbc_string_cstr(&v[0]) + offset, len);
+    mrb_value v1 = mrbc_string_substr(vm, &v[0], offset, len);
     mrbc_array_push( &ret, &v1 );
 
     if( pos < 0 ) break;
@@ -905,6 +1265,7 @@ static void c_string_lstrip(struct VM *vm, mrbc_value v[], int argc)
 */
 static void c_string_lstrip_self(struct VM *vm, mrbc_value v[], int argc)
 {
+  if( check_frozen( vm, &v[0] ) ) return;
   if( mrbc_string_strip(&v[0], 0x01) == 0 ) {	// 1: left side only
     SET_RETURN( mrbc_nil_value() );
   }
@@ -929,6 +1290,7 @@ static void c_string_rstrip(struct VM *vm, mrbc_value v[], int argc)
 */
 static void c_string_rstrip_self(struct VM *vm, mrbc_value v[], int argc)
 {
+  if( check_frozen( vm, &v[0] ) ) return;
   if( mrbc_string_strip(&v[0], 0x02) == 0 ) {	// 2: right side only
     SET_RETURN( mrbc_nil_value() );
   }
@@ -953,6 +1315,7 @@ static void c_string_strip(struct VM *vm, mrbc_value v[], int argc)
 */
 static void c_string_strip_self(struct VM *vm, mrbc_value v[], int argc)
 {
+  if( check_frozen( vm, &v[0] ) ) return;
   if( mrbc_string_strip(&v[0], 0x03) == 0 ) {	// 3: left and right
     SET_RETURN( mrbc_nil_value() );
   }
@@ -964,7 +1327,8 @@ static void c_string_strip_self(struct VM *vm, mrbc_value v[], int argc)
 */
 static void c_string_to_sym(struct VM *vm, mrbc_value v[], int argc)
 {
-  mrbc_value ret = mrbc_symbol_new(vm, mrbc_string_cstr(&v[0]));
+  mrbc_value ret = mrbc_symbol_new_len(vm, (const char *)v[0].string->data,
+					mrbc_string_size(&v[0]));
 
   SET_RETURN(ret);
 }
@@ -999,7 +1363,7 @@ static void tr_free_pattern( struct tr_pattern *pat )
 
 static struct tr_pattern * tr_parse_pattern( struct VM *vm, const mrb_value *v_pattern, int flag_reverse_enable )
 {
-  const char *pattern = mrbc_string_cstr( v_pattern );
+  const char *pattern = (const char *)v_pattern->string->data;
   int pattern_length = mrbc_string_size( v_pattern );
   int flag_reverse = 0;
   struct tr_pattern *ret = NULL;
@@ -1106,6 +1470,7 @@ static int tr_main( struct VM *vm, mrbc_value v[], int argc )
     console_print("ArgumentError\n");	// raise?
     return -1;
   }
+  if( mrbc_string_unshare( &v[0] ) != 0 ) return 0;	// ENOMEM
 
   struct tr_pattern *pat = tr_parse_pattern( vm, &v[1], 1 );
   if( pat == NULL ) return 0;
@@ -1113,7 +1478,7 @@ static int tr_main( struct VM *vm, mrbc_value v[], int argc )
   struct tr_pattern *rep = tr_parse_pattern( vm, &v[2], 0 );
 
   int flag_changed = 0;
-  char *s = mrbc_string_cstr( &v[0] );
+  char *s = (char *)v[0].string->data;
   int len = mrbc_string_size( &v[0] );
   int i;
   for( i = 0; i < len; i++ ) {
@@ -1152,6 +1517,7 @@ static void c_string_tr(struct VM *vm, mrbc_value v[], int argc)
 */
 static void c_string_tr_self(struct VM *vm, mrbc_value v[], int argc)
 {
+  if( check_frozen( vm, &v[0] ) ) return;
   int flag_changed = tr_main(vm, v, argc);
 
   if( !flag_changed ) {
@@ -1174,7 +1540,7 @@ static void c_string_start_with(struct VM *vm, mrbc_value v[], int argc)
   if( mrbc_string_size(&v[0]) < mrbc_string_size(&v[1]) ) {
     ret = 0;
   } else {
-    ret = (memcmp( mrbc_string_cstr(&v[0]), mrbc_string_cstr(&v[1]),
+    ret = (memcmp( v[0].string->data, v[1].string->data,
 		   mrbc_string_size(&v[1]) ) == 0);
   }
 
@@ -1197,7 +1563,7 @@ static void c_string_end_with(struct VM *vm, mrbc_value v[], int argc)
   if( offset < 0 ) {
     ret = 0;
   } else {
-    ret = (memcmp( mrbc_string_cstr(&v[0]) + offset, mrbc_string_cstr(&v[1]),
+    ret = (memcmp( v[0].string->data + offset, v[1].string->data,
 		   mrbc_string_size(&v[1]) ) == 0);
   }
 
@@ -1241,6 +1607,8 @@ static void c_string_include(struct VM *vm, mrbc_value v[], int argc)
   METHOD( "chomp",	c_string_chomp )
   METHOD( "chomp!",	c_string_chomp_self )
   METHOD( "dup",	c_string_dup )
+  METHOD( "each_byte",	c_string_each_byte )
+  METHOD( "each_char",	c_string_each_char )
   METHOD( "empty?",	c_string_empty )
   METHOD( "getbyte",	c_string_getbyte )
   METHOD( "index",	c_string_index )
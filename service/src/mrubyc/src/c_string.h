@@ -31,8 +31,12 @@ extern "C" {
 
 /***** Constant values ******************************************************/
 /***** Macros ***************************************************************/
+// A String may be a view into the buffer of another String, so its data
+// is NOT always terminated by '\0'. RSTRING_PTR must be used together
+// with RSTRING_LEN. Use mrbc_string_cstr() (or GET_STRING_ARG) when a
+// C string is needed; they may allocate, and return NULL if ENOMEM.
 #define RSTRING_LEN(str)	mrbc_string_size(&str)
-#define RSTRING_PTR(str)	mrbc_string_cstr(&str)
+#define RSTRING_PTR(str)	((char *)(str).string->data)	// use with RSTRING_LEN
 
 /***** Typedefs *************************************************************/
 //================================================================
@@ -43,7 +47,9 @@ typedef struct RString {
   MRBC_OBJECT_HEADER;
 
   uint16_t size;	//!< string length.
-  uint8_t *data;	//!< pointer to allocated buffer.
+  uint16_t capacity;	//!< max string length without realloc.
+  uint8_t *data;	//!< pointer to allocated buffer, or inline buffer.
+  struct RString *base;	//!< owner of the shared buffer, if this is a view.
 
 } mrbc_string;
 
@@ -53,13 +59,18 @@ typedef struct RString {
 mrbc_value mrbc_string_new(struct VM *vm, const void *src, int len);
 mrbc_value mrbc_string_new_cstr(struct VM *vm, const char *src);
 mrbc_value mrbc_string_new_alloc(struct VM *vm, void *buf, int len);
+mrbc_value mrbc_string_char(int ch);
 void mrbc_string_delete(mrbc_value *str);
 void mrbc_string_clear(mrbc_value *str);
 void mrbc_string_clear_vm_id(mrbc_value *str);
 mrbc_value mrbc_string_dup(struct VM *vm, mrbc_value *s1);
+mrbc_value mrbc_string_substr(struct VM *vm, mrbc_value *src, int pos, int len);
 mrbc_value mrbc_string_add(struct VM *vm, const mrbc_value *s1, const mrbc_value *s2);
 int mrbc_string_append(mrbc_value *s1, const mrbc_value *s2);
 int mrbc_string_append_cstr(mrbc_value *s1, const char *s2);
+int mrbc_string_reserve(mrbc_value *str, int len);
+int mrbc_string_unshare(mrbc_value *str);
+void mrbc_string_trim(mrbc_value *str);
 int mrbc_string_index(const mrbc_value *src, const mrbc_value *pattern, int offset);
 int mrbc_string_strip(mrbc_value *src, int mode);
 int mrbc_string_chomp(mrbc_value *src);
@@ -91,9 +102,19 @@ static inline int mrbc_string_size(const mrbc_value *str)
 
 //================================================================
 /*! get c-language string (char *)
+
+  A view is not always terminated by '\0'. In that case, it is
+  copied to its own buffer at this time, so this may allocate memory.
+  Use string->data and mrbc_string_size() if '\0' is not needed.
+
+  @param  v	pointer to target value.
+  @return	pointer to the string, or NULL if ENOMEM.
 */
-static inline char * mrbc_string_cstr(const mrbc_value *v)
+static inline char * mrbc_string_cstr(mrbc_value *v)
 {
+  if( v->string->base && v->string->data[v->string->size] != '\0' ) {
+    if( mrbc_string_unshare( v ) != 0 ) return NULL;
+  }
   return (char*)v->string->data;
 }
 
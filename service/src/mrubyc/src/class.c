@@ -31,6 +31,10 @@
 
 
 /***** Constant values ******************************************************/
+#if !defined(MRBC_IVAR_SIZE_INCREMENT)
+#define MRBC_IVAR_SIZE_INCREMENT 4
+#endif
+
 /***** Macros ***************************************************************/
 /***** Typedefs *************************************************************/
 /***** Function prototypes **************************************************/
@@ -47,6 +51,10 @@ mrbc_class *mrbc_class_zerodivisionerror;
 mrbc_class *mrbc_class_argumenterror;
 mrbc_class *mrbc_class_indexerror;
 mrbc_class *mrbc_class_typeerror;
+mrbc_class *mrbc_class_localjumperror;
+
+// Method definition epoch. Inline method caches are valid only while equal.
+uint32_t mrbc_method_epoch = 1;
 
 
 /***** Signal catching functions ********************************************/
@@ -77,6 +85,10 @@ mrbc_class * mrbc_define_class(struct VM *vm, const char *name, mrbc_class *supe
 #endif
     cls->super = (super == NULL) ? mrbc_class_object : super;
     cls->method_link = 0;
+    cls->method_table = 0;
+    cls->method_table_size = 0;
+    cls->num_method = 0;
+    cls->shape_link = 0;
 
     // register to global constant.
     mrbc_set_const( sym_id, &(mrb_value){.tt = MRBC_TT_CLASS, .cls = cls} );
@@ -94,9 +106,9 @@ mrbc_class * mrbc_define_class(struct VM *vm, const char *name, mrbc_class *supe
 
   @param  name		class name.
   @param  super		super class.
-  @param  method_symbols
-  @param  method_functions
-  @param  num_builtin_method
+  @param  method_symbols	sym-id table, indexed by sym_id % num_builtin_method.
+  @param  method_functions	function table, same order as method_symbols.
+  @param  num_builtin_method	size of the tables.
   @return		pointer to defined class.
 */
 mrbc_class * mrbc_define_builtin_class(const char *name, mrbc_class *super, const mrbc_sym *method_symbols, const mrbc_func_t *method_functions, int num_builtin_method)
@@ -112,6 +124,10 @@ mrbc_class * mrbc_define_builtin_class(const char *name, mrbc_class *super, cons
 #endif
   cls->super = super;
   cls->method_link = 0;
+  cls->method_table = 0;
+  cls->method_table_size = 0;
+  cls->num_method = 0;
+  cls->shape_link = 0;
   cls->method_symbols = method_symbols;
   cls->method_functions = method_functions;
 
@@ -140,8 +156,80 @@ void mrbc_define_method(struct VM *vm, mrbc_class *cls, const char *name, mrbc_f
   method->c_func = 1;
   method->sym_id = str_to_symid( name );
   method->func = cfunc;
+  mrbc_add_method( cls, method );
+}
+
+
+//================================================================
+/*! register the method to the hash index. (open addressing)
+
+  @param  cls		pointer to class.
+  @param  method	pointer to method.
+*/
+static void set_method_table(mrbc_class *cls, mrbc_method *method)
+{
+  int mask = cls->method_table_size - 1;
+  int i = method->sym_id & mask;
+
+  while( cls->method_table[i] != NULL &&
+	 cls->method_table[i]->sym_id != method->sym_id ) {
+    i = (i + 1) & mask;
+  }
+  cls->method_table[i] = method;
+}
+
+
+//================================================================
+/*! add the method to the class, replacing the same name one.
+
+  @param  cls		pointer to class.
+  @param  method	pointer to method. sym_id and body are already set.
+*/
+void mrbc_add_method(mrbc_class *cls, mrbc_method *method)
+{
   method->next = cls->method_link;
   cls->method_link = method;
+  mrbc_clear_method_cache();
+
+  // remove the same name method.
+  mrbc_method *m;
+  for( m = method; m->next != NULL; m = m->next ) {
+    if( m->next->sym_id == method->sym_id ) {
+      mrbc_method *del_method = m->next;
+      m->next = del_method->next;
+      /* (note)
+         Case c_func == 0 is defined by OP_DEF.
+         Case c_func == 1 is defined by mrbc_define_method() function.
+         That function uses mrbc_raw_alloc_no_free() to allocate memory.
+         Thus not free this memory.
+         Case c_func == 2 is builtin C function. maybe create by OP_ALIAS.
+      */
+      if( del_method->c_func != 1 ) mrbc_raw_free( del_method );
+      cls->num_method--;
+      break;
+    }
+  }
+  cls->num_method++;
+
+  // keep load factor of the hash index under 3/4.
+  if( cls->num_method * 4 <= cls->method_table_size * 3 ) {
+    set_method_table( cls, method );
+    return;
+  }
+
+  int size = cls->method_table_size ? cls->method_table_size * 2 : 8;
+  if( cls->method_table ) mrbc_raw_free( cls->method_table );
+  cls->method_table = mrbc_raw_alloc( sizeof(mrbc_method *) * size );
+  if( !cls->method_table ) {	// ENOMEM. use method_link only.
+    cls->method_table_size = 0;
+    return;
+  }
+  memset( cls->method_table, 0, sizeof(mrbc_method *) * size );
+  cls->method_table_size = size;
+
+  for( m = cls->method_link; m != NULL; m = m->next ) {
+    set_method_table( cls, m );
+  }
 }
 
 
@@ -159,14 +247,11 @@ mrbc_value mrbc_instance_new(struct VM *vm, mrbc_class *cls, int size)
   v.instance = (mrbc_instance *)mrbc_alloc(vm, sizeof(mrbc_instance) + size);
   if( v.instance == NULL ) return v;	// ENOMEM
 
-  if( mrbc_kv_init_handle(vm, &v.instance->ivar, 0) != 0 ) {
-    mrbc_raw_free(v.instance);
-    v.instance = NULL;
-    return v;
-  }
-
   MRBC_INIT_OBJECT_HEADER( v.instance, "IN" );
   v.instance->cls = cls;
+  v.instance->shape = 0;
+  v.instance->ivar = 0;
+  v.instance->ivar_size = 0;
 
   return v;
 }
@@ -179,8 +264,78 @@ mrbc_value mrbc_instance_new(struct VM *vm, mrbc_class *cls, int size)
 */
 void mrbc_instance_delete(mrbc_value *v)
 {
-  mrbc_kv_delete_data( &v->instance->ivar );
-  mrbc_raw_free( v->instance );
+  mrbc_instance *ins = v->instance;
+
+  if( ins->shape ) {
+    int i;
+    for( i = 0; i < ins->shape->num_ivar; i++ ) {
+      mrbc_decref( &ins->ivar[i] );
+    }
+  }
+  if( ins->ivar ) mrbc_raw_free( ins->ivar );
+  mrbc_raw_free( ins );
+}
+
+
+//================================================================
+/*! find the ivar slot in the shape.
+
+  @param  shape		pointer to shape or NULL.
+  @param  sym_id	ivar symbol ID.
+  @return		slot number or -1 if not found.
+*/
+int mrbc_shape_find_slot(const mrbc_shape *shape, mrbc_sym sym_id)
+{
+  for( ; shape != NULL; shape = shape->parent ) {
+    if( shape->sym_id == sym_id ) return shape->num_ivar - 1;
+  }
+  return -1;
+}
+
+
+//================================================================
+/*! get the ivar symbol ID of the slot.
+
+  @param  shape		pointer to shape.
+  @param  slot		slot number.
+  @return		symbol ID.
+*/
+mrbc_sym mrbc_shape_slot_symid(const mrbc_shape *shape, int slot)
+{
+  while( shape->num_ivar > slot + 1 ) {
+    shape = shape->parent;
+  }
+  return shape->sym_id;
+}
+
+
+//================================================================
+/*! get the shape that adds an ivar to the instance's shape.
+
+  @param  ins		pointer to instance.
+  @param  sym_id	ivar symbol ID.
+  @return		pointer to shape or NULL if ENOMEM.
+*/
+static mrbc_shape * shape_transition(mrbc_instance *ins, mrbc_sym sym_id)
+{
+  mrbc_shape **link = ins->shape ? &ins->shape->child : &ins->cls->shape_link;
+  mrbc_shape *shape;
+
+  for( shape = *link; shape != NULL; shape = shape->next ) {
+    if( shape->sym_id == sym_id ) return shape;
+  }
+
+  shape = mrbc_raw_alloc_no_free( sizeof(mrbc_shape) );
+  if( !shape ) return NULL;	// ENOMEM
+
+  shape->parent = ins->shape;
+  shape->child = NULL;
+  shape->next = *link;
+  shape->sym_id = sym_id;
+  shape->num_ivar = ins->shape ? ins->shape->num_ivar + 1 : 1;
+  *link = shape;
+
+  return shape;
 }
 
 
@@ -193,8 +348,36 @@ void mrbc_instance_delete(mrbc_value *v)
 */
 void mrbc_instance_setiv(mrbc_object *obj, mrbc_sym sym_id, mrbc_value *v)
 {
+  if( obj->tt != MRBC_TT_OBJECT ) return;
+
+  mrbc_instance *ins = obj->instance;
+  int slot = mrbc_shape_find_slot( ins->shape, sym_id );
+  if( slot >= 0 ) {
+    mrbc_incref(v);
+    mrbc_decref( &ins->ivar[slot] );
+    ins->ivar[slot] = *v;
+    return;
+  }
+
+  // add a new ivar.
+  mrbc_shape *shape = shape_transition( ins, sym_id );
+  if( !shape ) return;		// ENOMEM
+
+  slot = shape->num_ivar - 1;
+  if( slot >= ins->ivar_size ) {
+    int size = ins->ivar_size + MRBC_IVAR_SIZE_INCREMENT;
+    mrbc_value *ivar = ins->ivar ?
+      mrbc_raw_realloc( ins->ivar, sizeof(mrbc_value) * size ) :
+      mrbc_raw_alloc( sizeof(mrbc_value) * size );
+    if( !ivar ) return;		// ENOMEM
+    mrbc_set_vm_id( ivar, mrbc_get_vm_id(ins) );
+    ins->ivar = ivar;
+    ins->ivar_size = size;
+  }
+
   mrbc_incref(v);
-  mrbc_kv_set( &obj->instance->ivar, sym_id, v );
+  ins->ivar[slot] = *v;
+  ins->shape = shape;
 }
 
 
@@ -207,11 +390,44 @@ void mrbc_instance_setiv(mrbc_object *obj, mrbc_sym sym_id, mrbc_value *v)
 */
 mrbc_value mrbc_instance_getiv(mrbc_object *obj, mrbc_sym sym_id)
 {
-  mrbc_value *v = mrbc_kv_get( &obj->instance->ivar, sym_id );
-  if( !v ) return mrbc_nil_value();
+  if( obj->tt != MRBC_TT_OBJECT ) return mrbc_nil_value();
 
-  mrbc_incref(v);
-  return *v;
+  mrbc_instance *ins = obj->instance;
+  int slot = mrbc_shape_find_slot( ins->shape, sym_id );
+  if( slot < 0 ) return mrbc_nil_value();
+
+  mrbc_incref( &ins->ivar[slot] );
+  return ins->ivar[slot];
+}
+
+
+//================================================================
+/*! copy all instance variables.
+
+  @param  dst		pointer to destination instance. (no ivar)
+  @param  src		pointer to source instance.
+  @return		mrbc_error_code.
+*/
+int mrbc_instance_copy_ivar(mrbc_object *dst, const mrbc_object *src)
+{
+  const mrbc_instance *s = src->instance;
+  mrbc_instance *d = dst->instance;
+  if( !s->shape ) return 0;
+
+  int n = s->shape->num_ivar;
+  d->ivar = mrbc_raw_alloc( sizeof(mrbc_value) * n );
+  if( !d->ivar ) return E_NOMEMORY_ERROR;	// ENOMEM
+  mrbc_set_vm_id( d->ivar, mrbc_get_vm_id(d) );
+  d->ivar_size = n;
+  d->shape = s->shape;
+
+  int i;
+  for( i = 0; i < n; i++ ) {
+    d->ivar[i] = s->ivar[i];
+    mrbc_incref( &d->ivar[i] );
+  }
+
+  return 0;
 }
 
 
@@ -284,36 +500,34 @@ int mrbc_obj_is_kind_of( const mrbc_value *obj, const mrb_class *cls )
 */
 mrbc_method * mrbc_find_method( mrbc_method *r_method, mrbc_class *cls, mrbc_sym sym_id )
 {
+  mrbc_method *method;
+
   do {
-    mrbc_method *method;
-    for( method = cls->method_link; method != 0; method = method->next ) {
-      if( method->sym_id == sym_id ) {
-	*r_method = *method;
-	r_method->cls = cls;
-	return r_method;
+    if( cls->method_table ) {
+      int mask = cls->method_table_size - 1;
+      int i = sym_id & mask;
+      while( (method = cls->method_table[i]) != NULL ) {
+	if( method->sym_id == sym_id ) goto FOUND;
+	i = (i + 1) & mask;
+      }
+    } else {
+      for( method = cls->method_link; method != 0; method = method->next ) {
+	if( method->sym_id == sym_id ) goto FOUND;
       }
     }
 
     struct RBuiltinClass *c = (struct RBuiltinClass *)cls;
-    int right = c->num_builtin_method;
-    if( right == 0 ) goto NEXT;
-    int left = 0;
-
-    while( left < right ) {
-      int mid = (left + right) / 2;
-      if( c->method_symbols[mid] < sym_id ) {
-	left = mid + 1;
-      } else {
-	right = mid;
-      }
-    }
+    int size = c->num_builtin_method;
+    if( size == 0 ) goto NEXT;
 
-    if( c->method_symbols[right] == sym_id ) {
+    // direct-indexed table. see support/make_method_table.rb
+    int i = (uint16_t)sym_id % size;
+    if( c->method_symbols[i] == sym_id && c->method_functions[i] ) {
       *r_method = (mrbc_method){
 	.type = 'M',
 	.c_func = 2,
 	.sym_id = sym_id,
-	.func = c->method_functions[right],
+	.func = c->method_functions[i],
 	.cls = cls };
       return r_method;
     }
@@ -323,6 +537,11 @@ mrbc_method * mrbc_find_method( mrbc_method *r_method, mrbc_class *cls, mrbc_sym
   } while( cls != 0 );
 
   return 0;
+
+ FOUND:
+  *r_method = *method;
+  r_method->cls = cls;
+  return r_method;
 }
 
 
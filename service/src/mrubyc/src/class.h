@@ -36,29 +36,62 @@ extern "C" {
 */
 typedef struct RClass {
   mrbc_sym sym_id;		//!< class name's symbol ID
-  int16_t num_builtin_method;	//!< num of built-in method.
+  int16_t num_builtin_method;	//!< size of built-in method table.
 #ifdef MRBC_DEBUG
   const char *names;		// for debug. delete soon.
 #endif
   struct RClass *super;		//!< pointer to super class.
   struct RMethod *method_link;	//!< pointer to method link.
+  struct RMethod **method_table; //!< hash index of method_link.
+  uint16_t method_table_size;	//!< size of method_table. (power of 2)
+  uint16_t num_method;		//!< num of methods in method_link.
+  struct RShape *shape_link;	//!< shapes of the instances that have 1 ivar.
 } mrbc_class;
 typedef struct RClass mrb_class;
 
 struct RBuiltinClass {
   mrbc_sym sym_id;		//!< class name's symbol ID
-  int16_t num_builtin_method;	//!< num of built-in method.
+  int16_t num_builtin_method;	//!< size of built-in method table.
 #ifdef MRBC_DEBUG
   const char *names;		// for debug. delete soon.
 #endif
   struct RClass *super;		//!< pointer to super class.
   struct RMethod *method_link;	//!< pointer to method link.
+  struct RMethod **method_table; //!< hash index of method_link.
+  uint16_t method_table_size;	//!< size of method_table. (power of 2)
+  uint16_t num_method;		//!< num of methods in method_link.
+  struct RShape *shape_link;	//!< shapes of the instances that have 1 ivar.
 
-  const mrbc_sym *method_symbols;	//!< built-in method sym-id table.
+  const mrbc_sym *method_symbols;	//!< built-in method sym-id table. (indexed by sym_id % size)
   const mrbc_func_t *method_functions;	//!< built-in method function table.
 };
 
 
+//================================================================
+/*! instance variable layout. (shape)
+
+  Instances of the same class that set the same ivars in the same
+  order share a shape. Shapes make a tree per class, and each shape
+  adds one ivar to its parent.
+*/
+typedef struct RShape {
+  struct RShape *parent;	//!< shape without the last ivar. NULL if none.
+  struct RShape *child;		//!< link to shapes that add one more ivar.
+  struct RShape *next;		//!< link to sibling shapes.
+  mrbc_sym sym_id;		//!< the last ivar's symbol ID.
+  uint16_t num_ivar;		//!< # of ivars. sym_id is in slot num_ivar - 1.
+} mrbc_shape;
+
+
+//================================================================
+/*! Inline ivar cache entry.
+*/
+typedef struct RIvarCache {
+  const struct RShape *shape;	//!< shape at the time of caching.
+  uint16_t slot;		//!< ivar slot in the shape.
+} mrbc_ivar_cache;
+
+
 //================================================================
 /*! mruby/c instance object.
 */
@@ -66,7 +99,9 @@ typedef struct RInstance {
   MRBC_OBJECT_HEADER;
 
   struct RClass *cls;
-  struct RKeyValueHandle ivar;
+  struct RShape *shape;		//!< ivar layout. NULL if no ivar.
+  mrbc_value *ivar;		//!< ivar slots.
+  uint16_t ivar_size;		//!< allocated size of ivar slots.
   uint8_t data[];
 
 } mrbc_instance;
@@ -105,6 +140,16 @@ typedef struct RMethod {
 } mrbc_method;
 
 
+//================================================================
+/*! Inline method cache entry.
+*/
+typedef struct RMethodCache {
+  struct RClass *cls;	//!< receiver class at the time of caching.
+  uint32_t epoch;	//!< mrbc_method_epoch at the time of caching.
+  mrbc_method method;	//!< found method.
+} mrbc_method_cache;
+
+
 /***** Global variables *****************************************************/
 extern struct RClass *mrbc_class_tbl[];
 #define mrbc_class_nil		mrbc_class_tbl[ MRBC_TT_NIL ]
@@ -127,16 +172,22 @@ extern struct RClass *mrbc_class_zerodivisionerror;
 extern struct RClass *mrbc_class_argumenterror;
 extern struct RClass *mrbc_class_indexerror;
 extern struct RClass *mrbc_class_typeerror;
+extern struct RClass *mrbc_class_localjumperror;
+extern uint32_t mrbc_method_epoch;
 
 
 /***** Function prototypes **************************************************/
 mrbc_class *mrbc_define_class(struct VM *vm, const char *name, mrbc_class *super);
 mrbc_class *mrbc_define_builtin_class(const char *name, mrbc_class *super, const mrbc_sym *method_symbols, const mrbc_func_t *method_functions, int num_builtin_method);
 void mrbc_define_method(struct VM *vm, mrbc_class *cls, const char *name, mrbc_func_t cfunc);
+void mrbc_add_method(mrbc_class *cls, mrbc_method *method);
 mrbc_value mrbc_instance_new(struct VM *vm, mrbc_class *cls, int size);
 void mrbc_instance_delete(mrbc_value *v);
 void mrbc_instance_setiv(mrbc_object *obj, mrbc_sym sym_id, mrbc_value *v);
 mrbc_value mrbc_instance_getiv(mrbc_object *obj, mrbc_sym sym_id);
+int mrbc_instance_copy_ivar(mrbc_object *dst, const mrbc_object *src);
+int mrbc_shape_find_slot(const mrbc_shape *shape, mrbc_sym sym_id);
+mrbc_sym mrbc_shape_slot_symid(const mrbc_shape *shape, int slot);
 mrbc_value mrbc_proc_new(struct VM *vm, void *irep);
 void mrbc_proc_delete(mrbc_value *val);
 int mrbc_obj_is_kind_of(const mrbc_value *obj, const mrb_class *cls);
@@ -148,6 +199,17 @@ void c_ineffect(struct VM *vm, mrbc_value v[], int argc);
 
 /***** Inline functions *****************************************************/
 
+//================================================================
+/*! invalidate all inline method caches.
+
+  Call this whenever a method is defined or redefined.
+*/
+static inline void mrbc_clear_method_cache(void)
+{
+  mrbc_method_epoch++;
+}
+
+
 //================================================================
 /*! find class by object
 
@@ -577,7 +577,7 @@ int mrbc_p_sub(const mrbc_value *v)
 #if MRBC_USE_STRING
   case MRBC_TT_STRING:{
     console_putchar('"');
-    const unsigned char *s = (const unsigned char *)mrbc_string_cstr(v);
+    const unsigned char *s = v->string->data;
     int i;
     for( i = 0; i < mrbc_string_size(v); i++ ) {
       if( s[i] < ' ' || 0x7f <= s[i] ) {	// tiny isprint()
@@ -664,9 +664,9 @@ int mrbc_print_sub(const mrbc_value *v)
 
 #if MRBC_USE_STRING
   case MRBC_TT_STRING:
-    console_nprint( mrbc_string_cstr(v), mrbc_string_size(v) );
+    console_nprint( (const char *)v->string->data, mrbc_string_size(v) );
     if( mrbc_string_size(v) != 0 &&
-	mrbc_string_cstr(v)[ mrbc_string_size(v) - 1 ] == '\n' ) ret = 1;
+	v->string->data[ mrbc_string_size(v) - 1 ] == '\n' ) ret = 1;
     break;
 #endif
 
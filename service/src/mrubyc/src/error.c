@@ -16,6 +16,7 @@
 #include "vm_config.h"
 #include <stddef.h>
 #include <string.h>
+#include "alloc.h"
 #include "vm.h"
 #include "error.h"
 #include "c_string.h"
@@ -40,6 +41,37 @@ void mrbc_raiseX(mrbc_vm *vm, mrbc_error_code err, char *msg)
 }
 
 
+//================================================================
+/*! raise the exception from a C function.
+
+  Jumps to the innermost rescue/ensure, leaving the methods and blocks
+  called after it was set. Without them, the exception is left in
+  vm->exc as Kernel#raise does.
+
+  @param  vm		pointer to VM.
+  @param  exc_cls	exception class.
+*/
+void mrbc_raise_exception(struct VM *vm, struct RClass *exc_cls)
+{
+  vm->exc = exc_cls;
+  vm->exc_message = mrbc_nil_value();
+
+  mrbc_callinfo *handler = vm->exception_tail;
+  if( handler == NULL ) return;
+
+  while( vm->callinfo_tail && vm->current_regs != handler->current_regs ) {
+    mrbc_pop_callinfo(vm);
+  }
+
+  vm->exception_tail = handler->prev;
+  vm->current_regs = handler->current_regs;
+  vm->pc_irep = handler->pc_irep;
+  vm->inst = handler->inst;
+  vm->target_class = handler->target_class;
+  mrbc_free(vm, handler);
+}
+
+
 void mrbc_init_class_exception(struct VM *vm)
 {
   mrbc_class_exception = mrbc_define_class(vm, "Exception", mrbc_class_object);
@@ -51,4 +83,5 @@ void mrbc_init_class_exception(struct VM *vm)
   mrbc_class_argumenterror = mrbc_define_class(vm, "ArgumentError", mrbc_class_standarderror);
   mrbc_class_indexerror = mrbc_define_class(vm, "IndexError", mrbc_class_standarderror);
   mrbc_class_typeerror = mrbc_define_class(vm, "TypeError", mrbc_class_standarderror);
+  mrbc_class_localjumperror = mrbc_define_class(vm, "LocalJumpError", mrbc_class_standarderror);
 }
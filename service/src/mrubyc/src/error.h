@@ -22,6 +22,7 @@ extern "C" {
 #endif
 
 
+void mrbc_raise_exception(struct VM *vm, struct RClass *exc_cls);
 void mrbc_init_class_exception(struct VM *vm);
 
 
@@ -1,28 +1,610 @@
+/*! @file
+  @brief
+  Hardware abstraction layer
+        for x86
+
+  <pre>
+  Copyright (C) 2018 Kyushu Institute of Technology.
+  Copyright (C) 2018 Shimane IT Open-Innovation Center.
+
+  This file is distributed under BSD 3-Clause License.
+  </pre>
+*/
+
+/***** Feature test switches ************************************************/
+/***** System headers *******************************************************/
+#include <stdint.h>
+
+
+/***** Local headers ********************************************************/
 #include "hal.h"
 
-static void outb(short port, short val) {
-      asm volatile ("outb %%al, %%dx;" : : "a" (val), "d" (port));
+
+/***** Constat values *******************************************************/
+#define COM1_PORT	0x3f8
+#define UART_RBR	0	// 16550 registers
+#define UART_THR	0
+#define UART_IER	1
+#define UART_IIR	2
+#define UART_FCR	2
+#define UART_MCR	4
+#define UART_LSR	5
+#define UART_IER_RDA	0x01	// received data available interrupt
+#define UART_FCR_INIT	0x87	// FIFO enable and clear, RX trigger 8 bytes
+#define UART_IIR_FIFO	0xc0	// both set if FIFO works (16550A)
+#define UART_FIFO_SIZE	16
+#define UART_MCR_OUT2	0x08	// IRQ line enable on PC
+#define UART_LSR_DR	0x01
+#define UART_LSR_THRE	0x20
+
+#define PIC1_CMD	0x20	// master 8259A
+#define PIC1_DATA	0x21
+#define PIC2_CMD	0xa0	// slave 8259A
+#define PIC2_DATA	0xa1
+#define PIC_EOI		0x20
+#define IRQ_BASE	0x20	// IRQ0-15 are mapped to vector 0x20-0x2f.
+#define IRQ_TIMER	0
+#define IRQ_COM1	4
+
+#define PIT_CH0		0x40
+#define PIT_CMD		0x43
+#define PIT_HZ		1193182
+
+#define SEL_CODE	0x08	// see gdt_[] below.
+#define SEL_DATA	0x10
+
+
+/***** Macros ***************************************************************/
+/***** Typedefs *************************************************************/
+#ifndef MRBC_NO_TIMER
+typedef struct GATE_DESC {
+  uint16_t offset_lo;
+  uint16_t selector;
+  uint8_t  zero;
+  uint8_t  type_attr;	// 0x8e: present, DPL0, 32bit interrupt gate.
+  uint16_t offset_hi;
+} gate_desc;
+
+typedef struct DESC_PTR {
+  uint16_t limit;
+  uint32_t base;
+} __attribute__((packed)) desc_ptr;
+#endif
+
+
+/***** Function prototypes **************************************************/
+static inline void outb(uint16_t port, uint8_t val);
+static inline uint8_t inb(uint16_t port);
+static void uart_tx_drain(void);
+#ifndef MRBC_NO_TIMER
+void hal_isr_timer(void);
+void hal_isr_uart(void);
+void hal_isr_irq_master(void);
+void hal_isr_irq_slave(void);
+void hal_isr_spurious(void);
+void hal_isr_fault(void);
+#endif
+
+
+/***** Local variables ******************************************************/
+#ifndef MRBC_NO_TIMER
+// flat 4GB segments. the multiboot loader leaves GDTR undefined,
+// so we need our own to return from interrupts.
+static const uint64_t gdt_[3] __attribute__((aligned(8))) = {
+  0,
+  0x00cf9a000000ffffULL,	// SEL_CODE
+  0x00cf92000000ffffULL,	// SEL_DATA
+};
+static gate_desc idt_[256] __attribute__((aligned(8)));
+static int flag_init_;
+
+// COM1 receive ring buffer.
+//  single producer (IRQ4 handler) moves rx_head_,
+//  single consumer (hal_read) moves rx_tail_, so no lock is needed.
+static volatile uint8_t rx_buf_[HAL_UART_RX_BUFSIZE];
+static volatile uint16_t rx_head_;
+static volatile uint16_t rx_tail_;
+static volatile uint8_t rx_stopped_;	// RX interrupt is disabled by full.
+#endif
+
+// COM1 transmit ring buffer.
+//  hal_write() moves tx_head_, uart_tx_drain() moves tx_tail_
+//  from hal_flush() or the timer handler with interrupts disabled.
+static volatile uint8_t tx_buf_[HAL_UART_TX_BUFSIZE];
+static volatile uint16_t tx_head_;
+static volatile uint16_t tx_tail_;
+static uint8_t tx_burst_ = 1;	// bytes per THRE check, FIFO size if enabled.
+
+
+/***** Global variables *****************************************************/
+/***** Signal catching functions ********************************************/
+#ifndef MRBC_NO_TIMER
+//================================================================
+/*!@brief
+  interrupt entry stubs
+
+  Save the registers and call the C handler, since gcc can not make
+  an interrupt function for i386 without -mgeneral-regs-only.
+*/
+__asm__(
+  ".text\n"
+  ".globl hal_isr_timer\n"
+  "hal_isr_timer:\n"
+  "	pushal\n"
+  "	cld\n"
+  "	call hal_timer_handler\n"
+  "	popal\n"
+  "	iret\n"
+
+  ".globl hal_isr_uart\n"
+  "hal_isr_uart:\n"
+  "	pushal\n"
+  "	cld\n"
+  "	call hal_uart_handler\n"
+  "	popal\n"
+  "	iret\n"
+
+  ".globl hal_isr_irq_master\n"
+  "hal_isr_irq_master:\n"
+  "	push %eax\n"
+  "	movb $0x20, %al\n"
+  "	outb %al, $0x20\n"
+  "	pop %eax\n"
+  "	iret\n"
+
+  ".globl hal_isr_irq_slave\n"
+  "hal_isr_irq_slave:\n"
+  "	push %eax\n"
+  "	movb $0x20, %al\n"
+  "	outb %al, $0xa0\n"
+  "	outb %al, $0x20\n"
+  "	pop %eax\n"
+  "	iret\n"
+
+  ".globl hal_isr_spurious\n"
+  "hal_isr_spurious:\n"
+  "	iret\n"
+
+  ".globl hal_isr_fault\n"
+  "hal_isr_fault:\n"
+  "	cli\n"
+  "1:	hlt\n"
+  "	jmp 1b\n"
+);
+
+
+//================================================================
+/*!@brief
+  timer (IRQ0) handler
+
+*/
+void hal_timer_handler(void)
+{
+  outb(PIC1_CMD, PIC_EOI);
+  mrbc_tick();
+  uart_tx_drain();
+}
+
+
+//================================================================
+/*!@brief
+  COM1 (IRQ4) handler
+
+  Move all received bytes into the ring buffer. If it is full, stop
+  the RX interrupt and leave the rest in the UART, so the sender is
+  held back instead of losing data. hal_read() restarts it.
+*/
+void hal_uart_handler(void)
+{
+  while( inb(COM1_PORT + UART_LSR) & UART_LSR_DR ) {
+    uint16_t head = rx_head_;
+    uint16_t next = (head + 1) & (HAL_UART_RX_BUFSIZE - 1);
+
+    if( next == rx_tail_ ) {
+      rx_stopped_ = 1;
+      outb(COM1_PORT + UART_IER, 0);
+      break;
+    }
+    rx_buf_[head] = inb(COM1_PORT + UART_RBR);
+    rx_head_ = next;
+  }
+  outb(PIC1_CMD, PIC_EOI);
+  mrbc_wakeup_io();
+}
+#endif
+
+
+/***** Local functions ******************************************************/
+//================================================================
+/*!@brief
+  write to I/O port
+
+*/
+static inline void outb(uint16_t port, uint8_t val)
+{
+  __asm__ volatile ("outb %%al, %%dx" : : "a" (val), "d" (port));
 }
-static char inb(short port) {
-      char val;
-      asm volatile ("inb %%dx, %%al;" : "=a" (val) : "d" (port));
-      return val;
+
+
+//================================================================
+/*!@brief
+  read from I/O port
+
+*/
+static inline uint8_t inb(uint16_t port)
+{
+  uint8_t val;
+  __asm__ volatile ("inb %%dx, %%al" : "=a" (val) : "d" (port));
+  return val;
 }
 
-static void _putchar_r(char ch) {
-	const int port = 0x3f8;
-	while ((inb(port + 5) & (1<<5)) == 0);
-	outb(port + 0, ch);
+
+//================================================================
+/*!@brief
+  disable interrupts and return the previous EFLAGS.
+
+*/
+static inline unsigned long irq_save(void)
+{
+  unsigned long flags;
+  __asm__ volatile ("pushf; pop %0; cli" : "=r" (flags) : : "memory");
+  return flags;
 }
 
-int hal_write(int fd, const void *buf, int nbytes) {
-	int i = nbytes;
-	const char *p = buf;
-	while (--i >= 0) {
-		_putchar_r(*p++);
-	}
-	return nbytes;
+
+//================================================================
+/*!@brief
+  restore EFLAGS (and so IF) saved by irq_save().
+
+*/
+static inline void irq_restore(unsigned long flags)
+{
+  __asm__ volatile ("push %0; popf" : : "r" (flags) : "memory", "cc");
 }
-int hal_flush(int fd) {
-	return 0;
+
+
+//================================================================
+/*!@brief
+  move bytes from the transmit ring buffer to the UART.
+
+  Writes up to tx_burst_ bytes at once each time THR (and the FIFO)
+  becomes empty, and returns when the UART is busy.
+  Call with interrupts disabled.
+*/
+static void uart_tx_drain(void)
+{
+  uint16_t tail = tx_tail_;
+
+  while( tail != tx_head_ ) {
+    if( (inb(COM1_PORT + UART_LSR) & UART_LSR_THRE) == 0 ) break;
+
+    int n = tx_burst_;
+    do {
+      outb(COM1_PORT + UART_THR, tx_buf_[tail]);
+      tail = (tail + 1) & (HAL_UART_TX_BUFSIZE - 1);
+    } while( --n > 0 && tail != tx_head_ );
+  }
+  tx_tail_ = tail;
+}
+
+
+#ifndef MRBC_NO_TIMER
+//================================================================
+/*!@brief
+  set an interrupt gate.
+
+*/
+static void set_gate(int n, void (*isr)(void))
+{
+  uint32_t addr = (uint32_t)isr;
+
+  idt_[n].offset_lo = addr & 0xffff;
+  idt_[n].selector  = SEL_CODE;
+  idt_[n].zero      = 0;
+  idt_[n].type_attr = 0x8e;
+  idt_[n].offset_hi = addr >> 16;
+}
+
+
+//================================================================
+/*!@brief
+  load GDT and reload segment registers.
+
+*/
+static void init_gdt(void)
+{
+  desc_ptr gdtr = { sizeof(gdt_) - 1, (uint32_t)gdt_ };
+
+  __asm__ volatile ("lgdt %0\n"
+		    "ljmp %1, $1f\n"
+		    "1:\n"
+		    "mov %2, %%ax\n"
+		    "mov %%ax, %%ds\n"
+		    "mov %%ax, %%es\n"
+		    "mov %%ax, %%fs\n"
+		    "mov %%ax, %%gs\n"
+		    "mov %%ax, %%ss\n"
+		    : : "m" (gdtr), "i" (SEL_CODE), "i" (SEL_DATA) : "eax", "memory");
+}
+
+
+//================================================================
+/*!@brief
+  build and load IDT.
+
+*/
+static void init_idt(void)
+{
+  int i;
+  for( i = 0; i < IRQ_BASE; i++ ) {
+    set_gate(i, hal_isr_fault);
+  }
+  for( i = 0; i < 8; i++ ) {
+    set_gate(IRQ_BASE + i, hal_isr_irq_master);
+    set_gate(IRQ_BASE + 8 + i, hal_isr_irq_slave);
+  }
+  set_gate(IRQ_BASE + IRQ_TIMER, hal_isr_timer);
+  set_gate(IRQ_BASE + IRQ_COM1, hal_isr_uart);
+  set_gate(IRQ_BASE + 7, hal_isr_spurious);	// no EOI for spurious IRQ.
+
+  desc_ptr idtr = { sizeof(idt_) - 1, (uint32_t)idt_ };
+  __asm__ volatile ("lidt %0" : : "m" (idtr));
+}
+
+
+//================================================================
+/*!@brief
+  remap the 8259A PICs to IRQ_BASE, and unmask IRQ0 and IRQ4 only.
+
+*/
+static void init_pic(void)
+{
+  outb(PIC1_CMD,  0x11);		// ICW1: edge, cascade, ICW4
+  outb(PIC2_CMD,  0x11);
+  outb(PIC1_DATA, IRQ_BASE);		// ICW2: vector offset
+  outb(PIC2_DATA, IRQ_BASE + 8);
+  outb(PIC1_DATA, 0x04);		// ICW3: slave on IRQ2
+  outb(PIC2_DATA, 0x02);
+  outb(PIC1_DATA, 0x01);		// ICW4: 8086 mode
+  outb(PIC2_DATA, 0x01);
+
+  outb(PIC1_DATA, (uint8_t)~(1 << IRQ_TIMER | 1 << IRQ_COM1));	// OCW1: mask
+  outb(PIC2_DATA, 0xff);
+}
+
+
+//================================================================
+/*!@brief
+  start PIT channel 0 as a periodic tick of MRBC_TICK_UNIT ms.
+
+*/
+static void init_pit(void)
+{
+  uint32_t divisor = PIT_HZ * MRBC_TICK_UNIT / 1000;
+
+  outb(PIT_CMD, 0x34);			// ch0, lo/hi byte, mode 2 (rate)
+  outb(PIT_CH0, divisor & 0xff);
+  outb(PIT_CH0, divisor >> 8);
+}
+
+
+//================================================================
+/*!@brief
+  enable the receive interrupt of COM1.
+
+  Enabling the FIFO clears the UART, so a byte that arrived before
+  is saved to the ring buffer. Bytes still in the host are not lost.
+*/
+static void init_uart(void)
+{
+  if( inb(COM1_PORT + UART_LSR) & UART_LSR_DR ) {
+    rx_buf_[rx_head_] = inb(COM1_PORT + UART_RBR);
+    rx_head_ = (rx_head_ + 1) & (HAL_UART_RX_BUFSIZE - 1);
+  }
+  outb(COM1_PORT + UART_FCR, UART_FCR_INIT);
+  if( (inb(COM1_PORT + UART_IIR) & UART_IIR_FIFO) == UART_IIR_FIFO ) {
+    tx_burst_ = UART_FIFO_SIZE;
+  }
+
+  outb(COM1_PORT + UART_MCR, 0x03 | UART_MCR_OUT2);	// DTR, RTS, OUT2
+  outb(COM1_PORT + UART_IER, UART_IER_RDA);
+}
+
+
+//================================================================
+/*!@brief
+  take received bytes out of the ring buffer.
+
+  @param  buf		pointer of buffer.
+  @param  nbytes	buffer size.
+  @return		number of bytes taken.
+*/
+static int uart_rx_take(uint8_t *buf, int nbytes)
+{
+  uint16_t tail = rx_tail_;
+  uint16_t head = rx_head_;
+  int n = 0;
+
+  while( tail != head && n < nbytes ) {
+    buf[n++] = rx_buf_[tail];
+    tail = (tail + 1) & (HAL_UART_RX_BUFSIZE - 1);
+  }
+  rx_tail_ = tail;
+
+  if( n && rx_stopped_ ) {
+    rx_stopped_ = 0;
+    outb(COM1_PORT + UART_IER, UART_IER_RDA);
+  }
+  return n;
+}
+#endif
+
+
+/***** Global functions *****************************************************/
+#ifndef MRBC_NO_TIMER
+//================================================================
+/*!@brief
+  initialize
+
+*/
+void hal_init(void)
+{
+  if( flag_init_ ) return;	// already called before mrbc_init().
+  flag_init_ = 1;
+
+  cli();
+  init_gdt();
+  init_idt();
+  init_pic();
+  init_pit();
+  init_uart();
+  sti();
+}
+#endif
+
+
+//================================================================
+/*!@brief
+  Write
+
+  Bytes are stored in the transmit ring buffer, and flushed if it
+  is full or a newline is written.
+
+  @param  fd    dummy, but 1.
+  @param  buf   pointer of buffer.
+  @param  nbytes        output byte length.
+*/
+int hal_write(int fd, const void *buf, int nbytes)
+{
+  const uint8_t *p = buf;
+  int flag_newline = 0;
+  int i;
+
+  for( i = 0; i < nbytes; i++ ) {
+    uint16_t head = tx_head_;
+    uint16_t next = (head + 1) & (HAL_UART_TX_BUFSIZE - 1);
+
+    if( next == tx_tail_ ) hal_flush(fd);	// buffer full.
+    if( p[i] == '\n' ) flag_newline = 1;
+    tx_buf_[head] = p[i];
+    tx_head_ = next;
+  }
+  if( flag_newline ) hal_flush(fd);
+
+  return nbytes;
+}
+
+
+//================================================================
+/*!@brief
+  Read
+
+  Blocks until nbytes are received. While the ring buffer is empty,
+  the CPU sleeps until the next interrupt.
+  hal_init() must have been called.
+  Pending output (e.g. a prompt) is flushed first.
+
+  @param  fd    dummy, but 0.
+  @param  buf   pointer of buffer.
+  @param  nbytes        input byte length.
+*/
+int hal_read(int fd, void *buf, int nbytes)
+{
+  uint8_t *p = buf;
+  int n = nbytes;
+
+  hal_flush(1);
+  while( n > 0 ) {
+#ifndef MRBC_NO_TIMER
+    int len = uart_rx_take(p, n);
+    if( len == 0 ) {
+      cli();
+      if( rx_head_ == rx_tail_ ) sti_hlt(); else sti();
+      continue;
+    }
+    p += len;
+    n -= len;
+#else
+    while( (inb(COM1_PORT + UART_LSR) & UART_LSR_DR) == 0 )
+      ;
+    *p++ = inb(COM1_PORT + UART_RBR);
+    n--;
+#endif
+  }
+  return nbytes;
+}
+
+
+//================================================================
+/*!@brief
+  Number of received bytes
+
+  @return	bytes that hal_read() can return without waiting.
+*/
+int hal_read_available(void)
+{
+#ifndef MRBC_NO_TIMER
+  return (rx_head_ - rx_tail_) & (HAL_UART_RX_BUFSIZE - 1);
+#else
+  return (inb(COM1_PORT + UART_LSR) & UART_LSR_DR) ? 1 : 0;
+#endif
+}
+
+
+//================================================================
+/*!@brief
+  Find a byte in received data
+
+  @param  ch	byte to find.
+  @return	bytes up to and including ch, or 0 if not received yet.
+*/
+int hal_read_until(int ch)
+{
+#ifndef MRBC_NO_TIMER
+  uint16_t tail = rx_tail_;
+  uint16_t head = rx_head_;
+  int n = 0;
+
+  while( tail != head ) {
+    n++;
+    if( rx_buf_[tail] == (uint8_t)ch ) return n;
+    tail = (tail + 1) & (HAL_UART_RX_BUFSIZE - 1);
+  }
+#endif
+  return 0;
+}
+
+
+//================================================================
+/*!@brief
+  Read one byte
+
+  @return	received byte.
+*/
+int hal_getchar(void)
+{
+  uint8_t ch;
+  hal_read(0, &ch, 1);
+  return ch;
+}
+
+
+//================================================================
+/*!@brief
+  Flush write baffer
+
+  Waits until the UART takes all buffered bytes. Interrupts are
+  disabled only while one burst is written, and the caller's IF is
+  restored between bursts, so ticks and input are not held off.
+
+  @param  fd    dummy, but 1.
+*/
+int hal_flush(int fd)
+{
+  while( tx_tail_ != tx_head_ ) {
+    unsigned long flags = irq_save();
+    uart_tx_drain();
+    irq_restore(flags);
+  }
+  return 0;
 }
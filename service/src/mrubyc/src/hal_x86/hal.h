@@ -33,14 +33,27 @@ extern "C" {
 // (recommended value is from 1 to 10).
 #define MRBC_TIMESLICE_TICK_COUNT 10
 #endif
-#if !defined(MRBC_NO_TIMER)	// use hardware timer.
-#define sti() __asm__ ("sti"::)
-#define cli() __asm__ ("cli"::)
-#define hlt() __asm__ ("hlt"::)
-# define hal_init()        ((void)0) // this wont work now...
+
+// receive ring buffer size of COM1 (power of 2, max 32768).
+#if !defined(HAL_UART_RX_BUFSIZE)
+#define HAL_UART_RX_BUFSIZE 512
+#endif
+
+// transmit ring buffer size of COM1 (power of 2, max 32768).
+//  it is flushed at newline, before waiting input, and by timer tick.
+#if !defined(HAL_UART_TX_BUFSIZE)
+#define HAL_UART_TX_BUFSIZE 256
+#endif
+
+#if !defined(MRBC_NO_TIMER)	// use hardware timer (PIT, IRQ0).
+#define sti() __asm__ volatile ("sti" ::: "memory")
+#define cli() __asm__ volatile ("cli" ::: "memory")
+// sti takes effect after the next instruction, so no tick is lost
+// between them. the CPU sleeps until the next interrupt.
+#define sti_hlt() __asm__ volatile ("sti; hlt" ::: "memory")
 # define hal_enable_irq()  sti()
 # define hal_disable_irq() cli()
-# define hal_idle_cpu()    hlt()
+# define hal_idle_cpu()    sti_hlt()
 
 #else // MRBC_NO_TIMER
 static void sleep_ms_fake(int useconds) {
@@ -62,8 +75,17 @@ static void sleep_ms_fake(int useconds) {
 /***** Typedefs *************************************************************/
 /***** Global variables *****************************************************/
 /***** Function prototypes **************************************************/
+void mrbc_tick(void);
+void mrbc_wakeup_io(void);
+#if !defined(MRBC_NO_TIMER)
+void hal_init(void);
+#endif
 int hal_write(int fd, const void *buf, int nbytes);
 int hal_flush(int fd);
+int hal_read(int fd, void *buf, int nbytes);
+int hal_read_available(void);
+int hal_read_until(int ch);
+int hal_getchar(void);
 
 
 /***** Inline functions *****************************************************/
@@ -19,8 +19,10 @@
 
 #include "vm.h"
 #include "load.h"
+#include "opcode.h"
 #include "value.h"
 #include "alloc.h"
+#include "symbol.h"
 #include "console.h"
 
 //
@@ -30,6 +32,28 @@
 
 
 
+//
+// operand types of each opcode. (see opcode.h)
+//
+enum { OPR_Z, OPR_B, OPR_BB, OPR_BBB, OPR_BS, OPR_S, OPR_W };
+static const uint8_t operand_type[] = {
+  OPR_Z,    OPR_BB,   OPR_BB,   OPR_BB,   OPR_BB,   OPR_B,    OPR_B,    OPR_B,	// 0x00
+  OPR_B,    OPR_B,    OPR_B,    OPR_B,    OPR_B,    OPR_B,    OPR_BB,   OPR_B,	// 0x08
+  OPR_B,    OPR_B,    OPR_B,    OPR_BB,   OPR_BB,   OPR_BB,   OPR_BB,   OPR_BB,	// 0x10
+  OPR_BB,   OPR_BB,   OPR_BB,   OPR_BB,   OPR_BB,   OPR_BB,   OPR_BB,   OPR_BBB,	// 0x18
+  OPR_BBB,  OPR_S,    OPR_BS,   OPR_BS,   OPR_BS,   OPR_S,    OPR_B,    OPR_BB,	// 0x20
+  OPR_B,    OPR_B,    OPR_B,    OPR_B,    OPR_BB,   OPR_BB,   OPR_BBB,  OPR_BBB,	// 0x28
+  OPR_Z,    OPR_BB,   OPR_BS,   OPR_W,    OPR_BB,   OPR_Z,    OPR_BB,   OPR_B,	// 0x30
+  OPR_B,    OPR_B,    OPR_BS,   OPR_B,    OPR_BB,   OPR_B,    OPR_BB,   OPR_B,	// 0x38
+  OPR_B,    OPR_B,    OPR_B,    OPR_B,    OPR_B,    OPR_B,    OPR_BB,   OPR_BBB,	// 0x40
+  OPR_B,    OPR_B,    OPR_B,    OPR_BBB,  OPR_BBB,  OPR_BBB,  OPR_B,    OPR_BB,	// 0x48
+  OPR_B,    OPR_BB,   OPR_BB,   OPR_B,    OPR_BB,   OPR_BB,   OPR_BB,   OPR_B,	// 0x50
+  OPR_B,    OPR_B,    OPR_BB,   OPR_BB,   OPR_BB,   OPR_BB,   OPR_BB,   OPR_B,	// 0x58
+  OPR_B,    OPR_B,    OPR_BBB,  OPR_B,    OPR_Z,    OPR_Z,    OPR_Z,    OPR_Z,	// 0x60
+  OPR_Z,	// 0x68
+};
+
+
 //================================================================
 /*! Parse header section.
 
@@ -75,6 +99,350 @@ static int load_header(struct VM *vm, const uint8_t **pos)
 
 
 
+//================================================================
+/*!@brief
+  Instruction with the operands as they are in the bytecode.
+*/
+typedef struct RAW_INST {
+  uint8_t op;
+  uint32_t a, b, c;
+} RAW_INST;
+
+// usage of a symbol. (see sym_operands)
+enum { USE_IVAR = 1, USE_OTHER = 2, USE_SEND = 4, USE_SEND8 = 8 };
+
+
+//================================================================
+/*! decode one instruction.
+
+  @param  p	pointer to the bytecode.
+  @param  ri	pointer to the decoded instruction (output).
+  @return	pointer to the next bytecode, or NULL if unknown opcode.
+*/
+static const uint8_t * decode_inst(const uint8_t *p, RAW_INST *ri)
+{
+#define READ_B() (p += 1, p[-1])
+#define READ_S() (p += 2, bin_to_uint16(p-2))
+#define READ_W() (p += 3, (uint32_t)p[-3] << 16 | p[-2] << 8 | p[-1])
+
+  int ext = 0;
+  int op = READ_B();
+  if( OP_EXT1 <= op && op <= OP_EXT3 ) {
+    ext = op - OP_EXT1 + 1;	// 1:1st, 2:2nd, 3:both operands 16bit.
+    op = READ_B();
+  }
+  if( op >= sizeof(operand_type) ) return NULL;
+
+  ri->op = op;
+  ri->a = ri->b = ri->c = 0;
+
+  switch( operand_type[op] ) {
+  case OPR_B:
+    ri->a = (ext & 1) ? READ_S() : READ_B();
+    break;
+  case OPR_BBB:
+    ri->a = (ext & 1) ? READ_S() : READ_B();
+    ri->b = (ext & 2) ? READ_S() : READ_B();
+    ri->c = READ_B();
+    break;
+  case OPR_BB:
+    ri->a = (ext & 1) ? READ_S() : READ_B();
+    ri->b = (ext & 2) ? READ_S() : READ_B();
+    break;
+  case OPR_BS:
+    ri->a = (ext & 1) ? READ_S() : READ_B();
+    ri->b = READ_S();
+    break;
+  case OPR_S:
+    ri->b = READ_S();
+    break;
+  case OPR_W:
+    ri->a = READ_W();
+    ri->b = ri->a >> 8;
+    ri->a &= 0xff;
+    break;
+  }
+
+  return p;
+#undef READ_B
+#undef READ_S
+#undef READ_W
+}
+
+
+//================================================================
+/*! store the instruction to mrbc_inst.
+
+  @param  inst	pointer to the mrbc_inst (output).
+  @param  ri	pointer to the decoded instruction.
+  @return int	zero if no error, or the operand does not fit in mrbc_inst.
+*/
+static int store_inst(mrbc_inst *inst, const RAW_INST *ri)
+{
+  if( ri->a > 0xff ) return -1;
+
+  inst->op = ri->op;
+  inst->a = ri->a;
+  if( operand_type[ri->op] == OPR_BBB ) {
+    if( ri->b > 0xff ) return -1;
+    inst->bc.b = ri->b;
+    inst->bc.c = ri->c;
+  } else {
+    if( ri->b > 0xffff ) return -1;
+    inst->b = ri->b;
+  }
+
+  return 0;
+}
+
+
+//================================================================
+/*! get the operands that refer to the SYMS block.
+
+  @param  ri	pointer to the decoded instruction.
+  @param  opr	pointers to the operands. (output)
+  @param  use	usage of each symbol. (output)
+  @return int	number of the operands. (0..2)
+*/
+static int sym_operands(RAW_INST *ri, uint32_t *opr[2], int use[2])
+{
+  switch( ri->op ) {
+  case OP_ALIAS:
+    opr[1] = &ri->b;
+    use[1] = USE_OTHER;
+    // fall through
+  case OP_UNDEF:
+    opr[0] = &ri->a;
+    use[0] = USE_OTHER;
+    return (ri->op == OP_ALIAS) ? 2 : 1;
+
+  case OP_LOADSYM:	case OP_GETGV:		case OP_SETGV:
+  case OP_GETSV:	case OP_SETSV:		case OP_GETCV:
+  case OP_SETCV:	case OP_GETCONST:	case OP_SETCONST:
+  case OP_GETMCNST:	case OP_SETMCNST:	case OP_KEY_P:
+  case OP_KARG:		case OP_CLASS:		case OP_MODULE:
+  case OP_DEF:
+    use[0] = USE_OTHER;
+    break;
+  case OP_SEND:		case OP_SENDB:
+    use[0] = USE_OTHER | USE_SEND8;
+    break;
+  case OP_SENDV:	case OP_SENDVB:
+    use[0] = USE_OTHER | USE_SEND;
+    break;
+  case OP_GETIV:	case OP_SETIV:
+    use[0] = USE_IVAR;
+    break;
+  default:
+    return 0;
+  }
+
+  opr[0] = &ri->b;
+  return 1;
+}
+
+
+//================================================================
+/*! read SYMS block and resolve it to symbol IDs.
+
+  The symbols are renumbered so that the method names of OP_SEND
+  family come first, OP_SEND and OP_SENDB before the others because
+  their operand is 8bit. The inline method cache is allocated for
+  these irep->nsend symbols only, and the send sites index it by
+  their operand.
+
+  The operand of OP_GETIV and OP_SETIV is resolved without '@', same
+  as the key of RInstance::ivar. If the name is also used by another
+  operand (e.g. :@foo), the ivar operand gets an extra symbol slot.
+
+  @param  irep	pointer to IREP. set syms, slen and nsend.
+  @param  iseq	pointer to ISEQ block.
+  @param  size	byte size of ISEQ block.
+  @param  pos	pointer to the first symbol of SYMS block.
+  @param  order	new index of each symbol, and of its ivar usage. (output)
+  @return int	zero if no error.
+*/
+static int load_syms(mrbc_irep *irep, const uint8_t *iseq, int size,
+		     const uint8_t **pos, uint16_t **order)
+{
+  int n = irep->slen;
+  const uint8_t *p;
+  RAW_INST ri;
+  uint32_t *opr[2];
+  int use_opr[2];
+  int i, k;
+
+  // scan how the symbols are used.
+  uint8_t *use = mrbc_alloc(0, n + 1);
+  if( use == NULL ) return -1;
+  memset( use, 0, n + 1 );
+
+  for( p = iseq; p < iseq + size; ) {
+    p = decode_inst(p, &ri);
+    if( p == NULL ) goto ERROR1;
+    for( k = sym_operands(&ri, opr, use_opr); --k >= 0; ) {
+      if( *opr[k] >= n ) goto ERROR1;
+      use[*opr[k]] |= use_opr[k];
+    }
+  }
+
+  // new index of each symbol, and of its ivar usage.
+  uint16_t *new_order = mrbc_alloc(0, sizeof(uint16_t) * (n * 2 + 1));
+  if( new_order == NULL ) goto ERROR1;
+  uint16_t *iv_order = new_order + n;
+  memset( new_order, 0xff, sizeof(uint16_t) * n );
+
+  int len = 0;
+  for( i = 0; i < n; i++ ) {
+    if( use[i] & USE_SEND8 ) new_order[i] = len++;
+  }
+  for( i = 0; i < n; i++ ) {
+    if( (use[i] & (USE_SEND|USE_SEND8)) == USE_SEND ) new_order[i] = len++;
+  }
+  irep->nsend = len;
+
+  for( i = 0; i < n; i++ ) {
+    if( new_order[i] == 0xffff ) new_order[i] = len++;
+    iv_order[i] = new_order[i];
+  }
+  for( i = 0; i < n; i++ ) {
+    if( (use[i] & (USE_IVAR|USE_OTHER)) == (USE_IVAR|USE_OTHER) ) {
+      iv_order[i] = len++;
+    }
+  }
+  if( len >= 0xffff ) goto ERROR2;
+
+  // resolve the names.
+  mrbc_sym *syms = NULL;
+  if( len ) {
+    syms = mrbc_alloc(0, sizeof(mrbc_sym) * len);
+    if( syms == NULL ) goto ERROR2;
+  }
+
+  p = *pos;
+  for( i = 0; i < n; i++ ) {
+    int s = bin_to_uint16(p);		p += 2;
+    const char *name = (const char *)p;
+    p += s+1;
+
+    if( use[i] & USE_IVAR ) {
+      syms[iv_order[i]] = str_to_symid( name[0] == '@' ? name+1 : name );
+    }
+    if( use[i] != USE_IVAR ) {
+      syms[new_order[i]] = str_to_symid(name);
+    }
+  }
+  *pos = p;
+
+  irep->syms = syms;
+  irep->slen = len;
+  *order = new_order;
+  mrbc_free(0, use);
+  return 0;
+
+ ERROR2:
+  mrbc_free(0, new_order);
+ ERROR1:
+  mrbc_free(0, use);
+  return -1;
+}
+
+
+//================================================================
+/*! count instructions in ISEQ block.
+
+  @param  iseq	pointer to ISEQ block.
+  @param  size	byte size of ISEQ block.
+  @return int	number of instructions, or -1 if illegal bytecode.
+*/
+static int count_iseq(const uint8_t *iseq, int size)
+{
+  const uint8_t *p;
+  RAW_INST ri;
+  int n = 0;
+
+  for( p = iseq; p < iseq + size; n++ ) {
+    p = decode_inst(p, &ri);
+    if( p == NULL ) return -1;
+  }
+  if( p != iseq + size || n >= 0xffff ) return -1;
+
+  return n;
+}
+
+
+//================================================================
+/*! translate ISEQ block to the array of mrbc_inst.
+
+  The symbol operands are renumbered by the order made by load_syms(),
+  and then checked that they fit in mrbc_inst.
+
+  @param  irep	pointer to IREP. set code and ilen.
+  @param  iseq	pointer to ISEQ block.
+  @param  size	byte size of ISEQ block.
+  @param  n	number of instructions. (see count_iseq)
+  @param  order	new index of each symbol.
+  @param  iv_order new index of each symbol used by OP_GETIV and OP_SETIV.
+  @return int	zero if no error.
+*/
+static int decode_iseq(mrbc_irep *irep, const uint8_t *iseq, int size, int n,
+		       const uint16_t *order, const uint16_t *iv_order)
+{
+  const uint8_t *p;
+  RAW_INST ri;
+  uint32_t *opr[2];
+  int use_opr[2];
+  int i, k;
+
+  irep->code = mrbc_alloc(0, sizeof(mrbc_inst) * n);
+  if( irep->code == NULL ) return -1;
+
+  // map of bytecode offset to instruction index, for jump destinations.
+  //  0xffff means the middle of an instruction.
+  uint16_t *index = mrbc_alloc(0, sizeof(uint16_t) * (size + 1));
+  if( index == NULL ) goto ERROR;
+  memset( index, 0xff, sizeof(uint16_t) * (size + 1) );
+
+  p = iseq;
+  for( i = 0; i < n; i++ ) {
+    index[p - iseq] = i;
+    p = decode_inst(p, &ri);
+
+    for( k = sym_operands(&ri, opr, use_opr); --k >= 0; ) {
+      *opr[k] = (use_opr[k] == USE_IVAR) ? iv_order[*opr[k]] : order[*opr[k]];
+    }
+    if( store_inst(&irep->code[i], &ri) != 0 ) goto ERROR;
+  }
+  index[size] = n;
+
+  // resolve jump destinations.
+  for( i = 0; i < n; i++ ) {
+    mrbc_inst *ip = &irep->code[i];
+
+    switch( ip->op ) {
+    case OP_JMP:
+    case OP_ONERR:
+    case OP_JMPIF:
+    case OP_JMPNOT:
+    case OP_JMPNIL:
+      if( ip->b > size || index[ip->b] == 0xffff ) goto ERROR;
+      ip->b = index[ip->b];
+      break;
+    }
+  }
+  irep->ilen = n;
+
+  mrbc_free(0, index);
+  return 0;
+
+ ERROR:
+  if( index ) mrbc_free(0, index);
+  mrbc_free(0, irep->code);
+  irep->code = NULL;
+  return -1;
+}
+
+
 //================================================================
 /*! read one irep section.
 
@@ -90,7 +458,7 @@ static int load_header(struct VM *vm, const uint8_t **pos)
    0000		n of child irep
 
    0000_0000	n of byte code  (ISEQ BLOCK)
-   ...		byte codes
+   ...		byte codes	(decoded to mrbc_inst array)
 
    0000_0000	n of pool	(POOL BLOCK)
    (loop n of pool)
@@ -119,7 +487,7 @@ static mrbc_irep * load_irep_1(struct VM *vm, const uint8_t **pos)
   irep->nlocals = bin_to_uint16(p);	p += 2;
   irep->nregs = bin_to_uint16(p);	p += 2;
   irep->rlen = bin_to_uint16(p);	p += 2;
-  irep->ilen = bin_to_uint32(p);	p += 4;
+  int iseq_size = bin_to_uint32(p);	p += 4;
 
   // padding
   p += (vm->mrb - p) & 0x03;
@@ -127,24 +495,22 @@ static mrbc_irep * load_irep_1(struct VM *vm, const uint8_t **pos)
   // allocate memory for child irep's pointers
   if( irep->rlen ) {
     irep->reps = (mrbc_irep **)mrbc_alloc(0, sizeof(mrbc_irep *) * irep->rlen);
-    if( irep->reps == NULL ) {
-      mrbc_raise(vm, E_BYTECODE_ERROR, NULL);
-      return NULL;
-    }
+    if( irep->reps == NULL ) goto ERROR;
+    memset( irep->reps, 0, sizeof(mrbc_irep *) * irep->rlen );
   }
 
-  // ISEQ (code) BLOCK
-  irep->code = (uint8_t *)p;
-  p += irep->ilen;
+  // ISEQ (code) BLOCK. decode it after SYMS BLOCK.
+  const uint8_t *iseq = p;
+  int n_inst = count_iseq(iseq, iseq_size);
+  if( n_inst < 0 ) goto ERROR;
+  p += iseq_size;
 
   // POOL BLOCK
   irep->plen = bin_to_uint32(p);	p += 4;
   if( irep->plen ) {
     irep->pools = (mrbc_object**)mrbc_alloc(0, sizeof(void*) * irep->plen);
-    if(irep->pools == NULL ) {
-      mrbc_raise(vm, E_BYTECODE_ERROR, NULL);
-      return NULL;
-    }
+    if(irep->pools == NULL ) goto ERROR;
+    memset( irep->pools, 0, sizeof(void*) * irep->plen );
   }
 
   int i;
@@ -152,10 +518,7 @@ static mrbc_irep * load_irep_1(struct VM *vm, const uint8_t **pos)
     int tt = *p++;
     int obj_size = bin_to_uint16(p);	p += 2;
     mrbc_object *obj = mrbc_alloc(0, sizeof(mrbc_object));
-    if( obj == NULL ) {
-      mrbc_raise(vm, E_BYTECODE_ERROR, NULL);
-      return NULL;
-    }
+    if( obj == NULL ) goto ERROR;
     switch( tt ) {
 #if MRBC_USE_STRING
     case 0: { // IREP_TT_STRING
@@ -188,15 +551,21 @@ static mrbc_irep * load_irep_1(struct VM *vm, const uint8_t **pos)
   }
 
   // SYMS BLOCK
-  irep->ptr_to_sym = (uint8_t*)p;
-  int slen = bin_to_uint32(p);		p += 4;
-  while( --slen >= 0 ) {
-    int s = bin_to_uint16(p);		p += 2;
-    p += s+1;
-  }
+  int n_syms = irep->slen = bin_to_uint32(p);	p += 4;
+  uint16_t *order;
+  if( load_syms(irep, iseq, iseq_size, &p, &order) != 0 ) goto ERROR;
+
+  int ret = decode_iseq(irep, iseq, iseq_size, n_inst, order, order + n_syms);
+  mrbc_free(0, order);
+  if( ret != 0 ) goto ERROR;
 
   *pos = p;
   return irep;
+
+ ERROR:
+  mrbc_raise(vm, E_BYTECODE_ERROR, NULL);
+  mrbc_irep_free(irep);
+  return NULL;
 }
 
 
@@ -216,6 +585,10 @@ static mrbc_irep * load_irep_0(struct VM *vm, const uint8_t **pos)
   int i;
   for( i = 0; i < irep->rlen; i++ ) {
     irep->reps[i] = load_irep_0(vm, pos);
+    if( !irep->reps[i] ) {
+      mrbc_irep_free(irep);
+      return NULL;
+    }
   }
 
   return irep;
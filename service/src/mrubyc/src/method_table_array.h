@@ -3,74 +3,240 @@
 struct RClass *mrbc_init_class_array(struct VM *vm)
 {
   static const mrbc_sym method_symbols[] = {
-    MRBC_SYMID_PLUS,
-    MRBC_SYMID_LT_LT,
-    MRBC_SYMID_BL_BR,
-    MRBC_SYMID_BL_BR_EQ,
+    MRBC_SYMID_max,
+    -1,
     MRBC_SYMID_at,
-    MRBC_SYMID_clear,
-    MRBC_SYMID_count,
-    MRBC_SYMID_delete_at,
+    -1,
+    -1,
+    MRBC_SYMID_new,
+    MRBC_SYMID_min,
+    -1,
     MRBC_SYMID_dup,
+    MRBC_SYMID_each,
     MRBC_SYMID_empty_Q,
-    MRBC_SYMID_first,
     MRBC_SYMID_include_Q,
-    MRBC_SYMID_index,
+    MRBC_SYMID_each_with_index,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    MRBC_SYMID_count,
+    -1,
+    MRBC_SYMID_clear,
+    -1,
+    -1,
+    MRBC_SYMID_sort_E,
+#if MRBC_USE_STRING
+    MRBC_SYMID_join,
+#else
+    -1,
+#endif
+    -1,
+    MRBC_SYMID_BL_BR,
+    -1,
+    -1,
+    -1,
+    -1,
+    MRBC_SYMID_delete_at,
+    MRBC_SYMID_sort,
+    MRBC_SYMID_pop,
+    -1,
+    MRBC_SYMID_unshift,
+    -1,
+    -1,
+    -1,
+    MRBC_SYMID_map_E,
+    -1,
+    -1,
+    -1,
+    -1,
 #if MRBC_USE_STRING
     MRBC_SYMID_inspect,
+#else
+    -1,
 #endif
+    -1,
+    -1,
+    -1,
 #if MRBC_USE_STRING
-    MRBC_SYMID_join,
+    MRBC_SYMID_to_s,
+#else
+    -1,
 #endif
+    MRBC_SYMID_LT_LT,
+    -1,
+    MRBC_SYMID_shift,
+    -1,
+    MRBC_SYMID_collect_E,
+    -1,
+    -1,
+    MRBC_SYMID_collect,
+    -1,
+    -1,
+    -1,
+    -1,
+    MRBC_SYMID_PLUS,
+    MRBC_SYMID_BL_BR_EQ,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    MRBC_SYMID_index,
+    -1,
+    MRBC_SYMID_map,
+    -1,
+    -1,
+    -1,
+    MRBC_SYMID_each_index,
+    -1,
+    -1,
+    MRBC_SYMID_size,
+    MRBC_SYMID_minmax,
+    MRBC_SYMID_first,
+    -1,
     MRBC_SYMID_last,
+    -1,
+    -1,
+    -1,
+    -1,
     MRBC_SYMID_length,
-    MRBC_SYMID_max,
-    MRBC_SYMID_min,
-    MRBC_SYMID_minmax,
-    MRBC_SYMID_new,
-    MRBC_SYMID_pop,
+    -1,
+    -1,
+    -1,
+    -1,
     MRBC_SYMID_push,
-    MRBC_SYMID_shift,
-    MRBC_SYMID_size,
-#if MRBC_USE_STRING
-    MRBC_SYMID_to_s,
-#endif
-    MRBC_SYMID_unshift,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
   };
   static const mrbc_func_t method_functions[] = {
-    c_array_add,
-    c_array_push,
-    c_array_get,
-    c_array_set,
+    c_array_max,
+    0,
     c_array_get,
-    c_array_clear,
-    c_array_size,
-    c_array_delete_at,
+    0,
+    0,
+    c_array_new,
+    c_array_min,
+    0,
     c_array_dup,
+    c_array_each,
     c_array_empty,
-    c_array_first,
     c_array_include,
-    c_array_index,
+    c_array_each_with_index,
+    0,
+    0,
+    0,
+    0,
+    0,
+    c_array_size,
+    0,
+    c_array_clear,
+    0,
+    0,
+    c_array_sort_self,
+#if MRBC_USE_STRING
+    c_array_join,
+#else
+    0,
+#endif
+    0,
+    c_array_get,
+    0,
+    0,
+    0,
+    0,
+    c_array_delete_at,
+    c_array_sort,
+    c_array_pop,
+    0,
+    c_array_unshift,
+    0,
+    0,
+    0,
+    c_array_collect_self,
+    0,
+    0,
+    0,
+    0,
 #if MRBC_USE_STRING
     c_array_inspect,
+#else
+    0,
 #endif
+    0,
+    0,
+    0,
 #if MRBC_USE_STRING
-    c_array_join,
+    c_array_inspect,
+#else
+    0,
 #endif
-    c_array_last,
-    c_array_size,
-    c_array_max,
-    c_array_min,
-    c_array_minmax,
-    c_array_new,
-    c_array_pop,
     c_array_push,
+    0,
     c_array_shift,
+    0,
+    c_array_collect_self,
+    0,
+    0,
+    c_array_collect,
+    0,
+    0,
+    0,
+    0,
+    c_array_add,
+    c_array_set,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    c_array_index,
+    0,
+    c_array_collect,
+    0,
+    0,
+    0,
+    c_array_each_index,
+    0,
+    0,
     c_array_size,
-#if MRBC_USE_STRING
-    c_array_inspect,
-#endif
-    c_array_unshift,
+    c_array_minmax,
+    c_array_first,
+    0,
+    c_array_last,
+    0,
+    0,
+    0,
+    0,
+    c_array_size,
+    0,
+    0,
+    0,
+    0,
+    c_array_push,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
   };
 
   return mrbc_define_builtin_class("Array", mrbc_class_object, method_symbols, method_functions, sizeof(method_symbols)/sizeof(mrbc_sym) );
@@ -3,58 +3,134 @@
 struct RClass *mrbc_init_class_fixnum(struct VM *vm)
 {
   static const mrbc_sym method_symbols[] = {
-    MRBC_SYMID_MOD,
-    MRBC_SYMID_AND,
-    MRBC_SYMID_MUL_MUL,
-    MRBC_SYMID_PLUS_AT,
+    MRBC_SYMID_NEG,
     MRBC_SYMID_MINUS_AT,
     MRBC_SYMID_LT_LT,
-    MRBC_SYMID_GT_GT,
-    MRBC_SYMID_BL_BR,
-    MRBC_SYMID_XOR,
-    MRBC_SYMID_abs,
-#if MRBC_USE_STRING
-    MRBC_SYMID_chr,
+    -1,
+#if MRBC_USE_FLOAT
+    MRBC_SYMID_to_f,
+#else
+    -1,
 #endif
+    -1,
+    -1,
 #if MRBC_USE_STRING
     MRBC_SYMID_inspect,
+#else
+    -1,
 #endif
-#if MRBC_USE_FLOAT
-    MRBC_SYMID_to_f,
+    -1,
+#if MRBC_USE_STRING
+    MRBC_SYMID_chr,
+#else
+    -1,
 #endif
-    MRBC_SYMID_to_i,
+    MRBC_SYMID_AND,
 #if MRBC_USE_STRING
     MRBC_SYMID_to_s,
+#else
+    -1,
 #endif
+    -1,
+    -1,
+    MRBC_SYMID_abs,
+    -1,
+    -1,
+    MRBC_SYMID_times,
+    -1,
+    -1,
+    -1,
+    MRBC_SYMID_MUL_MUL,
+    MRBC_SYMID_MOD,
+    -1,
+    -1,
+    -1,
+    MRBC_SYMID_BL_BR,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    MRBC_SYMID_XOR,
+    MRBC_SYMID_to_i,
+    -1,
+    -1,
+    -1,
     MRBC_SYMID_OR,
-    MRBC_SYMID_NEG,
+    MRBC_SYMID_PLUS_AT,
+    MRBC_SYMID_GT_GT,
+    -1,
+    -1,
+    -1,
+    -1,
   };
   static const mrbc_func_t method_functions[] = {
-    c_fixnum_mod,
-    c_fixnum_and,
-    c_fixnum_power,
-    c_fixnum_positive,
+    c_fixnum_not,
     c_fixnum_negative,
     c_fixnum_lshift,
-    c_fixnum_rshift,
-    c_fixnum_bitref,
-    c_fixnum_xor,
-    c_fixnum_abs,
-#if MRBC_USE_STRING
-    c_fixnum_chr,
+    0,
+#if MRBC_USE_FLOAT
+    c_fixnum_to_f,
+#else
+    0,
 #endif
+    0,
+    0,
 #if MRBC_USE_STRING
     c_fixnum_to_s,
+#else
+    0,
 #endif
-#if MRBC_USE_FLOAT
-    c_fixnum_to_f,
+    0,
+#if MRBC_USE_STRING
+    c_fixnum_chr,
+#else
+    0,
 #endif
-    c_ineffect,
+    c_fixnum_and,
 #if MRBC_USE_STRING
     c_fixnum_to_s,
+#else
+    0,
 #endif
+    0,
+    0,
+    c_fixnum_abs,
+    0,
+    0,
+    c_fixnum_times,
+    0,
+    0,
+    0,
+    c_fixnum_power,
+    c_fixnum_mod,
+    0,
+    0,
+    0,
+    c_fixnum_bitref,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    c_fixnum_xor,
+    c_ineffect,
+    0,
+    0,
+    0,
     c_fixnum_or,
-    c_fixnum_not,
+    c_fixnum_positive,
+    c_fixnum_rshift,
+    0,
+    0,
+    0,
+    0,
   };
 
   return mrbc_define_builtin_class("Fixnum", mrbc_class_object, method_symbols, method_functions, sizeof(method_symbols)/sizeof(mrbc_sym) );
@@ -3,36 +3,72 @@
 struct RClass *mrbc_init_class_float(struct VM *vm)
 {
   static const mrbc_sym method_symbols[] = {
+    -1,
 #if MRBC_USE_MATH
     MRBC_SYMID_MUL_MUL,
+#else
+    -1,
 #endif
-    MRBC_SYMID_PLUS_AT,
     MRBC_SYMID_MINUS_AT,
-    MRBC_SYMID_abs,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
 #if MRBC_USE_STRING
     MRBC_SYMID_inspect,
+#else
+    -1,
 #endif
-    MRBC_SYMID_to_f,
-    MRBC_SYMID_to_i,
+    -1,
+    -1,
+    -1,
 #if MRBC_USE_STRING
     MRBC_SYMID_to_s,
+#else
+    -1,
 #endif
+    -1,
+    MRBC_SYMID_abs,
+    MRBC_SYMID_PLUS_AT,
+    MRBC_SYMID_to_i,
+    -1,
+    MRBC_SYMID_to_f,
+    -1,
   };
   static const mrbc_func_t method_functions[] = {
+    0,
 #if MRBC_USE_MATH
     c_float_power,
+#else
+    0,
 #endif
-    c_float_positive,
     c_float_negative,
-    c_float_abs,
+    0,
+    0,
+    0,
+    0,
+    0,
 #if MRBC_USE_STRING
     c_float_to_s,
+#else
+    0,
 #endif
-    c_ineffect,
-    c_float_to_i,
+    0,
+    0,
+    0,
 #if MRBC_USE_STRING
     c_float_to_s,
+#else
+    0,
 #endif
+    0,
+    c_float_abs,
+    c_float_positive,
+    c_float_to_i,
+    0,
+    c_ineffect,
+    0,
   };
 
   return mrbc_define_builtin_class("Float", mrbc_class_object, method_symbols, method_functions, sizeof(method_symbols)/sizeof(mrbc_sym) );
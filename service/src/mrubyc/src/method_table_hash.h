@@ -3,56 +3,154 @@
 struct RClass *mrbc_init_class_hash(struct VM *vm)
 {
   static const mrbc_sym method_symbols[] = {
-    MRBC_SYMID_BL_BR,
-    MRBC_SYMID_BL_BR_EQ,
-    MRBC_SYMID_clear,
-    MRBC_SYMID_count,
-    MRBC_SYMID_delete,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    MRBC_SYMID_new,
+    MRBC_SYMID_merge_E,
+    -1,
     MRBC_SYMID_dup,
+    MRBC_SYMID_each,
     MRBC_SYMID_empty_Q,
+    -1,
+    -1,
     MRBC_SYMID_has_key_Q,
+    MRBC_SYMID_size,
+    -1,
+    -1,
     MRBC_SYMID_has_value_Q,
 #if MRBC_USE_STRING
     MRBC_SYMID_inspect,
+#else
+    -1,
 #endif
+    -1,
+    MRBC_SYMID_clear,
     MRBC_SYMID_key,
-    MRBC_SYMID_keys,
-    MRBC_SYMID_length,
-    MRBC_SYMID_merge,
-    MRBC_SYMID_merge_E,
-    MRBC_SYMID_new,
-    MRBC_SYMID_size,
-    MRBC_SYMID_to_h,
 #if MRBC_USE_STRING
     MRBC_SYMID_to_s,
+#else
+    -1,
 #endif
+    MRBC_SYMID_length,
+    -1,
+    -1,
+    MRBC_SYMID_BL_BR,
+    -1,
+    MRBC_SYMID_merge,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
     MRBC_SYMID_values,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    MRBC_SYMID_to_h,
+    MRBC_SYMID_keys,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    MRBC_SYMID_count,
+    -1,
+    -1,
+    MRBC_SYMID_delete,
+    -1,
+    MRBC_SYMID_BL_BR_EQ,
+    -1,
+    -1,
   };
   static const mrbc_func_t method_functions[] = {
-    c_hash_get,
-    c_hash_set,
-    c_hash_clear,
-    c_hash_size,
-    c_hash_delete,
+    0,
+    0,
+    0,
+    0,
+    0,
+    c_hash_new,
+    c_hash_merge_self,
+    0,
     c_hash_dup,
+    c_hash_each,
     c_hash_empty,
+    0,
+    0,
     c_hash_has_key,
+    c_hash_size,
+    0,
+    0,
     c_hash_has_value,
 #if MRBC_USE_STRING
     c_hash_inspect,
+#else
+    0,
 #endif
+    0,
+    c_hash_clear,
     c_hash_key,
-    c_hash_keys,
-    c_hash_size,
-    c_hash_merge,
-    c_hash_merge_self,
-    c_hash_new,
-    c_hash_size,
-    c_ineffect,
 #if MRBC_USE_STRING
     c_hash_inspect,
+#else
+    0,
 #endif
+    c_hash_size,
+    0,
+    0,
+    c_hash_get,
+    0,
+    c_hash_merge,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
     c_hash_values,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    c_ineffect,
+    c_hash_keys,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    c_hash_size,
+    0,
+    0,
+    c_hash_delete,
+    0,
+    c_hash_set,
+    0,
+    0,
   };
 
   return mrbc_define_builtin_class("Hash", mrbc_class_object, method_symbols, method_functions, sizeof(method_symbols)/sizeof(mrbc_sym) );
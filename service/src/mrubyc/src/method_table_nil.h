@@ -3,31 +3,53 @@
 struct RClass *mrbc_init_class_nil(struct VM *vm)
 {
   static const mrbc_sym method_symbols[] = {
+    -1,
+    -1,
+    -1,
+    MRBC_SYMID_to_i,
+    MRBC_SYMID_to_h,
 #if MRBC_USE_STRING
     MRBC_SYMID_inspect,
+#else
+    -1,
 #endif
+    -1,
     MRBC_SYMID_to_a,
-#if MRBC_USE_FLOAT
-    MRBC_SYMID_to_f,
-#endif
-    MRBC_SYMID_to_h,
-    MRBC_SYMID_to_i,
+    -1,
 #if MRBC_USE_STRING
     MRBC_SYMID_to_s,
+#else
+    -1,
+#endif
+#if MRBC_USE_FLOAT
+    MRBC_SYMID_to_f,
+#else
+    -1,
 #endif
   };
   static const mrbc_func_t method_functions[] = {
+    0,
+    0,
+    0,
+    c_nil_to_i,
+    c_nil_to_h,
 #if MRBC_USE_STRING
     c_nil_inspect,
+#else
+    0,
 #endif
+    0,
     c_nil_to_a,
-#if MRBC_USE_FLOAT
-    c_nil_to_f,
-#endif
-    c_nil_to_h,
-    c_nil_to_i,
+    0,
 #if MRBC_USE_STRING
     c_nil_to_s,
+#else
+    0,
+#endif
+#if MRBC_USE_FLOAT
+    c_nil_to_f,
+#else
+    0,
 #endif
   };
 
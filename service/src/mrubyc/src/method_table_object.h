@@ -3,94 +3,232 @@
 struct RClass *mrbc_init_class_object(struct VM *vm)
 {
   static const mrbc_sym method_symbols[] = {
-    MRBC_SYMID_NOT,
-    MRBC_SYMID_NOT_EQ,
-    MRBC_SYMID_LT_EQ_GT,
-    MRBC_SYMID_EQ_EQ_EQ,
-    MRBC_SYMID_attr_accessor,
-    MRBC_SYMID_attr_reader,
-    MRBC_SYMID_block_given_Q,
-    MRBC_SYMID_class,
-    MRBC_SYMID_dup,
 #if MRBC_USE_STRING
-    MRBC_SYMID_inspect,
-#endif
-#if defined(MRBC_DEBUG)
-    MRBC_SYMID_instance_methods,
+    MRBC_SYMID_to_s,
+#else
+    -1,
 #endif
-#if defined(MRBC_DEBUG)
-    MRBC_SYMID_instance_variables,
-#endif
-    MRBC_SYMID_is_a_Q,
-    MRBC_SYMID_kind_of_Q,
+    -1,
+    -1,
 #if defined(MRBC_DEBUG)
 #if !defined(MRBC_ALLOC_LIBC)
     MRBC_SYMID_memory_statistics,
+#else
+    -1,
 #endif
+#else
+    -1,
 #endif
+    -1,
     MRBC_SYMID_new,
-    MRBC_SYMID_nil_Q,
+    -1,
+    -1,
+    MRBC_SYMID_dup,
+    MRBC_SYMID_raise,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
 #if defined(MRBC_DEBUG)
-    MRBC_SYMID_object_id,
+    MRBC_SYMID_instance_variables,
+#else
+    -1,
 #endif
-    MRBC_SYMID_p,
+    MRBC_SYMID_is_a_Q,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
     MRBC_SYMID_print,
+    -1,
+    -1,
+    -1,
+    -1,
+#if defined(MRBC_DEBUG)
+    MRBC_SYMID_instance_methods,
+#else
+    -1,
+#endif
+    -1,
+    -1,
 #if MRBC_USE_STRING
     MRBC_SYMID_printf,
+#else
+    -1,
 #endif
+    -1,
+    MRBC_SYMID_kind_of_Q,
+    MRBC_SYMID_attr_reader,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+#if defined(MRBC_DEBUG)
+    MRBC_SYMID_object_id,
+#else
+    -1,
+#endif
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    MRBC_SYMID_NOT,
+    MRBC_SYMID_EQ_EQ_EQ,
+    -1,
+    -1,
+    -1,
+    MRBC_SYMID_attr_accessor,
+    MRBC_SYMID_nil_Q,
+    -1,
+    -1,
+    MRBC_SYMID_block_given_Q,
+    -1,
+    -1,
+    MRBC_SYMID_class,
+    -1,
+    MRBC_SYMID_NOT_EQ,
+    -1,
+    -1,
+    -1,
     MRBC_SYMID_puts,
-    MRBC_SYMID_raise,
+    MRBC_SYMID_p,
+    -1,
+    -1,
+    -1,
 #if MRBC_USE_STRING
-    MRBC_SYMID_sprintf,
+    MRBC_SYMID_inspect,
+#else
+    -1,
 #endif
+    -1,
 #if MRBC_USE_STRING
-    MRBC_SYMID_to_s,
+    MRBC_SYMID_sprintf,
+#else
+    -1,
 #endif
+    MRBC_SYMID_LT_EQ_GT,
   };
   static const mrbc_func_t method_functions[] = {
-    c_object_not,
-    c_object_neq,
-    c_object_compare,
-    c_object_equal3,
-    c_object_attr_accessor,
-    c_object_attr_reader,
-    c_object_block_given,
-    c_object_class,
-    c_object_dup,
 #if MRBC_USE_STRING
     c_object_to_s,
+#else
+    0,
 #endif
-#if defined(MRBC_DEBUG)
-    c_object_instance_methods,
-#endif
-#if defined(MRBC_DEBUG)
-    c_object_instance_variables,
-#endif
-    c_object_kind_of,
-    c_object_kind_of,
+    0,
+    0,
 #if defined(MRBC_DEBUG)
 #if !defined(MRBC_ALLOC_LIBC)
     c_object_memory_statistics,
+#else
+    0,
 #endif
+#else
+    0,
 #endif
+    0,
     c_object_new,
-    c_object_nil,
+    0,
+    0,
+    c_object_dup,
+    c_object_raise,
+    0,
+    0,
+    0,
+    0,
+    0,
 #if defined(MRBC_DEBUG)
-    c_object_object_id,
+    c_object_instance_variables,
+#else
+    0,
 #endif
-    c_object_p,
+    c_object_kind_of,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
     c_object_print,
+    0,
+    0,
+    0,
+    0,
+#if defined(MRBC_DEBUG)
+    c_object_instance_methods,
+#else
+    0,
+#endif
+    0,
+    0,
 #if MRBC_USE_STRING
     c_object_printf,
+#else
+    0,
 #endif
+    0,
+    c_object_kind_of,
+    c_object_attr_reader,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+#if defined(MRBC_DEBUG)
+    c_object_object_id,
+#else
+    0,
+#endif
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    c_object_not,
+    c_object_equal3,
+    0,
+    0,
+    0,
+    c_object_attr_accessor,
+    c_object_nil,
+    0,
+    0,
+    c_object_block_given,
+    0,
+    0,
+    c_object_class,
+    0,
+    c_object_neq,
+    0,
+    0,
+    0,
     c_object_puts,
-    c_object_raise,
+    c_object_p,
+    0,
+    0,
+    0,
 #if MRBC_USE_STRING
-    c_object_sprintf,
+    c_object_to_s,
+#else
+    0,
 #endif
+    0,
 #if MRBC_USE_STRING
-    c_object_to_s,
+    c_object_sprintf,
+#else
+    0,
 #endif
+    c_object_compare,
   };
 
   return mrbc_define_builtin_class("Object", 0, method_symbols, method_functions, sizeof(method_symbols)/sizeof(mrbc_sym) );
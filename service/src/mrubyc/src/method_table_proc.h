@@ -3,24 +3,34 @@
 struct RClass *mrbc_init_class_proc(struct VM *vm)
 {
   static const mrbc_sym method_symbols[] = {
-    MRBC_SYMID_call,
-#if MRBC_USE_STRING
-    MRBC_SYMID_inspect,
-#endif
     MRBC_SYMID_new,
+    -1,
 #if MRBC_USE_STRING
     MRBC_SYMID_to_s,
+#else
+    -1,
+#endif
+#if MRBC_USE_STRING
+    MRBC_SYMID_inspect,
+#else
+    -1,
 #endif
+    MRBC_SYMID_call,
   };
   static const mrbc_func_t method_functions[] = {
-    c_proc_call,
+    c_proc_new,
+    0,
 #if MRBC_USE_STRING
     c_proc_to_s,
+#else
+    0,
 #endif
-    c_proc_new,
 #if MRBC_USE_STRING
     c_proc_to_s,
+#else
+    0,
 #endif
+    c_proc_call,
   };
 
   return mrbc_define_builtin_class("Proc", mrbc_class_object, method_symbols, method_functions, sizeof(method_symbols)/sizeof(mrbc_sym) );
@@ -3,28 +3,44 @@
 struct RClass *mrbc_init_class_range(struct VM *vm)
 {
   static const mrbc_sym method_symbols[] = {
-    MRBC_SYMID_EQ_EQ_EQ,
-    MRBC_SYMID_exclude_end_Q,
+    -1,
     MRBC_SYMID_first,
 #if MRBC_USE_STRING
-    MRBC_SYMID_inspect,
+    MRBC_SYMID_to_s,
+#else
+    -1,
 #endif
     MRBC_SYMID_last,
+    MRBC_SYMID_exclude_end_Q,
+    -1,
+    MRBC_SYMID_EQ_EQ_EQ,
+    -1,
 #if MRBC_USE_STRING
-    MRBC_SYMID_to_s,
+    MRBC_SYMID_inspect,
+#else
+    -1,
 #endif
+    MRBC_SYMID_each,
   };
   static const mrbc_func_t method_functions[] = {
-    c_range_equal3,
-    c_range_exclude_end,
+    0,
     c_range_first,
 #if MRBC_USE_STRING
     c_range_inspect,
+#else
+    0,
 #endif
     c_range_last,
+    c_range_exclude_end,
+    0,
+    c_range_equal3,
+    0,
 #if MRBC_USE_STRING
     c_range_inspect,
+#else
+    0,
 #endif
+    c_range_each,
   };
 
   return mrbc_define_builtin_class("Range", mrbc_class_object, method_symbols, method_functions, sizeof(method_symbols)/sizeof(mrbc_sym) );
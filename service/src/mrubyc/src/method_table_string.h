@@ -3,84 +3,228 @@
 struct RClass *mrbc_init_class_string(struct VM *vm)
 {
   static const mrbc_sym method_symbols[] = {
+    -1,
+    MRBC_SYMID_each_byte,
+    -1,
+    MRBC_SYMID_slice_E,
+    -1,
+    MRBC_SYMID_new,
+    -1,
+    MRBC_SYMID_rstrip_E,
+    MRBC_SYMID_dup,
+    MRBC_SYMID_chomp,
+    MRBC_SYMID_empty_Q,
+    MRBC_SYMID_include_Q,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    MRBC_SYMID_intern,
+    -1,
+    -1,
+    MRBC_SYMID_clear,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    MRBC_SYMID_BL_BR,
+    MRBC_SYMID_end_with_Q,
+    -1,
+    MRBC_SYMID_b,
+    MRBC_SYMID_to_sym,
+    -1,
+    -1,
+    -1,
+    MRBC_SYMID_start_with_Q,
+    -1,
+    MRBC_SYMID_to_i,
+    -1,
     MRBC_SYMID_MUL,
-    MRBC_SYMID_PLUS,
+    -1,
+    -1,
+    MRBC_SYMID_strip_E,
+    MRBC_SYMID_inspect,
+    -1,
+    MRBC_SYMID_ord,
+    -1,
+    MRBC_SYMID_to_s,
+    -1,
+    MRBC_SYMID_strip,
     MRBC_SYMID_LT_LT,
-    MRBC_SYMID_BL_BR,
+    MRBC_SYMID_tr_E,
+    MRBC_SYMID_each_char,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    MRBC_SYMID_PLUS,
     MRBC_SYMID_BL_BR_EQ,
-    MRBC_SYMID_b,
-    MRBC_SYMID_chomp,
+    -1,
+    -1,
     MRBC_SYMID_chomp_E,
-    MRBC_SYMID_clear,
-    MRBC_SYMID_dup,
-    MRBC_SYMID_empty_Q,
-    MRBC_SYMID_end_with_Q,
-    MRBC_SYMID_getbyte,
-    MRBC_SYMID_include_Q,
+    MRBC_SYMID_lstrip,
+    -1,
+    -1,
+    -1,
     MRBC_SYMID_index,
-    MRBC_SYMID_inspect,
-    MRBC_SYMID_intern,
+    -1,
+    -1,
+    MRBC_SYMID_tr,
+    -1,
+    -1,
+    -1,
+    MRBC_SYMID_split,
+    -1,
+    MRBC_SYMID_size,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
     MRBC_SYMID_length,
-    MRBC_SYMID_lstrip,
-    MRBC_SYMID_lstrip_E,
-    MRBC_SYMID_new,
-    MRBC_SYMID_ord,
+    -1,
+    MRBC_SYMID_getbyte,
+    -1,
+    -1,
+    -1,
+    -1,
     MRBC_SYMID_rstrip,
-    MRBC_SYMID_rstrip_E,
-    MRBC_SYMID_size,
-    MRBC_SYMID_slice_E,
-    MRBC_SYMID_split,
-    MRBC_SYMID_start_with_Q,
-    MRBC_SYMID_strip,
-    MRBC_SYMID_strip_E,
+    -1,
+    -1,
 #if MRBC_USE_FLOAT
     MRBC_SYMID_to_f,
+#else
+    -1,
 #endif
-    MRBC_SYMID_to_i,
-    MRBC_SYMID_to_s,
-    MRBC_SYMID_to_sym,
-    MRBC_SYMID_tr,
-    MRBC_SYMID_tr_E,
+    MRBC_SYMID_lstrip_E,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
+    -1,
   };
   static const mrbc_func_t method_functions[] = {
+    0,
+    c_string_each_byte,
+    0,
+    c_string_slice_self,
+    0,
+    c_string_new,
+    0,
+    c_string_rstrip_self,
+    c_string_dup,
+    c_string_chomp,
+    c_string_empty,
+    c_string_include,
+    0,
+    0,
+    0,
+    0,
+    0,
+    c_string_to_sym,
+    0,
+    0,
+    c_string_clear,
+    0,
+    0,
+    0,
+    0,
+    0,
+    c_string_slice,
+    c_string_end_with,
+    0,
+    c_ineffect,
+    c_string_to_sym,
+    0,
+    0,
+    0,
+    c_string_start_with,
+    0,
+    c_string_to_i,
+    0,
     c_string_mul,
-    c_string_add,
+    0,
+    0,
+    c_string_strip_self,
+    c_string_inspect,
+    0,
+    c_string_ord,
+    0,
+    c_ineffect,
+    0,
+    c_string_strip,
     c_string_append,
-    c_string_slice,
+    c_string_tr_self,
+    c_string_each_char,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    c_string_add,
     c_string_insert,
-    c_ineffect,
-    c_string_chomp,
+    0,
+    0,
     c_string_chomp_self,
-    c_string_clear,
-    c_string_dup,
-    c_string_empty,
-    c_string_end_with,
-    c_string_getbyte,
-    c_string_include,
+    c_string_lstrip,
+    0,
+    0,
+    0,
     c_string_index,
-    c_string_inspect,
-    c_string_to_sym,
+    0,
+    0,
+    c_string_tr,
+    0,
+    0,
+    0,
+    c_string_split,
+    0,
     c_string_size,
-    c_string_lstrip,
-    c_string_lstrip_self,
-    c_string_new,
-    c_string_ord,
-    c_string_rstrip,
-    c_string_rstrip_self,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
     c_string_size,
-    c_string_slice_self,
-    c_string_split,
-    c_string_start_with,
-    c_string_strip,
-    c_string_strip_self,
+    0,
+    c_string_getbyte,
+    0,
+    0,
+    0,
+    0,
+    c_string_rstrip,
+    0,
+    0,
 #if MRBC_USE_FLOAT
     c_string_to_f,
+#else
+    0,
 #endif
-    c_string_to_i,
-    c_ineffect,
-    c_string_to_sym,
-    c_string_tr,
-    c_string_tr_self,
+    c_string_lstrip_self,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
   };
 
   return mrbc_define_builtin_class("String", mrbc_class_object, method_symbols, method_functions, sizeof(method_symbols)/sizeof(mrbc_sym) );
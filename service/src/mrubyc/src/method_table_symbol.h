@@ -3,30 +3,54 @@
 struct RClass *mrbc_init_class_symbol(struct VM *vm)
 {
   static const mrbc_sym method_symbols[] = {
-    MRBC_SYMID_all_symbols,
+    -1,
+    -1,
+    -1,
+    -1,
 #if MRBC_USE_STRING
     MRBC_SYMID_id2name,
+#else
+    -1,
 #endif
 #if MRBC_USE_STRING
     MRBC_SYMID_inspect,
+#else
+    -1,
 #endif
+    -1,
+    -1,
+    MRBC_SYMID_to_sym,
 #if MRBC_USE_STRING
     MRBC_SYMID_to_s,
+#else
+    -1,
 #endif
-    MRBC_SYMID_to_sym,
+    MRBC_SYMID_all_symbols,
   };
   static const mrbc_func_t method_functions[] = {
-    c_all_symbols,
+    0,
+    0,
+    0,
+    0,
 #if MRBC_USE_STRING
     c_to_s,
+#else
+    0,
 #endif
 #if MRBC_USE_STRING
     c_inspect,
+#else
+    0,
 #endif
+    0,
+    0,
+    c_ineffect,
 #if MRBC_USE_STRING
     c_to_s,
+#else
+    0,
 #endif
-    c_ineffect,
+    c_all_symbols,
   };
 
   return mrbc_define_builtin_class("Symbol", mrbc_class_object, method_symbols, method_functions, sizeof(method_symbols)/sizeof(mrbc_sym) );
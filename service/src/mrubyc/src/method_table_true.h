@@ -3,19 +3,29 @@
 struct RClass *mrbc_init_class_true(struct VM *vm)
 {
   static const mrbc_sym method_symbols[] = {
+    -1,
 #if MRBC_USE_STRING
     MRBC_SYMID_inspect,
+#else
+    -1,
 #endif
 #if MRBC_USE_STRING
     MRBC_SYMID_to_s,
+#else
+    -1,
 #endif
   };
   static const mrbc_func_t method_functions[] = {
+    0,
 #if MRBC_USE_STRING
     c_true_to_s,
+#else
+    0,
 #endif
 #if MRBC_USE_STRING
     c_true_to_s,
+#else
+    0,
 #endif
   };
 
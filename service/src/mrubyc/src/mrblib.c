@@ -11,155 +11,45 @@ __attribute__((aligned(4)))
 __declspec(align(4))
 #endif
 mrblib_bytecode[] = {
-0x52,0x49,0x54,0x45,0x30,0x30,0x30,0x36,0xe4,0xcd,0x00,0x00,0x09,0x6b,0x4d,0x41,
-0x54,0x5a,0x30,0x30,0x30,0x30,0x49,0x52,0x45,0x50,0x00,0x00,0x09,0x4d,0x30,0x30,
-0x30,0x32,0x00,0x00,0x01,0xa4,0x00,0x01,0x00,0x03,0x00,0x06,0x00,0x00,0x00,0x4b,
+0x52,0x49,0x54,0x45,0x30,0x30,0x30,0x36,0xce,0xfb,0x00,0x00,0x02,0x8c,0x4d,0x41,
+0x54,0x5a,0x30,0x30,0x30,0x30,0x49,0x52,0x45,0x50,0x00,0x00,0x02,0x6e,0x30,0x30,
+0x30,0x32,0x00,0x00,0x01,0x13,0x00,0x01,0x00,0x03,0x00,0x02,0x00,0x00,0x00,0x29,
 0x0f,0x01,0x0f,0x02,0x5a,0x01,0x00,0x5c,0x01,0x00,0x4f,0x01,0x00,0x1c,0x01,0x01,
-0x4f,0x01,0x01,0x1c,0x01,0x02,0x0f,0x01,0x0f,0x02,0x5a,0x01,0x03,0x5c,0x01,0x01,
-0x0f,0x01,0x0f,0x02,0x5a,0x01,0x04,0x5c,0x01,0x02,0x0f,0x01,0x0f,0x02,0x5a,0x01,
-0x05,0x5c,0x01,0x03,0x0f,0x01,0x0f,0x02,0x5a,0x01,0x06,0x5c,0x01,0x04,0x0f,0x01,
-0x0f,0x02,0x5a,0x01,0x07,0x5c,0x01,0x05,0x37,0x01,0x67,0x00,0x00,0x00,0x02,0x00,
-0x00,0x03,0x31,0x2e,0x39,0x00,0x00,0x03,0x32,0x2e,0x31,0x00,0x00,0x00,0x08,0x00,
-0x05,0x41,0x72,0x72,0x61,0x79,0x00,0x00,0x0c,0x52,0x55,0x42,0x59,0x5f,0x56,0x45,
-0x52,0x53,0x49,0x4f,0x4e,0x00,0x00,0x0e,0x4d,0x52,0x55,0x42,0x59,0x43,0x5f,0x56,
-0x45,0x52,0x53,0x49,0x4f,0x4e,0x00,0x00,0x04,0x48,0x61,0x73,0x68,0x00,0x00,0x06,
-0x46,0x69,0x78,0x6e,0x75,0x6d,0x00,0x00,0x06,0x4f,0x62,0x6a,0x65,0x63,0x74,0x00,
-0x00,0x05,0x52,0x61,0x6e,0x67,0x65,0x00,0x00,0x06,0x53,0x74,0x72,0x69,0x6e,0x67,
-0x00,0x00,0x00,0x01,0xfc,0x00,0x01,0x00,0x03,0x00,0x0a,0x00,0x00,0x00,0x5b,0x00,
-0x61,0x01,0x56,0x02,0x00,0x5d,0x01,0x00,0x5e,0x01,0x00,0x61,0x01,0x56,0x02,0x01,
-0x5d,0x01,0x02,0x5e,0x03,0x02,0x61,0x01,0x56,0x02,0x02,0x5d,0x01,0x04,0x61,0x01,
-0x56,0x02,0x03,0x5d,0x01,0x05,0x61,0x01,0x56,0x02,0x04,0x5d,0x01,0x06,0x61,0x01,
-0x56,0x02,0x05,0x5d,0x01,0x07,0x61,0x01,0x56,0x02,0x06,0x5d,0x01,0x08,0x61,0x01,
-0x56,0x02,0x07,0x5d,0x01,0x09,0x61,0x01,0x56,0x02,0x08,0x5d,0x01,0x0a,0x61,0x01,
-0x56,0x02,0x09,0x5d,0x01,0x0b,0x0e,0x01,0x0b,0x37,0x01,0x00,0x00,0x00,0x00,0x00,
-0x00,0x00,0x0c,0x00,0x07,0x63,0x6f,0x6c,0x6c,0x65,0x63,0x74,0x00,0x00,0x03,0x6d,
-0x61,0x70,0x00,0x00,0x08,0x63,0x6f,0x6c,0x6c,0x65,0x63,0x74,0x21,0x00,0x00,0x04,
-0x6d,0x61,0x70,0x21,0x00,0x00,0x09,0x64,0x65,0x6c,0x65,0x74,0x65,0x5f,0x69,0x66,
-0x00,0x00,0x04,0x65,0x61,0x63,0x68,0x00,0x00,0x0a,0x65,0x61,0x63,0x68,0x5f,0x69,
-0x6e,0x64,0x65,0x78,0x00,0x00,0x0f,0x65,0x61,0x63,0x68,0x5f,0x77,0x69,0x74,0x68,
-0x5f,0x69,0x6e,0x64,0x65,0x78,0x00,0x00,0x07,0x72,0x65,0x6a,0x65,0x63,0x74,0x21,
-0x00,0x00,0x06,0x72,0x65,0x6a,0x65,0x63,0x74,0x00,0x00,0x05,0x73,0x6f,0x72,0x74,
-0x21,0x00,0x00,0x04,0x73,0x6f,0x72,0x74,0x00,0x00,0x00,0x01,0x51,0x00,0x04,0x00,
-0x09,0x00,0x00,0x00,0x00,0x00,0x47,0x00,0x33,0x00,0x00,0x00,0x06,0x02,0x46,0x04,
-0x00,0x01,0x03,0x04,0x21,0x00,0x36,0x10,0x05,0x01,0x06,0x02,0x2e,0x05,0x00,0x01,
-0x3a,0x04,0x00,0x00,0x2e,0x04,0x01,0x01,0x01,0x05,0x03,0x01,0x06,0x02,0x01,0x07,
-0x04,0x2e,0x05,0x02,0x02,0x01,0x04,0x02,0x3c,0x04,0x01,0x01,0x02,0x04,0x01,0x04,
-0x02,0x10,0x05,0x2e,0x05,0x03,0x00,0x42,0x04,0x22,0x04,0x00,0x0f,0x37,0x03,0x00,
-0x00,0x00,0x00,0x00,0x00,0x00,0x04,0x00,0x02,0x5b,0x5d,0x00,0x00,0x04,0x63,0x61,
-0x6c,0x6c,0x00,0x00,0x03,0x5b,0x5d,0x3d,0x00,0x00,0x06,0x6c,0x65,0x6e,0x67,0x74,
-0x68,0x00,0x00,0x00,0x01,0x3d,0x00,0x03,0x00,0x08,0x00,0x00,0x00,0x00,0x00,0x42,
-0x33,0x00,0x00,0x00,0x06,0x02,0x21,0x00,0x2f,0x10,0x04,0x01,0x05,0x02,0x2e,0x04,
-0x00,0x01,0x3a,0x03,0x00,0x00,0x2e,0x03,0x01,0x01,0x10,0x04,0x01,0x05,0x02,0x01,
-0x06,0x03,0x2e,0x04,0x02,0x02,0x01,0x03,0x02,0x3c,0x03,0x01,0x01,0x02,0x03,0x01,
-0x03,0x02,0x10,0x04,0x2e,0x04,0x03,0x00,0x42,0x03,0x22,0x03,0x00,0x09,0x10,0x03,
-0x37,0x03,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x04,0x00,0x02,0x5b,0x5d,0x00,0x00,
-0x04,0x63,0x61,0x6c,0x6c,0x00,0x00,0x03,0x5b,0x5d,0x3d,0x00,0x00,0x06,0x6c,0x65,
-0x6e,0x67,0x74,0x68,0x00,0x00,0x00,0x01,0x53,0x00,0x03,0x00,0x07,0x00,0x00,0x00,
-0x00,0x00,0x46,0x00,0x33,0x00,0x00,0x00,0x06,0x02,0x21,0x00,0x33,0x10,0x04,0x01,
-0x05,0x02,0x2e,0x04,0x00,0x01,0x3a,0x03,0x00,0x00,0x2e,0x03,0x01,0x01,0x23,0x03,
-0x00,0x2a,0x10,0x03,0x01,0x04,0x02,0x2e,0x03,0x02,0x01,0x21,0x00,0x33,0x01,0x03,
-0x02,0x3c,0x03,0x01,0x01,0x02,0x03,0x01,0x03,0x02,0x10,0x04,0x2e,0x04,0x03,0x00,
-0x42,0x03,0x22,0x03,0x00,0x09,0x10,0x03,0x37,0x03,0x00,0x00,0x00,0x00,0x00,0x00,
-0x00,0x04,0x00,0x02,0x5b,0x5d,0x00,0x00,0x04,0x63,0x61,0x6c,0x6c,0x00,0x00,0x09,
-0x64,0x65,0x6c,0x65,0x74,0x65,0x5f,0x61,0x74,0x00,0x00,0x06,0x6c,0x65,0x6e,0x67,
-0x74,0x68,0x00,0x00,0x00,0x01,0x07,0x00,0x03,0x00,0x07,0x00,0x00,0x00,0x00,0x00,
-0x36,0x00,0x00,0x00,0x33,0x00,0x00,0x00,0x06,0x02,0x21,0x00,0x23,0x10,0x04,0x01,
-0x05,0x02,0x2e,0x04,0x00,0x01,0x3a,0x03,0x00,0x00,0x2e,0x03,0x01,0x01,0x01,0x03,
-0x02,0x3c,0x03,0x01,0x01,0x02,0x03,0x01,0x03,0x02,0x10,0x04,0x2e,0x04,0x02,0x00,
-0x42,0x03,0x22,0x03,0x00,0x09,0x10,0x03,0x37,0x03,0x00,0x00,0x00,0x00,0x00,0x00,
-0x00,0x03,0x00,0x02,0x5b,0x5d,0x00,0x00,0x04,0x63,0x61,0x6c,0x6c,0x00,0x00,0x06,
-0x6c,0x65,0x6e,0x67,0x74,0x68,0x00,0x00,0x00,0x00,0xea,0x00,0x03,0x00,0x06,0x00,
-0x00,0x00,0x00,0x00,0x30,0x00,0x00,0x00,0x33,0x00,0x00,0x00,0x06,0x02,0x21,0x00,
-0x1d,0x01,0x04,0x02,0x3a,0x03,0x00,0x00,0x2e,0x03,0x00,0x01,0x01,0x03,0x02,0x3c,
-0x03,0x01,0x01,0x02,0x03,0x01,0x03,0x02,0x10,0x04,0x2e,0x04,0x01,0x00,0x42,0x03,
-0x22,0x03,0x00,0x09,0x10,0x03,0x37,0x03,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x02,
-0x00,0x04,0x63,0x61,0x6c,0x6c,0x00,0x00,0x06,0x6c,0x65,0x6e,0x67,0x74,0x68,0x00,
-0x00,0x00,0x01,0x13,0x00,0x03,0x00,0x07,0x00,0x00,0x00,0x00,0x00,0x39,0x00,0x00,
-0x33,0x00,0x00,0x00,0x06,0x02,0x21,0x00,0x26,0x10,0x04,0x01,0x05,0x02,0x2e,0x04,
-0x00,0x01,0x01,0x05,0x02,0x3a,0x03,0x00,0x00,0x2e,0x03,0x01,0x02,0x01,0x03,0x02,
-0x3c,0x03,0x01,0x01,0x02,0x03,0x01,0x03,0x02,0x10,0x04,0x2e,0x04,0x02,0x00,0x42,
-0x03,0x22,0x03,0x00,0x09,0x10,0x03,0x37,0x03,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-0x03,0x00,0x02,0x5b,0x5d,0x00,0x00,0x04,0x63,0x61,0x6c,0x6c,0x00,0x00,0x06,0x6c,
-0x65,0x6e,0x67,0x74,0x68,0x00,0x00,0x00,0x00,0xe7,0x00,0x03,0x00,0x06,0x00,0x00,
-0x00,0x00,0x00,0x2e,0x33,0x00,0x00,0x01,0x10,0x03,0x2e,0x03,0x00,0x00,0x01,0x02,
-0x03,0x10,0x03,0x01,0x04,0x01,0x2f,0x03,0x01,0x00,0x01,0x03,0x02,0x10,0x04,0x2e,
-0x04,0x00,0x00,0x41,0x03,0x23,0x03,0x00,0x2a,0x0f,0x03,0x21,0x00,0x2c,0x10,0x03,
-0x37,0x03,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x06,0x6c,0x65,0x6e,0x67,
-0x74,0x68,0x00,0x00,0x09,0x64,0x65,0x6c,0x65,0x74,0x65,0x5f,0x69,0x66,0x00,0x00,
-0x00,0x00,0x78,0x00,0x02,0x00,0x04,0x00,0x00,0x00,0x00,0x00,0x13,0x00,0x00,0x00,
-0x33,0x00,0x00,0x01,0x10,0x02,0x2e,0x02,0x00,0x00,0x01,0x03,0x01,0x2f,0x02,0x01,
-0x00,0x37,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x03,0x64,0x75,0x70,
-0x00,0x00,0x09,0x64,0x65,0x6c,0x65,0x74,0x65,0x5f,0x69,0x66,0x00,0x00,0x00,0x02,
-0xf5,0x00,0x07,0x00,0x0c,0x00,0x00,0x00,0x00,0x00,0xb0,0x00,0x33,0x00,0x00,0x01,
-0x10,0x07,0x2e,0x07,0x00,0x00,0x3e,0x07,0x01,0x01,0x02,0x07,0x06,0x03,0x21,0x00,
-0xa0,0x01,0x07,0x03,0x01,0x04,0x07,0x21,0x00,0x8b,0x01,0x07,0x04,0x3c,0x07,0x01,
-0x01,0x04,0x07,0x10,0x07,0x01,0x08,0x03,0x2e,0x07,0x01,0x01,0x01,0x05,0x07,0x10,
-0x07,0x01,0x08,0x04,0x2e,0x07,0x01,0x01,0x01,0x06,0x07,0x23,0x01,0x00,0x5e,0x01,
-0x07,0x01,0x01,0x08,0x05,0x01,0x09,0x06,0x2e,0x07,0x02,0x02,0x06,0x08,0x43,0x07,
-0x23,0x07,0x00,0x5b,0x21,0x00,0x1b,0x21,0x00,0x6d,0x01,0x07,0x05,0x01,0x08,0x06,
-0x43,0x07,0x23,0x07,0x00,0x6d,0x21,0x00,0x1b,0x01,0x07,0x06,0x10,0x08,0x01,0x09,
-0x03,0x01,0x0a,0x07,0x2e,0x08,0x03,0x02,0x01,0x07,0x05,0x10,0x08,0x01,0x09,0x04,
-0x01,0x0a,0x07,0x2e,0x08,0x03,0x02,0x01,0x07,0x04,0x01,0x08,0x02,0x42,0x07,0x22,
-0x07,0x00,0x1e,0x01,0x07,0x03,0x3c,0x07,0x01,0x01,0x03,0x07,0x01,0x07,0x03,0x01,
-0x08,0x02,0x42,0x07,0x22,0x07,0x00,0x15,0x10,0x07,0x37,0x07,0x00,0x00,0x00,0x00,
-0x00,0x00,0x00,0x04,0x00,0x06,0x6c,0x65,0x6e,0x67,0x74,0x68,0x00,0x00,0x02,0x5b,
-0x5d,0x00,0x00,0x04,0x63,0x61,0x6c,0x6c,0x00,0x00,0x03,0x5b,0x5d,0x3d,0x00,0x00,
-0x00,0x00,0x74,0x00,0x02,0x00,0x04,0x00,0x00,0x00,0x00,0x00,0x13,0x00,0x00,0x00,
-0x33,0x00,0x00,0x01,0x10,0x02,0x2e,0x02,0x00,0x00,0x01,0x03,0x01,0x2f,0x02,0x01,
-0x00,0x37,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x03,0x64,0x75,0x70,
-0x00,0x00,0x05,0x73,0x6f,0x72,0x74,0x21,0x00,0x00,0x00,0x00,0x55,0x00,0x01,0x00,
-0x03,0x00,0x01,0x00,0x00,0x00,0x0d,0x00,0x61,0x01,0x56,0x02,0x00,0x5d,0x01,0x00,
-0x0e,0x01,0x00,0x37,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x04,0x65,
-0x61,0x63,0x68,0x00,0x00,0x00,0x01,0x8a,0x00,0x06,0x00,0x0b,0x00,0x00,0x00,0x00,
-0x00,0x55,0x00,0x00,0x33,0x00,0x00,0x00,0x10,0x06,0x2e,0x06,0x00,0x00,0x01,0x02,
-0x06,0x10,0x06,0x2e,0x06,0x01,0x00,0x01,0x03,0x06,0x06,0x04,0x21,0x00,0x45,0x01,
-0x06,0x02,0x01,0x07,0x04,0x2e,0x06,0x02,0x01,0x01,0x05,0x06,0x01,0x07,0x05,0x10,
-0x08,0x01,0x09,0x05,0x2e,0x08,0x02,0x01,0x3a,0x06,0x00,0x00,0x2e,0x06,0x03,0x02,
-0x01,0x06,0x04,0x3c,0x06,0x01,0x01,0x04,0x06,0x01,0x06,0x04,0x01,0x07,0x03,0x42,
-0x06,0x22,0x06,0x00,0x1b,0x10,0x06,0x37,0x06,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-0x04,0x00,0x04,0x6b,0x65,0x79,0x73,0x00,0x00,0x06,0x6c,0x65,0x6e,0x67,0x74,0x68,
-0x00,0x00,0x02,0x5b,0x5d,0x00,0x00,0x04,0x63,0x61,0x6c,0x6c,0x00,0x00,0x00,0x00,
-0x56,0x00,0x01,0x00,0x03,0x00,0x01,0x00,0x00,0x00,0x0d,0x00,0x61,0x01,0x56,0x02,
-0x00,0x5d,0x01,0x00,0x0e,0x01,0x00,0x37,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-0x01,0x00,0x05,0x74,0x69,0x6d,0x65,0x73,0x00,0x00,0x00,0x00,0xd1,0x00,0x03,0x00,
-0x06,0x00,0x00,0x00,0x00,0x00,0x2c,0x00,0x33,0x00,0x00,0x00,0x06,0x02,0x21,0x00,
-0x1d,0x01,0x04,0x02,0x3a,0x03,0x00,0x00,0x2e,0x03,0x00,0x01,0x01,0x03,0x02,0x3c,
-0x03,0x01,0x01,0x02,0x03,0x01,0x03,0x02,0x10,0x04,0x42,0x03,0x22,0x03,0x00,0x09,
-0x10,0x03,0x37,0x03,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x04,0x63,0x61,
-0x6c,0x6c,0x00,0x00,0x00,0x00,0x55,0x00,0x01,0x00,0x03,0x00,0x01,0x00,0x00,0x00,
-0x0d,0x00,0x00,0x00,0x61,0x01,0x56,0x02,0x00,0x5d,0x01,0x00,0x0e,0x01,0x00,0x37,
-0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x04,0x6c,0x6f,0x6f,0x70,0x00,
-0x00,0x00,0x00,0x85,0x00,0x02,0x00,0x04,0x00,0x00,0x00,0x00,0x00,0x19,0x00,0x00,
-0x33,0x00,0x00,0x00,0x21,0x00,0x0f,0x3a,0x02,0x00,0x00,0x2e,0x02,0x00,0x00,0x11,
-0x02,0x22,0x02,0x00,0x07,0x0f,0x02,0x37,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-0x01,0x00,0x04,0x63,0x61,0x6c,0x6c,0x00,0x00,0x00,0x00,0x55,0x00,0x01,0x00,0x03,
-0x00,0x01,0x00,0x00,0x00,0x0d,0x00,0x00,0x61,0x01,0x56,0x02,0x00,0x5d,0x01,0x00,
-0x0e,0x01,0x00,0x37,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x04,0x65,
-0x61,0x63,0x68,0x00,0x00,0x00,0x01,0x7f,0x00,0x04,0x00,0x07,0x00,0x00,0x00,0x00,
-0x00,0x50,0x00,0x00,0x33,0x00,0x00,0x00,0x10,0x04,0x2e,0x04,0x00,0x00,0x01,0x02,
-0x04,0x10,0x04,0x2e,0x04,0x01,0x00,0x22,0x04,0x00,0x20,0x01,0x04,0x02,0x3c,0x04,
-0x01,0x01,0x02,0x04,0x10,0x04,0x2e,0x04,0x02,0x00,0x01,0x03,0x04,0x21,0x00,0x40,
-0x01,0x05,0x03,0x3a,0x04,0x00,0x00,0x2e,0x04,0x03,0x01,0x01,0x04,0x03,0x3c,0x04,
-0x01,0x01,0x03,0x04,0x01,0x04,0x03,0x01,0x05,0x02,0x42,0x04,0x22,0x04,0x00,0x2c,
-0x10,0x04,0x37,0x04,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x04,0x00,0x04,0x6c,0x61,
-0x73,0x74,0x00,0x00,0x0c,0x65,0x78,0x63,0x6c,0x75,0x64,0x65,0x5f,0x65,0x6e,0x64,
-0x3f,0x00,0x00,0x05,0x66,0x69,0x72,0x73,0x74,0x00,0x00,0x04,0x63,0x61,0x6c,0x6c,
-0x00,0x00,0x00,0x00,0x86,0x00,0x01,0x00,0x03,0x00,0x02,0x00,0x00,0x00,0x15,0x00,
-0x61,0x01,0x56,0x02,0x00,0x5d,0x01,0x00,0x61,0x01,0x56,0x02,0x01,0x5d,0x01,0x01,
-0x0e,0x01,0x01,0x37,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x09,0x65,
-0x61,0x63,0x68,0x5f,0x62,0x79,0x74,0x65,0x00,0x00,0x09,0x65,0x61,0x63,0x68,0x5f,
-0x63,0x68,0x61,0x72,0x00,0x00,0x00,0x01,0x1d,0x00,0x03,0x00,0x07,0x00,0x00,0x00,
-0x00,0x00,0x3a,0x00,0x33,0x00,0x00,0x00,0x06,0x02,0x21,0x00,0x27,0x10,0x04,0x01,
-0x05,0x02,0x2e,0x04,0x00,0x01,0x2e,0x04,0x01,0x00,0x3a,0x03,0x00,0x00,0x2e,0x03,
-0x02,0x01,0x01,0x03,0x02,0x3c,0x03,0x01,0x01,0x02,0x03,0x01,0x03,0x02,0x10,0x04,
+0x4f,0x01,0x01,0x1c,0x01,0x02,0x4f,0x01,0x02,0x1c,0x01,0x03,0x0f,0x01,0x0f,0x02,
+0x5a,0x01,0x04,0x5c,0x01,0x01,0x37,0x01,0x67,0x00,0x00,0x00,0x03,0x00,0x00,0x03,
+0x31,0x2e,0x39,0x00,0x00,0x05,0x32,0x2e,0x31,0x2e,0x31,0x00,0x00,0x03,0x32,0x2e,
+0x31,0x00,0x00,0x00,0x05,0x00,0x05,0x41,0x72,0x72,0x61,0x79,0x00,0x00,0x0c,0x52,
+0x55,0x42,0x59,0x5f,0x56,0x45,0x52,0x53,0x49,0x4f,0x4e,0x00,0x00,0x0d,0x4d,0x52,
+0x55,0x42,0x59,0x5f,0x56,0x45,0x52,0x53,0x49,0x4f,0x4e,0x00,0x00,0x0e,0x4d,0x52,
+0x55,0x42,0x59,0x43,0x5f,0x56,0x45,0x52,0x53,0x49,0x4f,0x4e,0x00,0x00,0x06,0x4f,
+0x62,0x6a,0x65,0x63,0x74,0x00,0x00,0x00,0x00,0xad,0x00,0x01,0x00,0x03,0x00,0x03,
+0x00,0x00,0x00,0x1d,0x61,0x01,0x56,0x02,0x00,0x5d,0x01,0x00,0x61,0x01,0x56,0x02,
+0x01,0x5d,0x01,0x01,0x61,0x01,0x56,0x02,0x02,0x5d,0x01,0x02,0x0e,0x01,0x02,0x37,
+0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x03,0x00,0x09,0x64,0x65,0x6c,0x65,0x74,
+0x65,0x5f,0x69,0x66,0x00,0x00,0x07,0x72,0x65,0x6a,0x65,0x63,0x74,0x21,0x00,0x00,
+0x06,0x72,0x65,0x6a,0x65,0x63,0x74,0x00,0x00,0x00,0x01,0x53,0x00,0x03,0x00,0x07,
+0x00,0x00,0x00,0x00,0x00,0x46,0x00,0x00,0x33,0x00,0x00,0x00,0x06,0x02,0x21,0x00,
+0x33,0x10,0x04,0x01,0x05,0x02,0x2e,0x04,0x00,0x01,0x3a,0x03,0x00,0x00,0x2e,0x03,
+0x01,0x01,0x23,0x03,0x00,0x2a,0x10,0x03,0x01,0x04,0x02,0x2e,0x03,0x02,0x01,0x21,
+0x00,0x33,0x01,0x03,0x02,0x3c,0x03,0x01,0x01,0x02,0x03,0x01,0x03,0x02,0x10,0x04,
 0x2e,0x04,0x03,0x00,0x42,0x03,0x22,0x03,0x00,0x09,0x10,0x03,0x37,0x03,0x00,0x00,
-0x00,0x00,0x00,0x00,0x00,0x04,0x00,0x02,0x5b,0x5d,0x00,0x00,0x03,0x6f,0x72,0x64,
-0x00,0x00,0x04,0x63,0x61,0x6c,0x6c,0x00,0x00,0x06,0x6c,0x65,0x6e,0x67,0x74,0x68,
-0x00,0x00,0x00,0x01,0x07,0x00,0x03,0x00,0x07,0x00,0x00,0x00,0x00,0x00,0x36,0x00,
-0x33,0x00,0x00,0x00,0x06,0x02,0x21,0x00,0x23,0x10,0x04,0x01,0x05,0x02,0x2e,0x04,
-0x00,0x01,0x3a,0x03,0x00,0x00,0x2e,0x03,0x01,0x01,0x01,0x03,0x02,0x3c,0x03,0x01,
-0x01,0x02,0x03,0x01,0x03,0x02,0x10,0x04,0x2e,0x04,0x02,0x00,0x42,0x03,0x22,0x03,
-0x00,0x09,0x10,0x03,0x37,0x03,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x03,0x00,0x02,
-0x5b,0x5d,0x00,0x00,0x04,0x63,0x61,0x6c,0x6c,0x00,0x00,0x06,0x6c,0x65,0x6e,0x67,
-0x74,0x68,0x00,0x45,0x4e,0x44,0x00,0x00,0x00,0x00,0x08,
+0x00,0x00,0x00,0x00,0x00,0x04,0x00,0x02,0x5b,0x5d,0x00,0x00,0x04,0x63,0x61,0x6c,
+0x6c,0x00,0x00,0x09,0x64,0x65,0x6c,0x65,0x74,0x65,0x5f,0x61,0x74,0x00,0x00,0x06,
+0x6c,0x65,0x6e,0x67,0x74,0x68,0x00,0x00,0x00,0x00,0xe7,0x00,0x03,0x00,0x06,0x00,
+0x00,0x00,0x00,0x00,0x2e,0x00,0x00,0x00,0x33,0x00,0x00,0x01,0x10,0x03,0x2e,0x03,
+0x00,0x00,0x01,0x02,0x03,0x10,0x03,0x01,0x04,0x01,0x2f,0x03,0x01,0x00,0x01,0x03,
+0x02,0x10,0x04,0x2e,0x04,0x00,0x00,0x41,0x03,0x23,0x03,0x00,0x2a,0x0f,0x03,0x21,
+0x00,0x2c,0x10,0x03,0x37,0x03,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x06,
+0x6c,0x65,0x6e,0x67,0x74,0x68,0x00,0x00,0x09,0x64,0x65,0x6c,0x65,0x74,0x65,0x5f,
+0x69,0x66,0x00,0x00,0x00,0x00,0x78,0x00,0x02,0x00,0x04,0x00,0x00,0x00,0x00,0x00,
+0x13,0x00,0x00,0x00,0x33,0x00,0x00,0x01,0x10,0x02,0x2e,0x02,0x00,0x00,0x01,0x03,
+0x01,0x2f,0x02,0x01,0x00,0x37,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x02,0x00,
+0x03,0x64,0x75,0x70,0x00,0x00,0x09,0x64,0x65,0x6c,0x65,0x74,0x65,0x5f,0x69,0x66,
+0x00,0x00,0x00,0x00,0x55,0x00,0x01,0x00,0x03,0x00,0x01,0x00,0x00,0x00,0x0d,0x00,
+0x61,0x01,0x56,0x02,0x00,0x5d,0x01,0x00,0x0e,0x01,0x00,0x37,0x01,0x00,0x00,0x00,
+0x00,0x00,0x00,0x00,0x01,0x00,0x04,0x6c,0x6f,0x6f,0x70,0x00,0x00,0x00,0x00,0x85,
+0x00,0x02,0x00,0x04,0x00,0x00,0x00,0x00,0x00,0x19,0x00,0x00,0x33,0x00,0x00,0x00,
+0x21,0x00,0x0f,0x3a,0x02,0x00,0x00,0x2e,0x02,0x00,0x00,0x11,0x02,0x22,0x02,0x00,
+0x07,0x0f,0x02,0x37,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x00,0x04,0x63,
+0x61,0x6c,0x6c,0x00,0x45,0x4e,0x44,0x00,0x00,0x00,0x00,0x08,
 };
@@ -22,22 +22,44 @@ extern "C" {
 #endif
 
 
-#define PEEK_B(pc) ((pc)[0])
-#define PEEK_S(pc) ((pc)[0]<<8|(pc)[1])
-#define PEEK_W(pc) ((uint32_t)((pc)[0])<<16|(pc)[1]<<8|(pc)[2])
-
-#define READ_B() (vm->inst+=1, PEEK_B(vm->inst-1))
-#define READ_S() (vm->inst+=2, PEEK_S(vm->inst-2))
-#define READ_W() (vm->inst+=3, PEEK_W(vm->inst-3))
-
-#define EXT_CLEAR() vm->ext_flag = 0
-#define FETCH_Z() EXT_CLEAR()
-#define FETCH_B() uint32_t a = (vm->ext_flag & 1) ? READ_S() : READ_B(); EXT_CLEAR(); (void)a
-#define FETCH_BB() uint32_t a,b; a = (vm->ext_flag & 1) ? READ_S() : READ_B(); b = (vm->ext_flag & 2)? READ_S() : READ_B(); EXT_CLEAR(); (void)a, (void)b
-#define FETCH_BBB() uint32_t a,b,c; a = (vm->ext_flag & 1) ? READ_S() : READ_B(); b = (vm->ext_flag & 2)? READ_S() : READ_B(); c=READ_B(); EXT_CLEAR(); (void)a, (void)b, (void)c
-#define FETCH_BS() uint32_t a,b; a = (vm->ext_flag & 1) ? READ_S() : READ_B(); b=READ_S(); EXT_CLEAR(); (void)a, (void)b
-#define FETCH_S() uint32_t a=READ_S(); EXT_CLEAR(); (void)a
-#define FETCH_W() uint32_t a=READ_W(); EXT_CLEAR(); (void)a
+//================================================================
+/*!@brief
+  Decoded instruction.
+
+  mrbc_load_mrb() translates the bytecode into an array of this.
+  OP_EXT1..3 prefixes are folded into the operands, and jump
+  destinations are resolved to indexes of this array.
+
+  <pre>
+  operand type	a	b	c
+   B		a
+   BB, BS	a	b
+   BBB		a	bc.b	bc.c
+   S			b
+   W		a | b << 8
+  </pre>
+*/
+typedef struct INST {
+  uint8_t op;		//!< operation code.
+  uint8_t a;		//!< 1st operand.
+  union {
+    uint16_t b;		//!< 2nd operand.
+    struct {
+      uint8_t b;	//!< 2nd operand of BBB type.
+      uint8_t c;	//!< 3rd operand of BBB type.
+    } bc;
+  };
+} mrbc_inst;
+
+
+// fetch operands of the instruction under execution.
+#define FETCH_Z()
+#define FETCH_B() uint32_t a = vm->inst[-1].a; (void)a
+#define FETCH_BB() uint32_t a = vm->inst[-1].a, b = vm->inst[-1].b; (void)a, (void)b
+#define FETCH_BBB() uint32_t a = vm->inst[-1].a, b = vm->inst[-1].bc.b, c = vm->inst[-1].bc.c; (void)a, (void)b, (void)c
+#define FETCH_BS() FETCH_BB()
+#define FETCH_S() uint32_t a = vm->inst[-1].b; (void)a
+#define FETCH_W() uint32_t a = vm->inst[-1].a | (uint32_t)vm->inst[-1].b << 8; (void)a
 
 
 //================================================================
@@ -45,64 +45,259 @@
 /***** Function prototypes **************************************************/
 /***** Local variables ******************************************************/
 static mrbc_tcb *q_dormant_;
-static mrbc_tcb *q_ready_;
-static mrbc_tcb *q_waiting_;
+static mrbc_tcb *q_waiting_;		// TASKREASON_MUTEX
+static mrbc_tcb *q_waiting_io_;		// TASKREASON_IO
 static mrbc_tcb *q_suspended_;
 static volatile uint32_t tick_;
 
+// ready queue. one list for each priority level, and bitmap of
+// non-empty levels (q_ready_map_) and words of it (q_ready_group_).
+static mrbc_tcb *q_ready_[MRBC_READY_QUEUE_LEVELS];
+static mrbc_tcb *q_ready_tail_[MRBC_READY_QUEUE_LEVELS];
+static uint32_t q_ready_map_[(MRBC_READY_QUEUE_LEVELS + 31) / 32];
+static uint8_t q_ready_group_;
+
+// sleeping tasks (TASKREASON_SLEEP). hashed timer wheel indexed by
+// wakeup_tick, each slot is sorted by the rest of sleep time.
+static mrbc_tcb *q_sleeping_[MRBC_TIMER_WHEEL_SIZE];
+static int num_sleeping_;
+
+static mrbc_tcb *tcb_running_;
+
 
 /***** Global variables *****************************************************/
 /***** Signal catching functions ********************************************/
 /***** Local functions ******************************************************/
 
 //================================================================
-/*! Insert to task queue
+/*! count trailing zeros (find first set)
 
-  @param        Pointer of target TCB
+  @param  x	non-zero value.
+*/
+static inline int ctz32(uint32_t x)
+{
+#if defined(__GNUC__)
+  return __builtin_ctz(x);
+#else
+  int n = 0;
+  while( !(x & 1) ) {
+    x >>= 1;
+    n++;
+  }
+  return n;
+#endif
+}
 
-  引数で指定されたタスク(TCB)を、状態別Queueに入れる。
-  TCBはフリーの状態でなければならない。（別なQueueに入っていてはならない）
-  Queueはpriority_preemption順にソート済みとなる。
-  挿入するTCBとQueueに同じpriority_preemption値がある場合は、同値の最後に挿入される。
 
- */
-static void q_insert_task(mrbc_tcb *p_tcb)
+//================================================================
+/*! ready queue level of the task
+
+*/
+static inline int q_ready_level(const mrbc_tcb *p_tcb)
 {
-  mrbc_tcb **pp_q;
+  return p_tcb->priority_preemption * MRBC_READY_QUEUE_LEVELS / 256;
+}
 
-  switch( p_tcb->state ) {
-  case TASKSTATE_DORMANT: pp_q   = &q_dormant_; break;
-  case TASKSTATE_READY:
-  case TASKSTATE_RUNNING: pp_q   = &q_ready_; break;
-  case TASKSTATE_WAITING: pp_q   = &q_waiting_; break;
-  case TASKSTATE_SUSPENDED: pp_q = &q_suspended_; break;
-  default:
-    assert(!"Wrong task state.");
-    return;
-  }
 
+//================================================================
+/*! Get the task to run next.
+
+  @return	Pointer of top TCB in ready queue, or NULL.
+*/
+static inline mrbc_tcb *q_ready_top(void)
+{
+  if( q_ready_group_ == 0 ) return NULL;
+
+  int g = ctz32(q_ready_group_);
+  return q_ready_[g * 32 + ctz32(q_ready_map_[g])];
+}
+
+
+//================================================================
+/*! Insert to sorted list
+
+  @param  pp_q		Pointer of list top.
+  @param  p_tcb		Pointer of target TCB
+  @param  p_tail	last TCB of the list if known, or NULL.
+  @return		Pointer of TCB inserted after, or NULL if top.
+
+  Queueはpriority_preemption順にソート済みとなる。
+  挿入するTCBとQueueに同じpriority_preemption値がある場合は、同値の最後に挿入される。
+*/
+static mrbc_tcb *q_list_insert(mrbc_tcb **pp_q, mrbc_tcb *p_tcb, mrbc_tcb *p_tail)
+{
   // case insert on top.
   if((*pp_q == NULL) ||
      (p_tcb->priority_preemption < (*pp_q)->priority_preemption)) {
     p_tcb->next = *pp_q;
     *pp_q       = p_tcb;
     assert(p_tcb->next != p_tcb);
-    return;
+    return NULL;
   }
 
-  // find insert point in sorted linked list.
+  // append to the last without search.
   mrbc_tcb *p = *pp_q;
+  if( p_tail && p_tail->priority_preemption <= p_tcb->priority_preemption ) {
+    p = p_tail;
+  }
+
+  // find insert point in sorted linked list.
   while( 1 ) {
     if((p->next == NULL) ||
        (p_tcb->priority_preemption < p->next->priority_preemption)) {
       p_tcb->next = p->next;
       p->next     = p_tcb;
       assert(p->next != p);
-      return;
+      return p;
+    }
+
+    p = p->next;
+  }
+}
+
+
+//================================================================
+/*! Delete from list
+
+  @param  pp_q		Pointer of list top.
+  @param  p_tcb		Pointer of target TCB
+  @return		Pointer of previous TCB, or NULL if top or not found.
+*/
+static mrbc_tcb *q_list_delete(mrbc_tcb **pp_q, mrbc_tcb *p_tcb)
+{
+  if( *pp_q == NULL ) return NULL;
+  if( *pp_q == p_tcb ) {
+    *pp_q       = p_tcb->next;
+    p_tcb->next = NULL;
+    return NULL;
+  }
+
+  mrbc_tcb *p = *pp_q;
+  while( p ) {
+    if( p->next == p_tcb ) {
+      p->next     = p_tcb->next;
+      p_tcb->next = NULL;
+      return p;
     }
 
     p = p->next;
   }
+  return NULL;
+}
+
+
+//================================================================
+/*! Insert to ready queue
+
+*/
+static void q_ready_insert(mrbc_tcb *p_tcb)
+{
+  int n = q_ready_level(p_tcb);
+
+  mrbc_tcb *p = q_list_insert(&q_ready_[n], p_tcb, q_ready_tail_[n]);
+  if( p == q_ready_tail_[n] ) q_ready_tail_[n] = p_tcb;	// includes empty.
+
+  q_ready_map_[n / 32] |= (uint32_t)1 << (n % 32);
+  q_ready_group_ |= 1 << (n / 32);
+}
+
+
+//================================================================
+/*! Delete from ready queue
+
+*/
+static void q_ready_delete(mrbc_tcb *p_tcb)
+{
+  int n = q_ready_level(p_tcb);
+  mrbc_tcb *p = q_list_delete(&q_ready_[n], p_tcb);
+
+  if( q_ready_tail_[n] == p_tcb ) q_ready_tail_[n] = p;
+  if( q_ready_[n] == NULL ) {
+    q_ready_map_[n / 32] &= ~((uint32_t)1 << (n % 32));
+    if( q_ready_map_[n / 32] == 0 ) q_ready_group_ &= ~(1 << (n / 32));
+  }
+}
+
+
+//================================================================
+/*! Insert to timer wheel
+
+  Insert after the tasks waking up at the same tick.
+*/
+static void q_sleep_insert(mrbc_tcb *p_tcb)
+{
+  mrbc_tcb **pp = &q_sleeping_[p_tcb->wakeup_tick % MRBC_TIMER_WHEEL_SIZE];
+  int32_t rest = p_tcb->wakeup_tick - tick_;
+
+  while( *pp != NULL && (int32_t)((*pp)->wakeup_tick - tick_) <= rest ) {
+    pp = &(*pp)->next;
+  }
+  p_tcb->next = *pp;
+  *pp = p_tcb;
+  num_sleeping_++;
+}
+
+
+//================================================================
+/*! Delete from timer wheel
+
+*/
+static void q_sleep_delete(mrbc_tcb *p_tcb)
+{
+  mrbc_tcb **pp = &q_sleeping_[p_tcb->wakeup_tick % MRBC_TIMER_WHEEL_SIZE];
+
+  while( *pp != NULL ) {
+    if( *pp == p_tcb ) {
+      *pp = p_tcb->next;
+      p_tcb->next = NULL;
+      num_sleeping_--;
+      return;
+    }
+    pp = &(*pp)->next;
+  }
+}
+
+
+//================================================================
+/*! Insert to task queue
+
+  @param        Pointer of target TCB
+
+  引数で指定されたタスク(TCB)を、状態別Queueに入れる。
+  TCBはフリーの状態でなければならない。（別なQueueに入っていてはならない）
+  Queueはpriority_preemption順にソート済みとなる。
+  挿入するTCBとQueueに同じpriority_preemption値がある場合は、同値の最後に挿入される。
+  ただし、sleepしているタスクは起床時刻順となる。
+
+ */
+static void q_insert_task(mrbc_tcb *p_tcb)
+{
+  switch( p_tcb->state ) {
+  case TASKSTATE_DORMANT:
+    q_list_insert(&q_dormant_, p_tcb, NULL);
+    break;
+
+  case TASKSTATE_READY:
+  case TASKSTATE_RUNNING:
+    q_ready_insert(p_tcb);
+    break;
+
+  case TASKSTATE_WAITING:
+    switch( p_tcb->reason ) {
+    case TASKREASON_SLEEP: q_sleep_insert(p_tcb); break;
+    case TASKREASON_IO:    q_list_insert(&q_waiting_io_, p_tcb, NULL); break;
+    default:               q_list_insert(&q_waiting_, p_tcb, NULL); break;
+    }
+    break;
+
+  case TASKSTATE_SUSPENDED:
+    q_list_insert(&q_suspended_, p_tcb, NULL);
+    break;
+
+  default:
+    assert(!"Wrong task state.");
+    return;
+  }
 }
 
 
@@ -116,36 +311,83 @@ static void q_insert_task(mrbc_tcb *p_tcb)
  */
 static void q_delete_task(mrbc_tcb *p_tcb)
 {
-  mrbc_tcb **pp_q;
-
   switch( p_tcb->state ) {
-  case TASKSTATE_DORMANT: pp_q   = &q_dormant_; break;
+  case TASKSTATE_DORMANT:
+    q_list_delete(&q_dormant_, p_tcb);
+    break;
+
   case TASKSTATE_READY:
-  case TASKSTATE_RUNNING: pp_q   = &q_ready_; break;
-  case TASKSTATE_WAITING: pp_q   = &q_waiting_; break;
-  case TASKSTATE_SUSPENDED: pp_q = &q_suspended_; break;
+  case TASKSTATE_RUNNING:
+    q_ready_delete(p_tcb);
+    break;
+
+  case TASKSTATE_WAITING:
+    switch( p_tcb->reason ) {
+    case TASKREASON_SLEEP: q_sleep_delete(p_tcb); break;
+    case TASKREASON_IO:    q_list_delete(&q_waiting_io_, p_tcb); break;
+    default:               q_list_delete(&q_waiting_, p_tcb); break;
+    }
+    break;
+
+  case TASKSTATE_SUSPENDED:
+    q_list_delete(&q_suspended_, p_tcb);
+    break;
+
   default:
     assert(!"Wrong task state.");
     return;
   }
+}
 
-  if( *pp_q == NULL ) return;
-  if( *pp_q == p_tcb ) {
-    *pp_q       = p_tcb->next;
-    p_tcb->next = NULL;
-    return;
+
+//================================================================
+/*! Make the task ready to run.
+
+  The task must be out of queues.
+*/
+static void q_wakeup_task(mrbc_tcb *p_tcb)
+{
+  p_tcb->state     = TASKSTATE_READY;
+  p_tcb->timeslice = MRBC_TIMESLICE_TICK_COUNT;
+  q_insert_task(p_tcb);
+}
+
+
+//================================================================
+/*! Request preemption of the running task.
+
+*/
+static void preempt_running_task(void)
+{
+  mrbc_tcb *tcb = tcb_running_;
+  if( tcb != NULL && tcb->state == TASKSTATE_RUNNING ) {
+    tcb->vm.flag_preemption = 1;
   }
+}
 
-  mrbc_tcb *p = *pp_q;
-  while( p ) {
-    if( p->next == p_tcb ) {
-      p->next     = p_tcb->next;
-      p_tcb->next = NULL;
-      return;
-    }
 
-    p = p->next;
+//================================================================
+/*! Wake up tasks waiting for input, if it is ready.
+
+  @return	true if any task is woken up.
+*/
+static int wakeup_io_tasks(void)
+{
+  int flag_wakeup = 0;
+  mrbc_tcb *tcb = q_waiting_io_;
+
+  while( tcb != NULL ) {
+    mrbc_tcb *t = tcb;
+    tcb = tcb->next;
+
+    if( t->io.ready(t->io.need) ) {
+      q_delete_task(t);
+      q_wakeup_task(t);
+      flag_wakeup = 1;
+    }
   }
+
+  return flag_wakeup;
 }
 
 
@@ -338,7 +580,7 @@ void mrbc_tick(void)
   tick_++;
 
   // 実行中タスクのタイムスライス値を減らす
-  tcb = q_ready_;
+  tcb = q_ready_top();
   if((tcb != NULL) &&
      (tcb->state == TASKSTATE_RUNNING) &&
      (tcb->timeslice > 0)) {
@@ -346,28 +588,21 @@ void mrbc_tick(void)
     if( tcb->timeslice == 0 ) tcb->vm.flag_preemption = 1;
   }
 
-  // 待ちタスクキューから、ウェイクアップすべきタスクを探す
-  tcb = q_waiting_;
-  while( tcb != NULL ) {
-    mrbc_tcb *t = tcb;
-    tcb = tcb->next;
-
-    if( t->reason == TASKREASON_SLEEP && t->wakeup_tick == tick_ ) {
-      q_delete_task(t);
-      t->state     = TASKSTATE_READY;
-      t->timeslice = MRBC_TIMESLICE_TICK_COUNT;
-      q_insert_task(t);
-      flag_preemption = 1;
-    }
+  // タイマーホイールの今回のスロットから、ウェイクアップすべきタスクを取り出す
+  // (スロットは起床時刻順なので、先頭だけを見ればよい)
+  mrbc_tcb **pp_slot = &q_sleeping_[tick_ % MRBC_TIMER_WHEEL_SIZE];
+  while( *pp_slot != NULL && (*pp_slot)->wakeup_tick == tick_ ) {
+    tcb = *pp_slot;
+    *pp_slot = tcb->next;
+    num_sleeping_--;
+    q_wakeup_task(tcb);
+    flag_preemption = 1;
   }
 
-  if( flag_preemption ) {
-    tcb = q_ready_;
-    while( tcb != NULL ) {
-      if( tcb->state == TASKSTATE_RUNNING ) tcb->vm.flag_preemption = 1;
-      tcb = tcb->next;
-    }
-  }
+  // 入力待ちタスク
+  if( wakeup_io_tasks() ) flag_preemption = 1;
+
+  if( flag_preemption ) preempt_running_task();
 }
 
 
@@ -419,9 +654,16 @@ void mrbc_cleanup(void)
   mrbc_cleanup_alloc();
 
   q_dormant_ = 0;
-  q_ready_ = 0;
   q_waiting_ = 0;
+  q_waiting_io_ = 0;
   q_suspended_ = 0;
+  memset(q_ready_, 0, sizeof(q_ready_));
+  memset(q_ready_tail_, 0, sizeof(q_ready_tail_));
+  memset(q_ready_map_, 0, sizeof(q_ready_map_));
+  q_ready_group_ = 0;
+  memset(q_sleeping_, 0, sizeof(q_sleeping_));
+  num_sleeping_ = 0;
+  tcb_running_ = 0;
 }
 
 
@@ -497,11 +739,7 @@ int mrbc_start_task(mrbc_tcb *tcb)
 
   hal_disable_irq();
 
-  mrbc_tcb *t = q_ready_;
-  while( t != NULL ) {
-    if( t->state == TASKSTATE_RUNNING ) t->vm.flag_preemption = 1;
-    t = t->next;
-  }
+  preempt_running_task();
 
   q_delete_task(tcb);
   tcb->state = TASKSTATE_READY;
@@ -519,7 +757,7 @@ int mrbc_start_task(mrbc_tcb *tcb)
 int mrbc_run(void)
 {
   while( 1 ) {
-    mrbc_tcb *tcb = q_ready_;
+    mrbc_tcb *tcb = q_ready_top();
     if( tcb == NULL ) {
       // 実行すべきタスクなし
       hal_idle_cpu();
@@ -528,6 +766,7 @@ int mrbc_run(void)
 
     // 実行開始
     tcb->state = TASKSTATE_RUNNING;
+    tcb_running_ = tcb;
     int res = 0;
 
 #ifndef MRBC_NO_TIMER
@@ -535,13 +774,10 @@ int mrbc_run(void)
     res = mrbc_vm_run(&tcb->vm);
 
 #else
-    while( tcb->timeslice > 0 ) {
-      tcb->vm.flag_preemption = 1;
-      res = mrbc_vm_run(&tcb->vm);
-      tcb->timeslice--;
-      if( res < 0 ) break;
-      if( tcb->state != TASKSTATE_RUNNING ) break;
-    }
+    // run up to tcb->vm.inst_budget instructions as one timeslice.
+    tcb->vm.flag_preemption = 0;
+    res = mrbc_vm_run(&tcb->vm);
+    tcb->timeslice = 0;
     mrbc_tick();
 #endif /* ifndef MRBC_NO_TIMER */
 
@@ -555,7 +791,8 @@ int mrbc_run(void)
       mrbc_vm_end(&tcb->vm);
 
 #if MRBC_SCHEDULER_EXIT
-      if( q_ready_ == NULL && q_waiting_ == NULL &&
+      if( q_ready_group_ == 0 && q_waiting_ == NULL &&
+          q_waiting_io_ == NULL && num_sleeping_ == 0 &&
           q_suspended_ == NULL ) return 0;
 #endif
       continue;
@@ -616,8 +853,14 @@ void mrbc_relinquish(mrbc_tcb *tcb)
 */
 void mrbc_change_priority(mrbc_tcb *tcb, int priority)
 {
+  // the ready queue level depends on the priority.
+  hal_disable_irq();
+  q_delete_task(tcb);
   tcb->priority            = (uint8_t)priority;
   tcb->priority_preemption = (uint8_t)priority;
+  q_insert_task(tcb);
+  hal_enable_irq();
+
   tcb->timeslice           = 0;
   tcb->vm.flag_preemption = 1;
 }
@@ -647,11 +890,7 @@ void mrbc_resume_task(mrbc_tcb *tcb)
 {
   hal_disable_irq();
 
-  mrbc_tcb *t = q_ready_;
-  while( t != NULL ) {
-    if( t->state == TASKSTATE_RUNNING ) t->vm.flag_preemption = 1;
-    t = t->next;
-  }
+  preempt_running_task();
 
   q_delete_task(tcb);
   tcb->state = TASKSTATE_READY;
@@ -660,6 +899,49 @@ void mrbc_resume_task(mrbc_tcb *tcb)
 }
 
 
+//================================================================
+/*! 入力待ち (wait for input)
+
+  Called from a C method of the running task invoked by a send
+  instruction, which should return without touching the arguments.
+  The task waits until ready(need) returns true, then the method is
+  called again with the same arguments.
+  ready() is polled by mrbc_tick() and mrbc_wakeup_io().
+
+  @param  vm	VM of the running task.
+  @param  ready	input check function. called with interrupts disabled.
+  @param  need	parameter of ready()
+*/
+void mrbc_wait_io(struct VM *vm, int (*ready)(int need), int need)
+{
+  mrbc_tcb *tcb = VM2TCB(vm);
+
+  hal_disable_irq();
+  q_delete_task(tcb);
+  tcb->timeslice = 0;
+  tcb->state     = TASKSTATE_WAITING;
+  tcb->reason    = TASKREASON_IO;
+  tcb->io.ready  = ready;
+  tcb->io.need   = need;
+  q_insert_task(tcb);
+  hal_enable_irq();
+
+  vm->flag_retry = 1;
+  vm->flag_preemption = 1;
+}
+
+
+//================================================================
+/*! 入力待ちタスクを起こす (wake up tasks waiting for input)
+
+  Call from an input interrupt handler to wake them before next tick.
+*/
+void mrbc_wakeup_io(void)
+{
+  if( wakeup_io_tasks() ) preempt_running_task();
+}
+
+
 //================================================================
 /*! mutex initialize
 
@@ -750,11 +1032,7 @@ int mrbc_mutex_unlock( mrbc_mutex *mutex, mrbc_tcb *tcb )
   }
 
   if( flag_preemption ) {
-    tcb = q_ready_;
-    while( tcb != NULL ) {
-      if( tcb->state == TASKSTATE_RUNNING ) tcb->vm.flag_preemption = 1;
-      tcb = tcb->next;
-    }
+    preempt_running_task();
   }
   else {
     // unlock mutex
@@ -832,7 +1110,7 @@ void pq(mrbc_tcb *p_tcb)
   while( p != NULL ) {
     console_printf(" st:%c%c%c%c  ",
                    (p->state & TASKSTATE_SUSPENDED)?'S':'-',
-                   (p->state & TASKSTATE_WAITING)?("sm"[p->reason]):'-',
+                   (p->state & TASKSTATE_WAITING)?("smi"[p->reason]):'-',
                    (p->state &(TASKSTATE_RUNNING & ~TASKSTATE_READY))?'R':'-',
                    (p->state & TASKSTATE_READY)?'r':'-' );
     p = p->next;
@@ -851,8 +1129,16 @@ void pq(mrbc_tcb *p_tcb)
 void pqall(void)
 {
 //  console_printf("<<<<< DORMANT >>>>>\n");	pq(q_dormant_);
-  console_printf("<<<<< READY >>>>>\n");	pq(q_ready_);
+  int i;
+  console_printf("<<<<< READY >>>>>\n");
+  for( i = 0; i < MRBC_READY_QUEUE_LEVELS; i++ ) {
+    if( q_ready_[i] ) pq(q_ready_[i]);
+  }
   console_printf("<<<<< WAITING >>>>>\n");	pq(q_waiting_);
+  pq(q_waiting_io_);
+  for( i = 0; i < MRBC_TIMER_WHEEL_SIZE; i++ ) {
+    if( q_sleeping_[i] ) pq(q_sleeping_[i]);
+  }
   console_printf("<<<<< SUSPENDED >>>>>\n");	pq(q_suspended_);
 }
 #endif
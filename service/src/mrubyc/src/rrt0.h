@@ -41,6 +41,7 @@ enum MrbcTaskState {
 enum MrbcTaskReason {
   TASKREASON_SLEEP = 0x00,
   TASKREASON_MUTEX = 0x01,
+  TASKREASON_IO    = 0x02,
 };
 
 
@@ -59,11 +60,15 @@ typedef struct RTcb {
   uint8_t priority_preemption;
   uint8_t timeslice;
   uint8_t state;	//!< enum MrbcTaskState
-  uint8_t reason;	//!< SLEEP, MUTEX
+  uint8_t reason;	//!< SLEEP, MUTEX, IO
 
   union {
     uint32_t wakeup_tick;
     struct RMutex *mutex;
+    struct {
+      int (*ready)(int need);	//!< returns true if input is enough.
+      int need;
+    } io;
   };
   struct VM vm;
 } mrbc_tcb;
@@ -96,6 +101,8 @@ void mrbc_relinquish(mrbc_tcb *tcb);
 void mrbc_change_priority(mrbc_tcb *tcb, int priority);
 void mrbc_suspend_task(mrbc_tcb *tcb);
 void mrbc_resume_task(mrbc_tcb *tcb);
+void mrbc_wait_io(struct VM *vm, int (*ready)(int need), int need);
+void mrbc_wakeup_io(void);
 mrbc_mutex *mrbc_mutex_init(mrbc_mutex *mutex);
 int mrbc_mutex_lock(mrbc_mutex *mutex, mrbc_tcb *tcb);
 int mrbc_mutex_unlock(mrbc_mutex *mutex, mrbc_tcb *tcb);
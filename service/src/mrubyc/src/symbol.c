@@ -16,7 +16,6 @@
 #include "vm_config.h"
 #include <stdint.h>
 #include <string.h>
-#include <limits.h>
 #include <assert.h>
 
 /***** Local headers ********************************************************/
@@ -31,36 +30,31 @@
 #include "console.h"
 
 /***** Constant values ******************************************************/
-#if !defined(MRBC_SYMBOL_SEARCH_LINER) && !defined(MRBC_SYMBOL_SEARCH_BTREE)
-#define MRBC_SYMBOL_SEARCH_BTREE
-#endif
+#define OFFSET_BUILTIN_SYMBOL 256
 
-#if MAX_SYMBOLS_COUNT <= UCHAR_MAX
-#define MRBC_SYMBOL_TABLE_INDEX_TYPE	uint8_t
-#else
-#define MRBC_SYMBOL_TABLE_INDEX_TYPE	uint16_t
+// runtime symbols are restricted by the range of mrbc_sym.
+#if MAX_SYMBOLS_COUNT > INT16_MAX + 1 - OFFSET_BUILTIN_SYMBOL
+#error "MAX_SYMBOLS_COUNT is too large."
 #endif
 
-#define OFFSET_BUILTIN_SYMBOL 256
-
 
 /***** Macros ***************************************************************/
 /***** Typedefs *************************************************************/
 struct SYM_INDEX {
-  uint16_t hash;	//!< hash value, returned by calc_hash().
-#ifdef MRBC_SYMBOL_SEARCH_BTREE
-  MRBC_SYMBOL_TABLE_INDEX_TYPE left;
-  MRBC_SYMBOL_TABLE_INDEX_TYPE right;
-#endif
   const char *cstr;	//!< point to the symbol string.
+  uint16_t len;		//!< length of the symbol string.
+  uint16_t hash;	//!< lower bits of the hash value for quick reject.
 };
 
 
 /***** Function prototypes **************************************************/
 /***** Local variables ******************************************************/
 
-static struct SYM_INDEX sym_index[MAX_SYMBOLS_COUNT];
+static struct SYM_INDEX *sym_index;	// symbol ID ordered table.
 static int sym_index_pos;	// point to the last(free) sym_index array.
+static int sym_index_size;	// allocated size of sym_index.
+static uint16_t *sym_hash;	// open addressing hash table. (index + 1)
+static int sym_hash_size;	// size of sym_hash. (power of 2)
 
 #define MRBC_DEFINE_SYMBOL_TABLE
 #include "symbol_builtin.h"	// built-in symbol table.
@@ -72,55 +66,58 @@ static int sym_index_pos;	// point to the last(free) sym_index array.
 /***** Local functions ******************************************************/
 
 //================================================================
-/*! Calculate hash value.
+/*! Calculate hash value. (FNV-1a)
 
   @param  str		Target string.
-  @return uint16_t	Hash value.
+  @param  len		Length of the string.
+  @return uint32_t	Hash value.
 */
-static inline uint16_t calc_hash(const char *str)
+static inline uint32_t calc_hash(const char *str, int len)
 {
-  uint16_t h = 0;
+  uint32_t h = 2166136261U;
 
-  while( *str != '\0' ) {
-    h = h * 17 + *str++;
+  while( --len >= 0 ) {
+    h ^= (uint8_t)*str++;
+    h *= 16777619U;
   }
   return h;
 }
 
 
 //================================================================
-/*! search built-in symbol table
+/*! Calculate secondary hash value with displacement.
+
+  @param  hash		Hash value returned by calc_hash().
+  @param  d		Displacement.
+  @return uint32_t	Hash value.
+  @note same as calc_hash2() in support/make_symbol_table.rb.
+*/
+static inline uint32_t calc_hash2(uint32_t hash, int d)
+{
+  hash += d * 0x9e3779b9U;
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6bU;
+  hash ^= hash >> 13;
+  return hash;
+}
+
+
+//================================================================
+/*! search built-in symbol table (minimal perfect hash)
 
   @param  str	string ptr.
+  @param  len	length of the string.
+  @param  hash	hash value.
   @return	symbol id. or -1 if not found.
 */
-static int search_builtin_symbol( const char *str )
+static int search_builtin_symbol( const char *str, int len, uint32_t hash )
 {
-  int left = 0;
-  int right = sizeof(builtin_symbols) / sizeof(builtin_symbols[0]);
-
-  while( left < right ) {
-    int mid = (left + right) / 2;
-    const unsigned char *p1 = (const unsigned char *)builtin_symbols[mid];
-    const unsigned char *p2 = (const unsigned char *)str;
-
-    while( 1 ) {	// string compare, same order as cruby.
-      if( *p1 < *p2 ) {
-	left = mid + 1;
-	break;
-      }
-      if( *p1 > *p2 ) {
-	right = mid;
-	break;
-      }
-      if( *p1 == 0 ) {
-	return mid;
-      }
-
-      p1++;
-      p2++;
-    }
-  }
+  static const int n = sizeof(builtin_symbols) / sizeof(builtin_symbols[0]);
+  int d = builtin_symbols_disp[hash % n];
+  int i = (d < 0) ? -d - 1 : calc_hash2(hash, d) % n;
+
+  if( builtin_symbols_len[i] == len &&
+      memcmp(builtin_symbols[i], str, len) == 0 ) return i;
 
   return -1;
 }
@@ -131,93 +128,176 @@ static int search_builtin_symbol( const char *str )
 
   @param  hash	hash value.
   @param  str	string ptr.
+  @param  len	length of the string.
   @return	index. or -1 if not found.
 */
-static int search_index( uint16_t hash, const char *str )
+static int search_index( uint32_t hash, const char *str, int len )
 {
-#ifdef MRBC_SYMBOL_SEARCH_LINER
-  int i;
-  for( i = 0; i < sym_index_pos; i++ ) {
-    if( sym_index[i].hash == hash && strcmp(str, sym_index[i].cstr) == 0 ) {
-      return i;
+  if( sym_hash_size == 0 ) return -1;
+
+  int mask = sym_hash_size - 1;
+  int i = hash & mask;
+  int n;
+
+  while( (n = sym_hash[i]) != 0 ) {
+    const struct SYM_INDEX *p = &sym_index[n - 1];
+    if( p->hash == (uint16_t)hash && p->len == len &&
+	memcmp(str, p->cstr, len) == 0 ) {
+      return n - 1;
     }
+    i = (i + 1) & mask;
   }
+
   return -1;
-#endif
+}
 
-#ifdef MRBC_SYMBOL_SEARCH_BTREE
-  int i = 0;
-  do {
-    if( sym_index[i].hash == hash && strcmp(str, sym_index[i].cstr) == 0 ) {
-      return i;
-    }
-    if( hash < sym_index[i].hash ) {
-      i = sym_index[i].left;
-    } else {
-      i = sym_index[i].right;
-    }
-  } while( i != 0 );
+
+//================================================================
+/*! set to hash table
+
+  @param  hash	hash value.
+  @param  idx	index of sym_index.
+*/
+static void set_hash( uint32_t hash, int idx )
+{
+  int mask = sym_hash_size - 1;
+  int i = hash & mask;
+
+  while( sym_hash[i] != 0 ) {
+    i = (i + 1) & mask;
+  }
+  sym_hash[i] = idx + 1;
+}
+
+
+//================================================================
+/*! expand index table and rebuild hash table.
+
+  @return	0 if no error.
+*/
+static int expand_index( void )
+{
+  int size = sym_index_size ? sym_index_size * 2 : MRBC_SYMBOL_TABLE_INIT_SIZE;
+  if( size > MAX_SYMBOLS_COUNT ) size = MAX_SYMBOLS_COUNT;
+  if( size <= sym_index_size ) return -1;
+
+  // hash table is a power of 2, at least twice as large as the index table.
+  int hash_size = 2;
+  while( hash_size < size * 2 ) hash_size *= 2;
+
+  uint16_t *new_hash = mrbc_raw_alloc( sizeof(uint16_t) * hash_size );
+  if( !new_hash ) return -1;		// ENOMEM
+
+  struct SYM_INDEX *new_index = sym_index ?
+    mrbc_raw_realloc( sym_index, sizeof(struct SYM_INDEX) * size ) :
+    mrbc_raw_alloc( sizeof(struct SYM_INDEX) * size );
+  if( !new_index ) {
+    mrbc_raw_free( new_hash );
+    return -1;				// ENOMEM
+  }
+
+  // both tables are allocated. commit them.
+  sym_index = new_index;
+  sym_index_size = size;
+  if( sym_hash ) mrbc_raw_free( sym_hash );
+  sym_hash = new_hash;
+  sym_hash_size = hash_size;
+  memset( sym_hash, 0, sizeof(uint16_t) * sym_hash_size );
+
+  int i;
+  for( i = 0; i < sym_index_pos; i++ ) {
+    set_hash( calc_hash(sym_index[i].cstr, sym_index[i].len), i );
+  }
+
+  return 0;
+}
+
+
+//================================================================
+/*! make room for one more symbol in index table.
+
+  @param  str	string ptr. (for error message)
+  @param  len	length of the string.
+  @return	0 if no error.
+*/
+static int reserve_index( const char *str, int len )
+{
+  if( sym_index_pos < sym_index_size ) return 0;
+
+  if( sym_index_pos >= MAX_SYMBOLS_COUNT ) {
+    console_print( "Overflow MAX_SYMBOLS_COUNT for '" );
+  } else if( expand_index() != 0 ) {
+    console_print( "Can't add symbol '" );
+  } else {
+    return 0;
+  }
+
+  console_nprint( str, len );
+  console_print( "'\n" );
   return -1;
-#endif
 }
 
 
 //================================================================
 /*! add to index table
 
-  @param  hash	return value.
+  @param  hash	hash value.
   @param  str	string ptr.
+  @param  len	length of the string.
   @return	index. or -1 if error.
 */
-static int add_index( uint16_t hash, const char *str )
+static int add_index( uint32_t hash, const char *str, int len )
 {
-  // check overflow.
-  if( sym_index_pos >= MAX_SYMBOLS_COUNT ) {
-    console_printf( "Overflow MAX_SYMBOLS_COUNT for '%s'\n", str );
-    return -1;
-  }
+  if( reserve_index( str, len ) != 0 ) return -1;
 
   int idx = sym_index_pos++;
 
   // append table.
-  sym_index[idx].hash = hash;
   sym_index[idx].cstr = str;
-
-#ifdef MRBC_SYMBOL_SEARCH_BTREE
-  int i = 0;
-
-  while( 1 ) {
-    if( hash < sym_index[i].hash ) {
-      // left side
-      if( sym_index[i].left == 0 ) {	// left is empty?
-        sym_index[i].left = idx;
-        break;
-      }
-      i = sym_index[i].left;
-    } else {
-      // right side
-      if( sym_index[i].right == 0 ) {	// right is empty?
-        sym_index[i].right = idx;
-        break;
-      }
-      i = sym_index[i].right;
-    }
-  }
-#endif
+  sym_index[idx].len = len;
+  sym_index[idx].hash = hash;
+  set_hash( hash, idx );
 
   return idx;
 }
 
 
+//================================================================
+/*! Search only.
+
+  @param  str	string ptr.
+  @param  len	length of the string.
+  @param  hash	hash value.
+  @return	symbol id. or -1 if not registered.
+*/
+static mrbc_sym search_symid( const char *str, int len, uint32_t hash )
+{
+  mrbc_sym sym_id = search_builtin_symbol(str, len, hash);
+  if( sym_id >= 0 ) return sym_id;
+
+  sym_id = search_index(hash, str, len);
+  if( sym_id < 0 ) return sym_id;
+
+  return sym_id + OFFSET_BUILTIN_SYMBOL;
+}
+
+
 /***** Global functions *****************************************************/
 
 //================================================================
 /*! cleanup
+
+  (note)
+  The tables are in the memory pool, and it will be cleaned up
+  by mrbc_cleanup_alloc() with other resources.
 */
 void mrbc_cleanup_symbol(void)
 {
-  memset(sym_index, 0, sizeof(sym_index));
+  sym_index = 0;
   sym_index_pos = 0;
+  sym_index_size = 0;
+  sym_hash = 0;
+  sym_hash_size = 0;
 }
 
 
@@ -229,12 +309,12 @@ void mrbc_cleanup_symbol(void)
 */
 mrbc_sym mrbc_str_to_symid(const char *str)
 {
-  mrbc_sym sym_id = search_builtin_symbol(str);
+  int len = strlen(str);
+  uint32_t h = calc_hash(str, len);
+  mrbc_sym sym_id = search_symid(str, len, h);
   if( sym_id >= 0 ) return sym_id;
 
-  uint16_t h = calc_hash(str);
-  sym_id = search_index(h, str);
-  if( sym_id < 0 ) sym_id = add_index( h, str );
+  sym_id = add_index( h, str, len );
   if( sym_id < 0 ) return sym_id;
 
   return sym_id + OFFSET_BUILTIN_SYMBOL;
@@ -262,6 +342,30 @@ const char * mrbc_symid_to_str(mrbc_sym sym_id)
 }
 
 
+//================================================================
+/*! Convert symbol value to string and its length.
+
+  @param  sym_id	Symbol value.
+  @param  len		Pointer to return the length.
+  @return const char*	String.
+  @retval NULL		Invalid sym_id was given.
+*/
+const char * mrbc_symid_to_str_len(mrbc_sym sym_id, int *len)
+{
+  if( sym_id < OFFSET_BUILTIN_SYMBOL ) {
+    *len = builtin_symbols_len[sym_id];
+    return builtin_symbols[sym_id];
+  }
+
+  sym_id -= OFFSET_BUILTIN_SYMBOL;
+  if( sym_id < 0 ) return NULL;
+  if( sym_id >= sym_index_pos ) return NULL;
+
+  *len = sym_index[sym_id].len;
+  return sym_index[sym_id].cstr;
+}
+
+
 //================================================================
 /*! Search only.
 
@@ -270,14 +374,8 @@ const char * mrbc_symid_to_str(mrbc_sym sym_id)
 */
 mrbc_sym mrbc_search_symid( const char *str )
 {
-  mrbc_sym sym_id = search_builtin_symbol(str);
-  if( sym_id >= 0 ) return sym_id;
-
-  uint16_t h = calc_hash(str);
-  sym_id = search_index(h, str);
-  if( sym_id < 0 ) return sym_id;
-
-  return sym_id + OFFSET_BUILTIN_SYMBOL;
+  int len = strlen(str);
+  return search_symid( str, len, calc_hash(str, len) );
 }
 
 
@@ -290,16 +388,34 @@ mrbc_sym mrbc_search_symid( const char *str )
 */
 mrbc_value mrbc_symbol_new(struct VM *vm, const char *str)
 {
-  mrbc_sym sym_id = mrbc_search_symid( str );
+  return mrbc_symbol_new_len( vm, str, strlen(str) );
+}
+
+
+//================================================================
+/*! constructor with the length of string.
+
+  @param  vm	pointer to VM.
+  @param  str	String. must be terminated by '\0'.
+  @param  len	length of the string.
+  @return 	symbol object
+*/
+mrbc_value mrbc_symbol_new_len(struct VM *vm, const char *str, int len)
+{
+  uint32_t h = calc_hash(str, len);
+  mrbc_sym sym_id = search_symid( str, len, h );
   if( sym_id >= 0 ) goto DONE;
 
+  // check the capacity first, the buffer below is never freed.
+  if( reserve_index( str, len ) != 0 ) return mrbc_nil_value();
+
   // create symbol object dynamically.
-  int size = strlen(str) + 1;
-  char *buf = mrbc_raw_alloc_no_free(size);
+  char *buf = mrbc_raw_alloc_no_free(len + 1);
   if( buf == NULL ) return mrbc_nil_value();	// ENOMEM raise?
 
-  memcpy(buf, str, size);
-  sym_id = add_index( calc_hash(buf), buf );
+  memcpy(buf, str, len);
+  buf[len] = '\0';
+  sym_id = add_index( h, buf, len );
   if( sym_id >= 0 ) sym_id += OFFSET_BUILTIN_SYMBOL;
 
  DONE:
@@ -334,9 +450,19 @@ static void c_all_symbols(struct VM *vm, mrbc_value v[], int argc)
 */
 static void c_inspect(struct VM *vm, mrbc_value v[], int argc)
 {
-  const char *s = mrbc_symid_to_str( mrbc_symbol(v[0]) );
-  v[0] = mrbc_string_new_cstr(vm, ":");
-  mrbc_string_append_cstr(&v[0], s);
+  int len = 0;
+  const char *s = mrbc_symid_to_str_len( mrbc_symbol(v[0]), &len );
+  if( !s ) {
+    SET_NIL_RETURN();
+    return;
+  }
+  mrbc_value ret = mrbc_string_new(vm, NULL, len + 1);
+  if( !ret.string ) return;	// ENOMEM
+
+  char *p = (char *)ret.string->data;
+  p[0] = ':';
+  memcpy( p + 1, s, len + 1 );
+  SET_RETURN(ret);
 }
 
 
@@ -345,7 +471,13 @@ static void c_inspect(struct VM *vm, mrbc_value v[], int argc)
 */
 static void c_to_s(struct VM *vm, mrbc_value v[], int argc)
 {
-  v[0] = mrbc_string_new_cstr(vm, mrbc_symid_to_str( mrbc_symbol(v[0]) ));
+  int len = 0;
+  const char *s = mrbc_symid_to_str_len( mrbc_symbol(v[0]), &len );
+  if( !s ) {
+    SET_NIL_RETURN();
+    return;
+  }
+  v[0] = mrbc_string_new(vm, s, len);
 }
 #endif
 
@@ -373,10 +505,8 @@ static void c_to_s(struct VM *vm, mrbc_value v[], int argc)
 /* statistics
 
    (e.g.)
-   total = MAX_SYMBOLS_COUNT;
    mrbc_symbol_statistics( &used );
-   console_printf("Symbol table: %d/%d %d%% used.\n",
-                   used, total, 100 * used / total );
+   console_printf("Symbol table: %d used.\n", used );
 */
 void mrbc_symbol_statistics( int *total_used )
 {
@@ -4,326 +4,352 @@
 
 #if defined(MRBC_DEFINE_SYMBOL_TABLE)
 static const char *builtin_symbols[] = {
-  "!",
-  "!=",
-  "%",
-  "&",
-  "*",
+  "max",
+  "each_byte",
+  "loop",
+  "memory_statistics",
+  "acosh",
+  "new",
+  "min",
+  "StandardError",
+  "dup",
+  "each",
+  "empty?",
+  "include?",
+  "each_with_index",
+  "initialize",
+  "abs",
+  "log",
+  "is_a?",
+  "times",
+  "to_a",
+  "RUBY_VERSION",
+  "clear",
   "**",
-  "+",
-  "+@",
-  "-@",
-  "<<",
-  "<=>",
-  "===",
-  ">>",
-  "ArgumentError",
+  "%",
+  "ldexp",
+  "print",
+  "Object",
+  "[]",
+  "end_with?",
+  "merge",
+  "b",
+  "to_sym",
+  "delete_at",
+  "sort",
+  "pop",
+  "cosh",
+  "reject!",
+  "to_i",
+  "id2name",
+  "values",
+  "map!",
   "Array",
-  "Exception",
-  "FalseClass",
-  "Fixnum",
-  "Float",
-  "Hash",
-  "IndexError",
+  "strip!",
+  "ZeroDivisionError",
   "MRUBYC_VERSION",
-  "Math",
-  "NilClass",
-  "Object",
-  "Proc",
-  "RUBY_VERSION",
-  "Range",
+  "ord",
   "RuntimeError",
-  "StandardError",
   "String",
-  "Symbol",
-  "TrueClass",
-  "TypeError",
-  "ZeroDivisionError",
-  "[]",
-  "[]=",
-  "^",
-  "abs",
-  "acos",
-  "acosh",
-  "all_symbols",
+  "FalseClass",
+  "to_h",
+  "<<",
+  "NilClass",
+  "each_char",
+  "log2",
   "asin",
-  "asinh",
-  "at",
+  "sqrt",
+  "log10",
+  "collect",
   "atan",
-  "atan2",
-  "atanh",
-  "attr_accessor",
-  "attr_reader",
-  "b",
   "block_given?",
-  "call",
-  "cbrt",
-  "chomp",
-  "chomp!",
-  "chr",
-  "class",
-  "clear",
-  "collect",
-  "collect!",
-  "cos",
-  "cosh",
-  "count",
+  "exp",
   "delete",
-  "delete_at",
+  "+",
+  "[]=",
+  "!=",
+  "exclude_end?",
+  "chomp!",
+  "lstrip",
+  "Proc",
+  "p",
   "delete_if",
-  "dup",
-  "each",
-  "each_byte",
-  "each_char",
+  "index",
+  "merge!",
+  "map",
+  "tr",
+  "call",
+  "<=>",
   "each_index",
-  "each_with_index",
-  "empty?",
-  "end_with?",
-  "erf",
-  "erfc",
-  "exclude_end?",
-  "exp",
-  "first",
-  "getbyte",
+  "split",
   "has_key?",
-  "has_value?",
+  "size",
+  "minmax",
+  "first",
+  "^",
+  "last",
   "hypot",
-  "id2name",
-  "include?",
-  "index",
-  "initialize",
-  "inspect",
-  "instance_methods",
-  "instance_variables",
-  "intern",
-  "is_a?",
-  "join",
+  "raise",
   "key",
-  "keys",
-  "kind_of?",
-  "last",
-  "ldexp",
+  "|",
   "length",
-  "log",
-  "log10",
-  "log2",
-  "loop",
-  "lstrip",
-  "lstrip!",
-  "map",
-  "map!",
-  "max",
-  "memory_statistics",
-  "merge",
-  "merge!",
-  "message",
-  "min",
-  "minmax",
-  "new",
-  "nil?",
-  "object_id",
-  "ord",
-  "p",
-  "pop",
-  "print",
-  "printf",
+  "tanh",
+  "getbyte",
+  "instance_variables",
+  "sin",
   "push",
-  "puts",
-  "raise",
-  "reject",
-  "reject!",
+  "~",
   "rstrip",
-  "rstrip!",
-  "shift",
-  "sin",
-  "sinh",
-  "size",
+  "reject",
+  "acos",
+  "to_f",
+  "lstrip!",
+  "Math",
+  "Range",
+  "erfc",
+  "chr",
+  "&",
+  "instance_methods",
+  "at",
+  "Float",
+  "printf",
   "slice!",
-  "sort",
+  "kind_of?",
+  "attr_reader",
+  "TypeError",
+  "rstrip!",
+  "keys",
+  "chomp",
+  "Hash",
+  "IndexError",
+  "object_id",
+  "tan",
+  "all_symbols",
+  "atan2",
+  "count",
+  "intern",
+  "message",
+  "!",
+  "===",
   "sort!",
-  "split",
-  "sprintf",
-  "sqrt",
+  "join",
+  "cbrt",
+  "attr_accessor",
+  "nil?",
+  "sinh",
+  "atanh",
+  "ArgumentError",
+  "+@",
+  ">>",
+  "class",
+  "LocalJumpError",
+  "unshift",
   "start_with?",
-  "strip",
-  "strip!",
-  "tan",
-  "tanh",
-  "times",
-  "to_a",
-  "to_f",
-  "to_h",
-  "to_i",
+  "Fixnum",
+  "-@",
+  "puts",
+  "*",
+  "erf",
+  "Exception",
+  "has_value?",
+  "inspect",
+  "Symbol",
+  "sprintf",
+  "cos",
   "to_s",
-  "to_sym",
-  "tr",
+  "asinh",
+  "strip",
+  "shift",
   "tr!",
-  "unshift",
-  "values",
-  "|",
-  "~",
+  "collect!",
+  "TrueClass",
+};
+static const uint8_t builtin_symbols_len[] = {
+  3, 9, 4, 17, 5, 3, 3, 13, 3, 4, 6, 8, 15, 10, 3, 3,
+  5, 5, 4, 12, 5, 2, 1, 5, 5, 6, 2, 9, 5, 1, 6, 9,
+  4, 3, 4, 7, 4, 7, 6, 4, 5, 6, 17, 14, 3, 12, 6, 10,
+  4, 2, 8, 9, 4, 4, 4, 5, 7, 4, 12, 3, 6, 1, 3, 2,
+  12, 6, 6, 4, 1, 9, 5, 6, 3, 2, 4, 3, 10, 5, 8, 4,
+  6, 5, 1, 4, 5, 5, 3, 1, 6, 4, 7, 18, 3, 4, 1, 6,
+  6, 4, 4, 7, 4, 5, 4, 3, 1, 16, 2, 5, 6, 6, 8, 11,
+  9, 7, 4, 5, 4, 10, 9, 3, 11, 5, 5, 6, 7, 1, 3, 5,
+  4, 4, 13, 4, 4, 5, 13, 2, 2, 5, 14, 7, 11, 6, 2, 4,
+  1, 3, 9, 10, 7, 6, 7, 3, 4, 5, 5, 5, 3, 8, 9,
+};
+static const int16_t builtin_symbols_disp[] = {
+  1, 0, -124, -130, -147, -35, 21, 0, 0, -58, -67, 0, 0, 0, -21, -23,
+  0, -26, 0, 0, 0, 0, -151, 0, -117, 0, 7, 0, 2, 0, -123, 0,
+  0, -152, -138, 0, 2, -154, 0, 0, 0, 1, 0, 0, 0, 0, -104, -107,
+  0, 4, -109, 0, -111, -113, 0, 0, 0, 0, 0, -133, 0, -158, -157, -155,
+  -153, 0, 6, -150, 5, -148, 0, -137, 0, -135, -50, -43, -42, 0, -39, 1,
+  1, 0, 0, 0, -25, 0, 2, 0, -22, 0, 0, -11, -9, 0, 1, -2,
+  -100, 0, 0, -99, 0, 0, 0, -84, 0, -77, -75, 3, -73, -72, 0, 0,
+  3, 0, -63, -62, 0, -56, -51, -1, 0, 0, -70, 0, -74, -82, -85, 0,
+  -96, 0, 0, 0, -6, -20, 0, 2, 3, -32, -34, 0, 0, 0, 1, -149,
+  0, 0, 0, 1, -120, -119, 8, -108, 0, -102, 0, 0, -134, 8, 0,
 };
 #endif
 
 enum {
-  MRBC_SYMID_NOT = 0,
-  MRBC_SYMID_NOT_EQ = 1,
-  MRBC_SYMID_MOD = 2,
-  MRBC_SYMID_AND = 3,
-  MRBC_SYMID_MUL = 4,
-  MRBC_SYMID_MUL_MUL = 5,
-  MRBC_SYMID_PLUS = 6,
-  MRBC_SYMID_PLUS_AT = 7,
-  MRBC_SYMID_MINUS_AT = 8,
-  MRBC_SYMID_LT_LT = 9,
-  MRBC_SYMID_LT_EQ_GT = 10,
-  MRBC_SYMID_EQ_EQ_EQ = 11,
-  MRBC_SYMID_GT_GT = 12,
-  MRBC_SYMID_ArgumentError = 13,
-  MRBC_SYMID_Array = 14,
-  MRBC_SYMID_Exception = 15,
-  MRBC_SYMID_FalseClass = 16,
-  MRBC_SYMID_Fixnum = 17,
-  MRBC_SYMID_Float = 18,
-  MRBC_SYMID_Hash = 19,
-  MRBC_SYMID_IndexError = 20,
-  MRBC_SYMID_MRUBYC_VERSION = 21,
-  MRBC_SYMID_Math = 22,
-  MRBC_SYMID_NilClass = 23,
-  MRBC_SYMID_Object = 24,
-  MRBC_SYMID_Proc = 25,
-  MRBC_SYMID_RUBY_VERSION = 26,
-  MRBC_SYMID_Range = 27,
-  MRBC_SYMID_RuntimeError = 28,
-  MRBC_SYMID_StandardError = 29,
-  MRBC_SYMID_String = 30,
-  MRBC_SYMID_Symbol = 31,
-  MRBC_SYMID_TrueClass = 32,
-  MRBC_SYMID_TypeError = 33,
-  MRBC_SYMID_ZeroDivisionError = 34,
-  MRBC_SYMID_BL_BR = 35,
-  MRBC_SYMID_BL_BR_EQ = 36,
-  MRBC_SYMID_XOR = 37,
-  MRBC_SYMID_abs = 38,
-  MRBC_SYMID_acos = 39,
-  MRBC_SYMID_acosh = 40,
-  MRBC_SYMID_all_symbols = 41,
-  MRBC_SYMID_asin = 42,
-  MRBC_SYMID_asinh = 43,
-  MRBC_SYMID_at = 44,
-  MRBC_SYMID_atan = 45,
-  MRBC_SYMID_atan2 = 46,
-  MRBC_SYMID_atanh = 47,
-  MRBC_SYMID_attr_accessor = 48,
-  MRBC_SYMID_attr_reader = 49,
-  MRBC_SYMID_b = 50,
-  MRBC_SYMID_block_given_Q = 51,
-  MRBC_SYMID_call = 52,
-  MRBC_SYMID_cbrt = 53,
-  MRBC_SYMID_chomp = 54,
-  MRBC_SYMID_chomp_E = 55,
-  MRBC_SYMID_chr = 56,
-  MRBC_SYMID_class = 57,
-  MRBC_SYMID_clear = 58,
-  MRBC_SYMID_collect = 59,
-  MRBC_SYMID_collect_E = 60,
-  MRBC_SYMID_cos = 61,
-  MRBC_SYMID_cosh = 62,
-  MRBC_SYMID_count = 63,
-  MRBC_SYMID_delete = 64,
-  MRBC_SYMID_delete_at = 65,
-  MRBC_SYMID_delete_if = 66,
-  MRBC_SYMID_dup = 67,
-  MRBC_SYMID_each = 68,
-  MRBC_SYMID_each_byte = 69,
-  MRBC_SYMID_each_char = 70,
-  MRBC_SYMID_each_index = 71,
-  MRBC_SYMID_each_with_index = 72,
-  MRBC_SYMID_empty_Q = 73,
-  MRBC_SYMID_end_with_Q = 74,
-  MRBC_SYMID_erf = 75,
-  MRBC_SYMID_erfc = 76,
-  MRBC_SYMID_exclude_end_Q = 77,
-  MRBC_SYMID_exp = 78,
-  MRBC_SYMID_first = 79,
-  MRBC_SYMID_getbyte = 80,
-  MRBC_SYMID_has_key_Q = 81,
-  MRBC_SYMID_has_value_Q = 82,
-  MRBC_SYMID_hypot = 83,
-  MRBC_SYMID_id2name = 84,
-  MRBC_SYMID_include_Q = 85,
-  MRBC_SYMID_index = 86,
-  MRBC_SYMID_initialize = 87,
-  MRBC_SYMID_inspect = 88,
-  MRBC_SYMID_instance_methods = 89,
-  MRBC_SYMID_instance_variables = 90,
-  MRBC_SYMID_intern = 91,
-  MRBC_SYMID_is_a_Q = 92,
-  MRBC_SYMID_join = 93,
-  MRBC_SYMID_key = 94,
-  MRBC_SYMID_keys = 95,
-  MRBC_SYMID_kind_of_Q = 96,
-  MRBC_SYMID_last = 97,
-  MRBC_SYMID_ldexp = 98,
-  MRBC_SYMID_length = 99,
-  MRBC_SYMID_log = 100,
-  MRBC_SYMID_log10 = 101,
-  MRBC_SYMID_log2 = 102,
-  MRBC_SYMID_loop = 103,
-  MRBC_SYMID_lstrip = 104,
-  MRBC_SYMID_lstrip_E = 105,
-  MRBC_SYMID_map = 106,
-  MRBC_SYMID_map_E = 107,
-  MRBC_SYMID_max = 108,
-  MRBC_SYMID_memory_statistics = 109,
-  MRBC_SYMID_merge = 110,
-  MRBC_SYMID_merge_E = 111,
-  MRBC_SYMID_message = 112,
-  MRBC_SYMID_min = 113,
-  MRBC_SYMID_minmax = 114,
-  MRBC_SYMID_new = 115,
-  MRBC_SYMID_nil_Q = 116,
-  MRBC_SYMID_object_id = 117,
-  MRBC_SYMID_ord = 118,
-  MRBC_SYMID_p = 119,
-  MRBC_SYMID_pop = 120,
-  MRBC_SYMID_print = 121,
-  MRBC_SYMID_printf = 122,
-  MRBC_SYMID_push = 123,
-  MRBC_SYMID_puts = 124,
-  MRBC_SYMID_raise = 125,
-  MRBC_SYMID_reject = 126,
-  MRBC_SYMID_reject_E = 127,
-  MRBC_SYMID_rstrip = 128,
-  MRBC_SYMID_rstrip_E = 129,
-  MRBC_SYMID_shift = 130,
-  MRBC_SYMID_sin = 131,
+  MRBC_SYMID_max = 0,
+  MRBC_SYMID_each_byte = 1,
+  MRBC_SYMID_loop = 2,
+  MRBC_SYMID_memory_statistics = 3,
+  MRBC_SYMID_acosh = 4,
+  MRBC_SYMID_new = 5,
+  MRBC_SYMID_min = 6,
+  MRBC_SYMID_StandardError = 7,
+  MRBC_SYMID_dup = 8,
+  MRBC_SYMID_each = 9,
+  MRBC_SYMID_empty_Q = 10,
+  MRBC_SYMID_include_Q = 11,
+  MRBC_SYMID_each_with_index = 12,
+  MRBC_SYMID_initialize = 13,
+  MRBC_SYMID_abs = 14,
+  MRBC_SYMID_log = 15,
+  MRBC_SYMID_is_a_Q = 16,
+  MRBC_SYMID_times = 17,
+  MRBC_SYMID_to_a = 18,
+  MRBC_SYMID_RUBY_VERSION = 19,
+  MRBC_SYMID_clear = 20,
+  MRBC_SYMID_MUL_MUL = 21,
+  MRBC_SYMID_MOD = 22,
+  MRBC_SYMID_ldexp = 23,
+  MRBC_SYMID_print = 24,
+  MRBC_SYMID_Object = 25,
+  MRBC_SYMID_BL_BR = 26,
+  MRBC_SYMID_end_with_Q = 27,
+  MRBC_SYMID_merge = 28,
+  MRBC_SYMID_b = 29,
+  MRBC_SYMID_to_sym = 30,
+  MRBC_SYMID_delete_at = 31,
+  MRBC_SYMID_sort = 32,
+  MRBC_SYMID_pop = 33,
+  MRBC_SYMID_cosh = 34,
+  MRBC_SYMID_reject_E = 35,
+  MRBC_SYMID_to_i = 36,
+  MRBC_SYMID_id2name = 37,
+  MRBC_SYMID_values = 38,
+  MRBC_SYMID_map_E = 39,
+  MRBC_SYMID_Array = 40,
+  MRBC_SYMID_strip_E = 41,
+  MRBC_SYMID_ZeroDivisionError = 42,
+  MRBC_SYMID_MRUBYC_VERSION = 43,
+  MRBC_SYMID_ord = 44,
+  MRBC_SYMID_RuntimeError = 45,
+  MRBC_SYMID_String = 46,
+  MRBC_SYMID_FalseClass = 47,
+  MRBC_SYMID_to_h = 48,
+  MRBC_SYMID_LT_LT = 49,
+  MRBC_SYMID_NilClass = 50,
+  MRBC_SYMID_each_char = 51,
+  MRBC_SYMID_log2 = 52,
+  MRBC_SYMID_asin = 53,
+  MRBC_SYMID_sqrt = 54,
+  MRBC_SYMID_log10 = 55,
+  MRBC_SYMID_collect = 56,
+  MRBC_SYMID_atan = 57,
+  MRBC_SYMID_block_given_Q = 58,
+  MRBC_SYMID_exp = 59,
+  MRBC_SYMID_delete = 60,
+  MRBC_SYMID_PLUS = 61,
+  MRBC_SYMID_BL_BR_EQ = 62,
+  MRBC_SYMID_NOT_EQ = 63,
+  MRBC_SYMID_exclude_end_Q = 64,
+  MRBC_SYMID_chomp_E = 65,
+  MRBC_SYMID_lstrip = 66,
+  MRBC_SYMID_Proc = 67,
+  MRBC_SYMID_p = 68,
+  MRBC_SYMID_delete_if = 69,
+  MRBC_SYMID_index = 70,
+  MRBC_SYMID_merge_E = 71,
+  MRBC_SYMID_map = 72,
+  MRBC_SYMID_tr = 73,
+  MRBC_SYMID_call = 74,
+  MRBC_SYMID_LT_EQ_GT = 75,
+  MRBC_SYMID_each_index = 76,
+  MRBC_SYMID_split = 77,
+  MRBC_SYMID_has_key_Q = 78,
+  MRBC_SYMID_size = 79,
+  MRBC_SYMID_minmax = 80,
+  MRBC_SYMID_first = 81,
+  MRBC_SYMID_XOR = 82,
+  MRBC_SYMID_last = 83,
+  MRBC_SYMID_hypot = 84,
+  MRBC_SYMID_raise = 85,
+  MRBC_SYMID_key = 86,
+  MRBC_SYMID_OR = 87,
+  MRBC_SYMID_length = 88,
+  MRBC_SYMID_tanh = 89,
+  MRBC_SYMID_getbyte = 90,
+  MRBC_SYMID_instance_variables = 91,
+  MRBC_SYMID_sin = 92,
+  MRBC_SYMID_push = 93,
+  MRBC_SYMID_NEG = 94,
+  MRBC_SYMID_rstrip = 95,
+  MRBC_SYMID_reject = 96,
+  MRBC_SYMID_acos = 97,
+  MRBC_SYMID_to_f = 98,
+  MRBC_SYMID_lstrip_E = 99,
+  MRBC_SYMID_Math = 100,
+  MRBC_SYMID_Range = 101,
+  MRBC_SYMID_erfc = 102,
+  MRBC_SYMID_chr = 103,
+  MRBC_SYMID_AND = 104,
+  MRBC_SYMID_instance_methods = 105,
+  MRBC_SYMID_at = 106,
+  MRBC_SYMID_Float = 107,
+  MRBC_SYMID_printf = 108,
+  MRBC_SYMID_slice_E = 109,
+  MRBC_SYMID_kind_of_Q = 110,
+  MRBC_SYMID_attr_reader = 111,
+  MRBC_SYMID_TypeError = 112,
+  MRBC_SYMID_rstrip_E = 113,
+  MRBC_SYMID_keys = 114,
+  MRBC_SYMID_chomp = 115,
+  MRBC_SYMID_Hash = 116,
+  MRBC_SYMID_IndexError = 117,
+  MRBC_SYMID_object_id = 118,
+  MRBC_SYMID_tan = 119,
+  MRBC_SYMID_all_symbols = 120,
+  MRBC_SYMID_atan2 = 121,
+  MRBC_SYMID_count = 122,
+  MRBC_SYMID_intern = 123,
+  MRBC_SYMID_message = 124,
+  MRBC_SYMID_NOT = 125,
+  MRBC_SYMID_EQ_EQ_EQ = 126,
+  MRBC_SYMID_sort_E = 127,
+  MRBC_SYMID_join = 128,
+  MRBC_SYMID_cbrt = 129,
+  MRBC_SYMID_attr_accessor = 130,
+  MRBC_SYMID_nil_Q = 131,
   MRBC_SYMID_sinh = 132,
-  MRBC_SYMID_size = 133,
-  MRBC_SYMID_slice_E = 134,
-  MRBC_SYMID_sort = 135,
-  MRBC_SYMID_sort_E = 136,
-  MRBC_SYMID_split = 137,
-  MRBC_SYMID_sprintf = 138,
-  MRBC_SYMID_sqrt = 139,
+  MRBC_SYMID_atanh = 133,
+  MRBC_SYMID_ArgumentError = 134,
+  MRBC_SYMID_PLUS_AT = 135,
+  MRBC_SYMID_GT_GT = 136,
+  MRBC_SYMID_class = 137,
+  MRBC_SYMID_LocalJumpError = 138,
+  MRBC_SYMID_unshift = 139,
   MRBC_SYMID_start_with_Q = 140,
-  MRBC_SYMID_strip = 141,
-  MRBC_SYMID_strip_E = 142,
-  MRBC_SYMID_tan = 143,
-  MRBC_SYMID_tanh = 144,
-  MRBC_SYMID_times = 145,
-  MRBC_SYMID_to_a = 146,
-  MRBC_SYMID_to_f = 147,
-  MRBC_SYMID_to_h = 148,
-  MRBC_SYMID_to_i = 149,
-  MRBC_SYMID_to_s = 150,
-  MRBC_SYMID_to_sym = 151,
-  MRBC_SYMID_tr = 152,
-  MRBC_SYMID_tr_E = 153,
-  MRBC_SYMID_unshift = 154,
-  MRBC_SYMID_values = 155,
-  MRBC_SYMID_OR = 156,
-  MRBC_SYMID_NEG = 157,
+  MRBC_SYMID_Fixnum = 141,
+  MRBC_SYMID_MINUS_AT = 142,
+  MRBC_SYMID_puts = 143,
+  MRBC_SYMID_MUL = 144,
+  MRBC_SYMID_erf = 145,
+  MRBC_SYMID_Exception = 146,
+  MRBC_SYMID_has_value_Q = 147,
+  MRBC_SYMID_inspect = 148,
+  MRBC_SYMID_Symbol = 149,
+  MRBC_SYMID_sprintf = 150,
+  MRBC_SYMID_cos = 151,
+  MRBC_SYMID_to_s = 152,
+  MRBC_SYMID_asinh = 153,
+  MRBC_SYMID_strip = 154,
+  MRBC_SYMID_shift = 155,
+  MRBC_SYMID_tr_E = 156,
+  MRBC_SYMID_collect_E = 157,
+  MRBC_SYMID_TrueClass = 158,
 };
 
 #define MRB_SYM(sym) MRBC_SYMID_##sym
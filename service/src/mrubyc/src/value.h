@@ -108,6 +108,7 @@ typedef enum {
   E_NOTIMP_ERROR,
   E_FLOATDOMAIN_ERROR,
   E_KEY_ERROR,
+  E_SYSTEMSTACK_ERROR,
 
   // Internal Error
   E_BYTECODE_ERROR,
@@ -241,7 +242,7 @@ typedef struct RObject mrbc_value;
 #define GET_ARY_ARG(n)		(v[(n)])
 #define GET_ARG(n)		(v[(n)])
 #define GET_FLOAT_ARG(n)	(v[(n)].d)
-#define GET_STRING_ARG(n)	(v[(n)].string->data)
+#define GET_STRING_ARG(n)	((uint8_t *)mrbc_string_cstr(&v[(n)]))	// NULL if ENOMEM
 
 #if defined(MRBC_DEBUG)
 #define MRBC_INIT_OBJECT_HEADER(p, t)  (p)->ref_count = 1; (p)->type[0] = (t)[0]; (p)->type[1] = (t)[1]
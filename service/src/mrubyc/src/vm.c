@@ -24,7 +24,9 @@
 #include "opcode.h"
 #include "class.h"
 #include "symbol.h"
+#include "symbol_builtin.h"
 #include "console.h"
+#include "error.h"
 
 #include "c_object.h"
 #include "c_string.h"
@@ -51,34 +53,73 @@ static uint16_t free_vm_bitmap[MAX_VM_COUNT / 16 + 1];
 
 #define CALL_MAXARGS 255
 
-//================================================================
-/*! get sym[n] from symbol table in irep
+// mark of irep->literal[]. the literal was used only once.
+#define LITERAL_USED_ONCE ((struct RString *)1)
 
-  @param  vm	Pointer to VM
-  @param  n	n th
-  @return	symbol name string
+//================================================================
+/*! display "not supported" message
 */
-static const char * mrbc_get_irep_symbol( struct VM *vm, int n )
+static void not_supported(void)
 {
-  const uint8_t *p = vm->pc_irep->ptr_to_sym;
-  int cnt = bin_to_uint32(p);
-  if( n >= cnt ) return 0;
-  p += 4;
-  while( n > 0 ) {
-    uint16_t s = bin_to_uint16(p);
-    p += 2+s+1;   // size(2 bytes) + symbol len + '\0'
-    n--;
-  }
-  return (char *)p+2;  // skip size(2 bytes)
+  console_printf("Not supported!\n");
 }
 
 
 //================================================================
-/*! display "not supported" message
+/*! Call the found method
+
+  @param  vm		pointer of VM.
+  @param  method	pointer to found method.
+  @param  regs		pointer to regs
+  @param  a		operand a
+  @param  c		operand c
+  @retval 0  No error.
 */
-static void not_supported(void)
+static int send_by_method( struct VM *vm, const mrbc_method *method, mrbc_value *regs, int a, int c )
 {
-  console_printf("Not supported!\n");
+  // if SENDV or SENDVB, params are in one Array
+  int flag_array_arg = ( c == CALL_MAXARGS );
+  int bidx = a + (flag_array_arg ? 1 : c) + 1;
+
+  // call C method.
+  if( method->c_func ) {
+    mrbc_callinfo *callinfo = vm->callinfo_tail;
+    method->func(vm, regs + a, flag_array_arg ? 1 : c);
+    // called the block. (Proc#call or native iterator)
+    if( vm->callinfo_tail != callinfo ) return 0;
+    // the task is parked. keep the arguments and run this instruction
+    // again when it is resumed.
+    if( vm->flag_retry ) {
+      vm->flag_retry = 0;
+      vm->inst--;
+      return 0;
+    }
+    if( vm->exc != NULL || vm->exc_pending != NULL ) return 0;
+
+    int release_reg = a+1;
+    while( release_reg <= bidx ) {
+      mrbc_decref_empty(&regs[release_reg]);
+      release_reg++;
+    }
+    return 0;
+  }
+
+  // call Ruby method.
+  if( regs + a + method->irep->nregs > vm->regs + MAX_REGS_SIZE ) {
+    return mrbc_stack_overflow(vm);
+  }
+  mrbc_callinfo *callinfo = mrbc_push_callinfo(vm, method->sym_id, a, c);
+  if( !callinfo ) return -1;
+  callinfo->own_class = method->cls;
+
+  // target irep
+  vm->pc_irep = method->irep;
+  vm->inst = method->irep->code;
+
+  // new regs
+  vm->current_regs += a;
+
+  return 0;
 }
 
 
@@ -97,13 +138,9 @@ static int send_by_name( struct VM *vm, const char *method_name, mrbc_value *reg
 {
   mrbc_value *recv = &regs[a];
 
-  // if SENDV or SENDVB, params are in one Array
-  int flag_array_arg = ( c == CALL_MAXARGS );
-  if( flag_array_arg ) c = 1;
-
   // if not OP_SENDB, blcok does not exist
-  int bidx = a + c + 1;
   if( !is_sendb ){
+    int bidx = a + (c == CALL_MAXARGS ? 1 : c) + 1;
     mrbc_decref( &regs[bidx] );
     regs[bidx].tt = MRBC_TT_NIL;
   }
@@ -118,33 +155,74 @@ static int send_by_name( struct VM *vm, const char *method_name, mrbc_value *reg
     return 1;
   }
 
-  // call C method.
-  if( method.c_func ) {
-    method.func(vm, regs + a, c);
-    if( method.func == c_proc_call ) return 0;
-    if( vm->exc != NULL || vm->exc_pending != NULL ) return 0;
+  return send_by_method( vm, &method, regs, a, c );
+}
 
-    int release_reg = a+1;
-    while( release_reg <= bidx ) {
-      mrbc_decref_empty(&regs[release_reg]);
-      release_reg++;
+
+//================================================================
+/*! Method call by irep symbol, using inline method cache.
+
+  The cache entry is selected by the symbol index of the send site,
+  and hits while the receiver class and mrbc_method_epoch are equal.
+  The loader puts the method names first in irep->syms, so the cache
+  has only irep->nsend entries.
+
+  @param  vm		pointer of VM.
+  @param  n		symbol index in current irep.
+  @param  regs		pointer to regs
+  @param  a		operand a
+  @param  c		operand c
+  @param  is_sendb	Is called from OP_SENDB?
+  @retval 0  No error.
+*/
+static int send_by_irep_symbol( struct VM *vm, int n, mrbc_value *regs, int a, int c, int is_sendb )
+{
+  mrbc_value *recv = &regs[a];
+
+  // if not OP_SENDB, blcok does not exist
+  if( !is_sendb ){
+    int bidx = a + (c == CALL_MAXARGS ? 1 : c) + 1;
+    mrbc_decref( &regs[bidx] );
+    regs[bidx].tt = MRBC_TT_NIL;
+  }
+
+  mrbc_class *cls = find_class_by_object(recv);
+  mrbc_irep *irep = vm->pc_irep;
+  mrbc_method_cache *cache = irep->method_cache;
+
+#if MRBC_USE_METHOD_CACHE
+  // allocate cache at first send in this irep.
+  if( !cache && irep->nsend ) {
+    int size = sizeof(mrbc_method_cache) * irep->nsend;
+    cache = mrbc_raw_alloc( size );
+    if( cache ) {
+      memset( cache, 0, size );
+      irep->method_cache = cache;
     }
-    return 0;
   }
+#endif
 
-  // call Ruby method.
-  if( flag_array_arg ) c = CALL_MAXARGS;
-  mrbc_callinfo *callinfo = mrbc_push_callinfo(vm, sym_id, a, c);
-  callinfo->own_class = method.cls;
+  // cache hit?
+  if( cache && cache[n].cls == cls && cache[n].epoch == mrbc_method_epoch ) {
+    return send_by_method( vm, &cache[n].method, regs, a, c );
+  }
 
-  // target irep
-  vm->pc_irep = method.irep;
-  vm->inst = method.irep->code;
+  mrbc_sym sym_id = irep->syms[n];
+  mrbc_method method;
 
-  // new regs
-  vm->current_regs += a;
+  if( mrbc_find_method( &method, cls, sym_id ) == 0 ) {
+    console_printf("Undefined local variable or method '%s' for %s\n",
+		   symid_to_str( sym_id ), symid_to_str( cls->sym_id ));
+    return 1;
+  }
 
-  return 0;
+  if( cache ) {
+    cache[n].cls = cls;
+    cache[n].epoch = mrbc_method_epoch;
+    cache[n].method = method;
+  }
+
+  return send_by_method( vm, &method, regs, a, c );
 }
 
 
@@ -165,8 +243,10 @@ void mrbc_cleanup_vm(void)
 */
 const char *mrbc_get_callee_name( struct VM *vm )
 {
-  uint8_t rb = vm->inst[-2];
-  return mrbc_get_irep_symbol(vm, rb);
+  const mrbc_inst *inst = &vm->inst[-1];
+  int n = (inst->op == OP_SEND || inst->op == OP_SENDB) ? inst->bc.b : inst->b;
+
+  return symid_to_str( vm->pc_irep->syms[n] );
 }
 
 
@@ -201,28 +281,69 @@ void mrbc_irep_free(mrbc_irep *irep)
   int i;
 
   // release pools.
-  for( i = 0; i < irep->plen; i++ ) {
-    mrbc_raw_free( irep->pools[i] );
+  //  (the arrays may be partly filled, if the loader failed.)
+  if( irep->pools ) {
+    for( i = 0; i < irep->plen; i++ ) {
+      if( irep->pools[i] ) mrbc_raw_free( irep->pools[i] );
+    }
+    mrbc_raw_free( irep->pools );
   }
-  if( irep->plen ) mrbc_raw_free( irep->pools );
 
   // release child ireps.
-  for( i = 0; i < irep->rlen; i++ ) {
-    mrbc_irep_free( irep->reps[i] );
+  if( irep->reps ) {
+    for( i = 0; i < irep->rlen; i++ ) {
+      if( irep->reps[i] ) mrbc_irep_free( irep->reps[i] );
+    }
+    mrbc_raw_free( irep->reps );
   }
-  if( irep->rlen ) mrbc_raw_free( irep->reps );
+
+  if( irep->code ) mrbc_raw_free( irep->code );
+  if( irep->syms ) mrbc_raw_free( irep->syms );
+  if( irep->method_cache ) mrbc_raw_free( irep->method_cache );
+  if( irep->ivar_cache ) mrbc_raw_free( irep->ivar_cache );
+#if MRBC_USE_STRING
+  if( irep->literal ) {
+    for( i = 0; i < irep->plen; i++ ) {
+      if( !irep->literal[i] || irep->literal[i] == LITERAL_USED_ONCE ) continue;
+      mrbc_value v = {.tt = MRBC_TT_STRING, .string = irep->literal[i]};
+      mrbc_decref( &v );
+    }
+    mrbc_raw_free( irep->literal );
+  }
+#endif
 
   mrbc_raw_free( irep );
 }
 
 
+//================================================================
+/*! Stop the VM (task) by SystemStackError.
+
+  @param  vm	Pointer to VM.
+  @retval -1	Always. (returned to mrbc_vm_run)
+*/
+int mrbc_stack_overflow( struct VM *vm )
+{
+  console_printf("SystemStackError: stack level too deep\n");
+  vm->error_code = E_SYSTEMSTACK_ERROR;
+  vm->flag_preemption = 1;
+
+  return -1;
+}
+
+
 //================================================================
 /*! Push current status to callinfo stack
+
+  @return	Pointer to the pushed callinfo, or NULL if stack overflow.
 */
 mrbc_callinfo * mrbc_push_callinfo( struct VM *vm, mrbc_sym method_id, int reg_offset, int n_args )
 {
-  mrbc_callinfo *callinfo = mrbc_alloc(vm, sizeof(mrbc_callinfo));
-  if( !callinfo ) return callinfo;
+  if( vm->callinfo_top == vm->callinfo_stack + MAX_CALLINFO_COUNT ) {
+    mrbc_stack_overflow(vm);
+    return NULL;
+  }
+  mrbc_callinfo *callinfo = vm->callinfo_top++;
 
   callinfo->current_regs = vm->current_regs;
   callinfo->pc_irep = vm->pc_irep;
@@ -232,6 +353,7 @@ mrbc_callinfo * mrbc_push_callinfo( struct VM *vm, mrbc_sym method_id, int reg_o
   callinfo->n_args = n_args;
   callinfo->target_class = vm->target_class;
   callinfo->own_class = 0;
+  callinfo->iterator = 0;
   callinfo->prev = vm->callinfo_tail;
   vm->callinfo_tail = callinfo;
 
@@ -239,6 +361,23 @@ mrbc_callinfo * mrbc_push_callinfo( struct VM *vm, mrbc_sym method_id, int reg_o
 }
 
 
+//================================================================
+/*! Release the callinfo removed from callinfo_tail list.
+
+  Frames in callinfo_stack are released with all frames above it.
+  The others are ensure records moved from exception_tail list.
+*/
+static void free_callinfo( struct VM *vm, mrbc_callinfo *callinfo )
+{
+  if( vm->callinfo_stack <= callinfo &&
+      callinfo < vm->callinfo_stack + MAX_CALLINFO_COUNT ) {
+    vm->callinfo_top = callinfo;
+  } else {
+    mrbc_free(vm, callinfo);
+  }
+}
+
+
 //================================================================
 /*! Pop current status from callinfo stack
 */
@@ -253,7 +392,99 @@ void mrbc_pop_callinfo( struct VM *vm )
   vm->inst = callinfo->inst;
   vm->target_class = callinfo->target_class;
 
-  mrbc_free(vm, callinfo);
+  free_callinfo(vm, callinfo);
+}
+
+
+//================================================================
+/*! Call the block from the native iterator.
+
+  Pushes the block frame and returns; the VM runs the block after the
+  C method returned. When the block returns, the VM calls next(vm, v, 0)
+  with the return value of the block in v[MRBC_ITERATOR_REGS].
+  The iterator keeps its state in v[2] and v[3], and finishes by
+  mrbc_iterator_end() without calling this function.
+
+  @param  vm	pointer of VM.
+  @param  v	registers of the iterator. v[1] is the block.
+  @param  next	function to call after the block.
+  @param  argc	# of arguments to the block.
+  @param  args	arguments to the block. (incref'd here)
+  @retval 0	No error.
+*/
+int mrbc_iterator_yield( struct VM *vm, mrbc_value v[], mrbc_func_t next, int argc, const mrbc_value *args )
+{
+  assert( v[1].tt == MRBC_TT_PROC );
+
+  mrbc_value *regs = v + MRBC_ITERATOR_REGS;
+  mrbc_irep *irep = v[1].proc->irep;
+  if( regs + irep->nregs > vm->regs + MAX_REGS_SIZE ||
+      regs + argc >= vm->regs + MAX_REGS_SIZE ) {
+    return mrbc_stack_overflow(vm);
+  }
+
+  mrbc_callinfo *callinfo_self = v[1].proc->callinfo_self;
+  mrbc_callinfo *callinfo = mrbc_push_callinfo(vm,
+			(callinfo_self ? callinfo_self->method_id : 0),
+			regs - vm->current_regs, argc);
+  if( !callinfo ) return -1;
+
+  if( callinfo_self ) {
+    callinfo->own_class = callinfo_self->own_class;
+  }
+  callinfo->iterator = next;
+
+  // block and arguments.
+  mrbc_decref( &regs[0] );
+  regs[0] = v[1];
+  mrbc_incref( &regs[0] );
+
+  int i;
+  for( i = 0; i < argc; i++ ) {
+    mrbc_decref( &regs[i+1] );
+    regs[i+1] = args[i];
+    mrbc_incref( &regs[i+1] );
+  }
+
+  // target irep
+  vm->pc_irep = irep;
+  vm->inst = irep->code;
+  vm->current_regs = regs;
+
+  return 0;
+}
+
+
+//================================================================
+/*! Check the block of the native iterator.
+
+  @param  vm	pointer of VM.
+  @param  v	registers of the iterator. v[1] is the block.
+  @retval 0	the block is given.
+  @retval -1	no block. LocalJumpError is raised.
+*/
+int mrbc_iterator_check_block( struct VM *vm, mrbc_value v[] )
+{
+  if( v[1].tt == MRBC_TT_PROC ) return 0;
+
+  mrbc_raise_exception( vm, mrbc_class_localjumperror );
+  return -1;
+}
+
+
+//================================================================
+/*! Finish the native iterator.
+
+  Releases the block and the state. v[0] is left as the return value.
+
+  @param  v	registers of the iterator.
+*/
+void mrbc_iterator_end( mrbc_value v[] )
+{
+  int i;
+  for( i = 1; i <= MRBC_ITERATOR_REGS; i++ ) {
+    mrbc_decref_empty( &v[i] );
+  }
 }
 
 
@@ -388,7 +619,7 @@ static inline int op_loadi_n( mrbc_vm *vm, mrbc_value *regs )
   FETCH_B();
 
   // get n
-  int opcode = vm->inst[-2];
+  int opcode = vm->inst[-1].op;
   int n = opcode - OP_LOADI_0;
 
   mrbc_decref(&regs[a]);
@@ -411,8 +642,7 @@ static inline int op_loadsym( mrbc_vm *vm, mrbc_value *regs )
 {
   FETCH_BB();
 
-  const char *sym_name = mrbc_get_irep_symbol(vm, b);
-  mrbc_sym sym_id = str_to_symid(sym_name);
+  mrbc_sym sym_id = vm->pc_irep->syms[b];
 
   mrbc_decref(&regs[a]);
   regs[a].tt = MRBC_TT_SYMBOL;
@@ -518,8 +748,7 @@ static inline int op_getgv( mrbc_vm *vm, mrbc_value *regs )
 {
   FETCH_BB();
 
-  const char *sym_name = mrbc_get_irep_symbol(vm, b);
-  mrbc_sym sym_id = str_to_symid(sym_name);
+  mrbc_sym sym_id = vm->pc_irep->syms[b];
 
   mrbc_decref(&regs[a]);
   mrbc_value *v = mrbc_get_global(sym_id);
@@ -547,8 +776,10 @@ static inline int op_setgv( mrbc_vm *vm, mrbc_value *regs )
 {
   FETCH_BB();
 
-  const char *sym_name = mrbc_get_irep_symbol(vm, b);
-  mrbc_sym sym_id = str_to_symid(sym_name);
+  mrbc_sym sym_id = vm->pc_irep->syms[b];
+#if MRBC_USE_STRING
+  if( mrbc_type(regs[a]) == MRBC_TT_STRING ) mrbc_string_trim(&regs[a]);
+#endif
   mrbc_incref(&regs[a]);
   mrbc_set_global(sym_id, &regs[a]);
 
@@ -556,6 +787,45 @@ static inline int op_setgv( mrbc_vm *vm, mrbc_value *regs )
 }
 
 
+//================================================================
+/*! find the ivar slot of self, using inline ivar cache.
+
+  @param  vm		pointer of VM.
+  @param  self		pointer to self.
+  @param  n		symbol index in current irep.
+  @return		slot number, or -1 if self does not have the ivar.
+*/
+static int find_ivar_slot( struct VM *vm, mrbc_value *self, int n )
+{
+  if( self->tt != MRBC_TT_OBJECT ) return -1;
+
+  const mrbc_shape *shape = self->instance->shape;
+  if( !shape ) return -1;
+
+  mrbc_irep *irep = vm->pc_irep;
+  mrbc_ivar_cache *cache = irep->ivar_cache;
+
+  // cache hit?
+  if( cache && cache[n].shape == shape ) return cache[n].slot;
+
+  int slot = mrbc_shape_find_slot( shape, irep->syms[n] ); // without '@'
+  if( slot < 0 ) return -1;
+
+  // allocate cache at first hit in this irep.
+  if( !cache ) {
+    int size = sizeof(mrbc_ivar_cache) * irep->slen;
+    cache = mrbc_raw_alloc( size );
+    if( !cache ) return slot;
+    memset( cache, 0, size );
+    irep->ivar_cache = cache;
+  }
+  cache[n].shape = shape;
+  cache[n].slot = slot;
+
+  return slot;
+}
+
+
 //================================================================
 /*! OP_GETIV
 
@@ -569,11 +839,16 @@ static inline int op_getiv( mrbc_vm *vm, mrbc_value *regs )
 {
   FETCH_BB();
 
-  const char *sym_name = mrbc_get_irep_symbol(vm, b);
-  mrbc_sym sym_id = str_to_symid(sym_name+1);   // skip '@'
   mrbc_value *self = mrbc_get_self( vm, regs );
+  int slot = find_ivar_slot( vm, self, b );
   mrbc_decref(&regs[a]);
-  regs[a] = mrbc_instance_getiv(self, sym_id);
+
+  if( slot < 0 ) {
+    regs[a] = mrbc_nil_value();
+  } else {
+    regs[a] = self->instance->ivar[slot];
+    mrbc_incref(&regs[a]);
+  }
 
   return 0;
 }
@@ -592,10 +867,18 @@ static inline int op_setiv( mrbc_vm *vm, mrbc_value *regs )
 {
   FETCH_BB();
 
-  const char *sym_name = mrbc_get_irep_symbol(vm, b);
-  mrbc_sym sym_id = str_to_symid(sym_name+1);   // skip '@'
   mrbc_value *self = mrbc_get_self( vm, regs );
-  mrbc_instance_setiv(self, sym_id, &regs[a]);
+  int slot = find_ivar_slot( vm, self, b );
+
+  if( slot < 0 ) {
+    // new ivar. makes shape transition.
+    mrbc_instance_setiv(self, vm->pc_irep->syms[b], &regs[a]);
+  } else {
+    mrbc_value *iv = &self->instance->ivar[slot];
+    mrbc_incref(&regs[a]);
+    mrbc_decref(iv);
+    *iv = regs[a];
+  }
 
   return 0;
 }
@@ -614,8 +897,7 @@ static inline int op_getconst( mrbc_vm *vm, mrbc_value *regs )
 {
   FETCH_BB();
 
-  const char *sym_name = mrbc_get_irep_symbol(vm, b);
-  mrbc_sym sym_id = str_to_symid(sym_name);
+  mrbc_sym sym_id = vm->pc_irep->syms[b];
   mrbc_class *cls = NULL;
   mrbc_value *v;
 
@@ -628,7 +910,8 @@ static inline int op_getconst( mrbc_vm *vm, mrbc_value *regs )
 
   v = mrbc_get_const(sym_id);
   if( v == NULL ) {		// raise?
-    console_printf( "NameError: uninitialized constant %s\n", sym_name );
+    console_printf( "NameError: uninitialized constant %s\n",
+		    symid_to_str( sym_id ));
     return 0;
   }
 
@@ -654,9 +937,12 @@ static inline int op_setconst( mrbc_vm *vm, mrbc_value *regs )
 {
   FETCH_BB();
 
-  const char *sym_name = mrbc_get_irep_symbol(vm, b);
-  mrbc_sym sym_id = str_to_symid(sym_name);
+  mrbc_sym sym_id = vm->pc_irep->syms[b];
 
+#if MRBC_USE_STRING
+  // constant will be kept long-term.
+  if( mrbc_type(regs[a]) == MRBC_TT_STRING ) mrbc_string_trim(&regs[a]);
+#endif
   mrbc_incref(&regs[a]);
   if( mrbc_type(regs[0]) == MRBC_TT_CLASS ) {
     mrbc_set_class_const(regs[0].cls, sym_id, &regs[a]);
@@ -681,8 +967,7 @@ static inline int op_getmcnst( mrbc_vm *vm, mrbc_value *regs )
 {
   FETCH_BB();
 
-  const char *sym_name = mrbc_get_irep_symbol(vm, b);
-  mrbc_sym sym_id = str_to_symid(sym_name);
+  mrbc_sym sym_id = vm->pc_irep->syms[b];
   mrbc_class *cls = regs[a].cls;
   mrbc_value *v;
 
@@ -690,7 +975,7 @@ static inline int op_getmcnst( mrbc_vm *vm, mrbc_value *regs )
     cls = cls->super;
     if( !cls ) {	// raise?
       console_printf( "NameError: uninitialized constant %s::%s\n",
-		      symid_to_str( regs[a].cls->sym_id ), sym_name );
+		      symid_to_str( regs[a].cls->sym_id ), symid_to_str( sym_id ));
       return 0;
     }
   }
@@ -886,6 +1171,7 @@ static inline int op_onerr( mrbc_vm *vm, mrbc_value *regs )
   callinfo->n_args = 0;
   callinfo->target_class = vm->target_class;
   callinfo->own_class = 0;
+  callinfo->iterator = 0;
   callinfo->prev = vm->exception_tail;
   vm->exception_tail = callinfo;
 
@@ -990,7 +1276,7 @@ static inline int op_raise( mrbc_vm *vm, mrbc_value *regs )
     vm->callinfo_tail = callinfo->prev;
     vm->pc_irep = callinfo->pc_irep;
     vm->inst = callinfo->inst;
-    mrbc_free(vm, callinfo);
+    free_callinfo(vm, callinfo);
   }  else {
     vm->exc = vm->exc_pending;
   }
@@ -1022,6 +1308,7 @@ static inline int op_epush( mrbc_vm *vm, mrbc_value *regs )
   callinfo->n_args = 0;
   callinfo->target_class = vm->target_class;
   callinfo->own_class = 0;
+  callinfo->iterator = 0;
   callinfo->prev = vm->exception_tail;
   vm->exception_tail = callinfo;
 
@@ -1046,10 +1333,10 @@ static inline int op_epop( mrbc_vm *vm, mrbc_value *regs )
   if( callinfo == NULL ){
     return 0;
   }
-  vm->exception_tail = callinfo->prev;
 
   // same as OP_EXEC
-  mrbc_push_callinfo(vm, 0, 0, 0);
+  if( !mrbc_push_callinfo(vm, 0, 0, 0) ) return -1;
+  vm->exception_tail = callinfo->prev;
   vm->pc_irep = callinfo->pc_irep;
   vm->inst = vm->pc_irep->code;
   vm->target_class = callinfo->target_class;
@@ -1074,9 +1361,7 @@ static inline int op_sendv( mrbc_vm *vm, mrbc_value *regs )
 {
   FETCH_BB();
 
-  const char *sym_name = mrbc_get_irep_symbol(vm, b);
-
-  return send_by_name( vm, sym_name, regs, a, CALL_MAXARGS, 0 );
+  return send_by_irep_symbol( vm, b, regs, a, CALL_MAXARGS, 0 );
 }
 
 
@@ -1093,9 +1378,7 @@ static inline int op_sendvb( mrbc_vm *vm, mrbc_value *regs )
 {
   FETCH_BB();
 
-  const char *sym_name = mrbc_get_irep_symbol(vm, b);
-
-  return send_by_name( vm, sym_name, regs, a, CALL_MAXARGS, 1 );
+  return send_by_irep_symbol( vm, b, regs, a, CALL_MAXARGS, 1 );
 }
 
 
@@ -1112,9 +1395,7 @@ static inline int op_send( mrbc_vm *vm, mrbc_value *regs )
 {
   FETCH_BBB();
 
-  const char *sym_name = mrbc_get_irep_symbol(vm, b);
-
-  return send_by_name( vm, sym_name, regs, a, c, 0 );
+  return send_by_irep_symbol( vm, b, regs, a, c, 0 );
 }
 
 
@@ -1131,9 +1412,7 @@ static inline int op_sendb( mrbc_vm *vm, mrbc_value *regs )
 {
   FETCH_BBB();
 
-  const char *sym_name = mrbc_get_irep_symbol(vm, b);
-
-  return send_by_name( vm, sym_name, regs, a, c, 1 );
+  return send_by_irep_symbol( vm, b, regs, a, c, 1 );
 }
 
 
@@ -1198,7 +1477,11 @@ static inline int op_super( mrbc_vm *vm, mrbc_value *regs )
     return 1;
   }
 
+  if( regs + a + method.irep->nregs > vm->regs + MAX_REGS_SIZE ) {
+    return mrbc_stack_overflow(vm);
+  }
   callinfo = mrbc_push_callinfo(vm, callinfo->method_id, a, b);
+  if( !callinfo ) return -1;
   callinfo->own_class = method.cls;
 
   // target irep
@@ -1389,7 +1672,7 @@ static inline int op_enter( mrbc_vm *vm, mrbc_value *regs )
       }
       jmp_ofs = o;
     }
-    vm->inst += jmp_ofs * 3;	// 3 = bytecode size of OP_JMP
+    vm->inst += jmp_ofs;	// skip OP_JMPs of given optional args.
   }
 
   return 0;
@@ -1417,7 +1700,7 @@ static inline int op_return( mrbc_vm *vm, mrbc_value *regs )
 
   STOP_IF_TOPLEVEL();
 
-
+  mrbc_func_t iterator = vm->callinfo_tail->iterator;
   mrbc_pop_callinfo(vm);
 
   // nregs to release
@@ -1429,6 +1712,11 @@ static inline int op_return( mrbc_vm *vm, mrbc_value *regs )
     mrbc_decref_empty( &regs[i] );
   }
 
+  // returned from the block of native iterator.
+  if( iterator ) {
+    iterator( vm, regs - MRBC_ITERATOR_REGS, 0 );
+  }
+
   return 0;
 }
 
@@ -1506,6 +1794,7 @@ static inline int op_break( mrbc_vm *vm, mrbc_value *regs )
   // trace back to caller
   do {
     p_reg = callinfo->current_regs + callinfo->reg_offset;
+    if( callinfo->iterator ) p_reg -= MRBC_ITERATOR_REGS;
     mrbc_pop_callinfo(vm);
     callinfo = vm->callinfo_tail;
   } while( callinfo != caller_callinfo );
@@ -2144,7 +2433,8 @@ static inline int op_intern( mrbc_vm *vm, mrbc_value *regs )
 
   assert( regs[a].tt == MRBC_TT_STRING );
 
-  mrbc_value sym_id = mrbc_symbol_new(vm, (const char*)regs[a].string->data);
+  mrbc_value sym_id = mrbc_symbol_new_len(vm, (const char*)regs[a].string->data,
+					   regs[a].string->size);
 
   mrbc_decref( &regs[a] );
   regs[a] = sym_id;
@@ -2153,6 +2443,109 @@ static inline int op_intern( mrbc_vm *vm, mrbc_value *regs )
 }
 
 
+#if MRBC_USE_STRING
+//================================================================
+/*! get the shared String literal.
+
+  The literal is made at the second time, so that a literal used
+  only once (e.g. in the top level) is not kept.  It is kept until
+  the irep is released, and isn't owned by any VM.
+
+  @param  vm	pointer of VM.
+  @param  n	pool index in current irep.
+  @return	pointer to the literal, or NULL.
+*/
+static mrbc_string * get_literal( struct VM *vm, int n )
+{
+  mrbc_irep *irep = vm->pc_irep;
+
+  if( !irep->literal ) {
+    int size = sizeof(mrbc_string *) * irep->plen;
+    irep->literal = mrbc_raw_alloc( size );
+    if( !irep->literal ) return NULL;
+    memset( irep->literal, 0, size );
+  }
+
+  if( !irep->literal[n] ) {
+    irep->literal[n] = LITERAL_USED_ONCE;
+    return NULL;
+  }
+
+  if( irep->literal[n] == LITERAL_USED_ONCE ) {
+    mrbc_object *pool_obj = irep->pools[n];
+
+    /* CAUTION: pool_obj->str - 2. see IREP POOL structure. */
+    int len = bin_to_uint16(pool_obj->str - 2);
+    mrbc_value v = mrbc_string_new(0, pool_obj->str, len);
+    if( !v.string ) return NULL;
+    irep->literal[n] = v.string;
+  }
+
+  return irep->literal[n];
+}
+
+
+//================================================================
+/*! Can the literal itself be passed to the next instruction?
+
+  True when the literal is only compared, printed or appended to
+  another string by the built-in methods, or its object_id is taken.
+  (e.g.) cmd == "read", when "THERM", puts "invalid", "#{x} items"
+
+  @param  vm	pointer of VM.
+  @param  regs	pointer to regs
+  @param  a	register of the literal.
+  @return	true if the literal is not modified or kept.
+*/
+static int is_literal_borrowed( struct VM *vm, mrbc_value *regs, int a )
+{
+  const mrbc_inst *inst = vm->inst;
+
+  if( inst->op == OP_EQ ) {
+    return inst->a == a || inst->a + 1 == a;
+  }
+  if( inst->op == OP_STRCAT ) {
+    return inst->a + 1 == a;
+  }
+  if( inst->op != OP_SEND || inst->bc.c > 1 ) return 0;
+
+  mrbc_class *cls;
+  if( inst->a == a ) {
+    cls = mrbc_class_string;			// "THERM" === x
+  } else if( inst->a + 1 == a && inst->bc.c == 1 ) {
+    cls = find_class_by_object( &regs[inst->a] );	// puts "invalid"
+  } else {
+    return 0;
+  }
+
+  switch( vm->pc_irep->syms[inst->bc.b] ) {
+  case MRBC_SYMID_object_id:		// (debug) "abc".object_id
+    if( inst->bc.c != 0 ) return 0;
+    break;
+  case MRBC_SYMID_EQ_EQ_EQ:
+  case MRBC_SYMID_NOT_EQ:
+  case MRBC_SYMID_puts:
+  case MRBC_SYMID_print:
+  case MRBC_SYMID_index:
+  case MRBC_SYMID_include_Q:
+  case MRBC_SYMID_start_with_Q:
+  case MRBC_SYMID_end_with_Q:
+  case MRBC_SYMID_has_key_Q:
+    if( inst->bc.c != 1 ) return 0;
+    break;
+  default:
+    return 0;
+  }
+
+  // must be the built-in method found by the inline method cache.
+  const mrbc_method_cache *cache = vm->pc_irep->method_cache;
+  return cache && cache[inst->bc.b].cls == cls &&
+    cache[inst->bc.b].epoch == mrbc_method_epoch &&
+    cache[inst->bc.b].method.c_func == 2;
+}
+#endif
+
+
 //================================================================
 /*! OP_STRING
 
@@ -2167,11 +2560,21 @@ static inline int op_string( mrbc_vm *vm, mrbc_value *regs )
   FETCH_BB();
 
 #if MRBC_USE_STRING
-  mrbc_object *pool_obj = vm->pc_irep->pools[b];
+  mrbc_value value = {.tt = MRBC_TT_STRING, .string = get_literal( vm, b )};
 
-  /* CAUTION: pool_obj->str - 2. see IREP POOL structure. */
-  int len = bin_to_uint16(pool_obj->str - 2);
-  mrbc_value value = mrbc_string_new(vm, pool_obj->str, len);
+  if( !value.string ) {
+    mrbc_object *pool_obj = vm->pc_irep->pools[b];
+
+    /* CAUTION: pool_obj->str - 2. see IREP POOL structure. */
+    int len = bin_to_uint16(pool_obj->str - 2);
+    value = mrbc_string_new(vm, pool_obj->str, len);
+
+  } else if( is_literal_borrowed( vm, regs, a ) ) {
+    mrbc_incref( &value );
+
+  } else {
+    value = mrbc_string_dup(vm, &value);	// share the buffer.
+  }
   if( value.string == NULL ) return -1;         // ENOMEM
 
   mrbc_decref(&regs[a]);
@@ -2237,6 +2640,7 @@ static inline int op_hash( mrbc_vm *vm, mrbc_value *regs )
   memcpy( value.hash->data, &regs[a], sizeof(mrbc_value) * b );
   memset( &regs[a], 0, sizeof(mrbc_value) * b );
   value.hash->n_stored = b;
+  mrbc_hash_rehash( &value );
 
   mrbc_decref(&regs[a]);
   regs[a] = value;
@@ -2283,7 +2687,7 @@ static inline int op_range( mrbc_vm *vm, mrbc_value *regs )
   FETCH_B();
 
   mrbc_value value = mrbc_range_new(vm, &regs[a], &regs[a+1],
-				    (vm->inst[-2] == OP_RANGE_EXC));
+				    (vm->inst[-1].op == OP_RANGE_EXC));
   regs[a] = value;
   regs[a+1].tt = MRBC_TT_EMPTY;
 
@@ -2304,7 +2708,7 @@ static inline int op_class( mrbc_vm *vm, mrbc_value *regs )
 {
   FETCH_BB();
 
-  const char *sym_name = mrbc_get_irep_symbol(vm, b);
+  const char *sym_name = symid_to_str( vm->pc_irep->syms[b] );
   mrbc_class *super = (regs[a+1].tt == MRBC_TT_CLASS) ? regs[a+1].cls : 0;
   mrbc_class *cls = mrbc_define_class(vm, sym_name, super);
   if( !cls ) return -1;		// ENOMEM
@@ -2333,7 +2737,7 @@ static inline int op_exec( mrbc_vm *vm, mrbc_value *regs )
   assert( regs[a].tt == MRBC_TT_CLASS );
 
   // prepare callinfo
-  mrbc_push_callinfo(vm, 0, 0, 0);
+  if( !mrbc_push_callinfo(vm, 0, 0, 0) ) return -1;
 
   // target irep
   vm->pc_irep = vm->pc_irep->reps[b];
@@ -2364,8 +2768,7 @@ static inline int op_def( mrbc_vm *vm, mrbc_value *regs )
   assert( regs[a+1].tt == MRBC_TT_PROC );
 
   mrbc_class *cls = regs[a].cls;
-  const char *name = mrbc_get_irep_symbol(vm, b);
-  mrbc_sym sym_id = str_to_symid( name );
+  mrbc_sym sym_id = vm->pc_irep->syms[b];
   mrbc_proc *proc = regs[a+1].proc;
 
   mrbc_method *method = mrbc_raw_alloc( sizeof(mrbc_method) );
@@ -2375,28 +2778,7 @@ static inline int op_def( mrbc_vm *vm, mrbc_value *regs )
   method->c_func = 0;
   method->sym_id = sym_id;
   method->irep = proc->irep;
-  method->next = cls->method_link;
-  cls->method_link = method;
-
-  // checking same method
-  for( ;method->next != NULL; method = method->next ) {
-    if( method->next->sym_id == sym_id ) {
-      // Found it. Unchain it in linked list and remove.
-      mrbc_method *del_method = method->next;
-
-      method->next = del_method->next;
-      /* (note)
-         Case c_func == 0 is defined by this ope-code.
-         Case c_func == 1 is defined by mrbc_define_method() function.
-         That function uses mrbc_raw_alloc_no_free() to allocate memory.
-         Thus not free this memory.
-         Case c_func == 2 is builtin C function. maybe create by OP_ALIAS.
-      */
-      if( del_method->c_func != 1 ) mrbc_raw_free( del_method );
-
-      break;
-    }
-  }
+  mrbc_add_method( cls, method );
 
   return 0;
 }
@@ -2415,15 +2797,14 @@ static inline int op_alias( mrbc_vm *vm, mrbc_value *regs )
 {
   FETCH_BB();
 
-  const char *name_new = mrbc_get_irep_symbol(vm, a);
-  const char *name_org = mrbc_get_irep_symbol(vm, b);
-  mrbc_sym sym_id_new = str_to_symid(name_new);
-  mrbc_sym sym_id_org = str_to_symid(name_org);
+  mrbc_sym sym_id_new = vm->pc_irep->syms[a];
+  mrbc_sym sym_id_org = vm->pc_irep->syms[b];
   mrbc_class *cls = vm->target_class;
   mrbc_method method_org;
 
   if( mrbc_find_method( &method_org, cls, sym_id_org ) == 0 ) {
-    console_printf("NameError: undefined method '%s'\n", name_org);
+    console_printf("NameError: undefined method '%s'\n",
+		   symid_to_str( sym_id_org ));
     return 0;
   }
 
@@ -2433,19 +2814,7 @@ static inline int op_alias( mrbc_vm *vm, mrbc_value *regs )
 
   *method_new = method_org;
   method_new->sym_id = sym_id_new;
-  method_new->next = cls->method_link;
-  cls->method_link = method_new;
-
-  // checking same method
-  //  see OP_DEF function. same it.
-  for( ;method_new->next != NULL; method_new = method_new->next ) {
-    if( method_new->next->sym_id == sym_id_new ) {
-      mrbc_method *del_method = method_new->next;
-      method_new->next = del_method->next;
-      if( del_method->c_func != 1 ) mrbc_raw_free( del_method );
-      break;
-    }
-  }
+  mrbc_add_method( cls, method_new );
 
   return 0;
 }
@@ -2489,27 +2858,6 @@ static inline int op_tclass( mrbc_vm *vm, mrbc_value *regs )
 }
 
 
-//================================================================
-/*! OP_EXT1, OP_EXT2, OP_EXT3
-
-  if OP_EXT1, make 1st operand 16bit
-  if OP_EXT2, make 2nd operand 16bit
-  if OP_EXT3, make 1st and 2nd operand 16bit
-
-  @param  vm    pointer of VM.
-  @param  regs  pointer to regs
-  @retval -1  No error and exit from vm.
-*/
-static inline int op_ext( mrbc_vm *vm, mrbc_value *regs )
-{
-  FETCH_Z();
-
-  vm->ext_flag = vm->inst[-1] - OP_EXT1 + 1;
-
-  return 0;
-}
-
-
 //================================================================
 /*! OP_STOP
 
@@ -2553,7 +2901,7 @@ static inline int op_abort( mrbc_vm *vm, mrbc_value *regs )
 */
 static inline int op_dummy_Z( mrbc_vm *vm, mrbc_value *regs )
 {
-  uint8_t op = *(vm->inst - 1);
+  uint8_t op = vm->inst[-1].op;
   FETCH_Z();
 
   console_printf("# Skip OP 0x%02x\n", op);
@@ -2566,7 +2914,7 @@ static inline int op_dummy_Z( mrbc_vm *vm, mrbc_value *regs )
 */
 static inline int op_dummy_B( mrbc_vm *vm, mrbc_value *regs )
 {
-  uint8_t op = *(vm->inst - 1);
+  uint8_t op = vm->inst[-1].op;
   FETCH_B();
 
   console_printf("# Skip OP 0x%02x\n", op);
@@ -2579,7 +2927,7 @@ static inline int op_dummy_B( mrbc_vm *vm, mrbc_value *regs )
 */
 static inline int op_dummy_BB( mrbc_vm *vm, mrbc_value *regs )
 {
-  uint8_t op = *(vm->inst - 1);
+  uint8_t op = vm->inst[-1].op;
   FETCH_BB();
 
   console_printf("# Skip OP 0x%02x\n", op);
@@ -2592,7 +2940,7 @@ static inline int op_dummy_BB( mrbc_vm *vm, mrbc_value *regs )
 */
 static inline int op_dummy_BBB( mrbc_vm *vm, mrbc_value *regs )
 {
-  uint8_t op = *(vm->inst - 1);
+  uint8_t op = vm->inst[-1].op;
   FETCH_BBB();
 
   console_printf("# Skip OP 0x%02x\n", op);
@@ -2642,6 +2990,7 @@ mrbc_vm *mrbc_vm_open( struct VM *vm_arg )
 #ifdef MRBC_DEBUG
   vm->flag_debug_mode = 1;
 #endif
+  vm->inst_budget = MRBC_INSTRUCTION_BUDGET;
 
   return vm;
 }
@@ -2674,7 +3023,6 @@ void mrbc_vm_begin( struct VM *vm )
 {
   vm->pc_irep = vm->irep;
   vm->inst = vm->pc_irep->code;
-  vm->ext_flag = 0;
 
   memset(vm->regs, 0, sizeof(vm->regs));
   int i;
@@ -2687,6 +3035,7 @@ void mrbc_vm_begin( struct VM *vm )
 
   vm->current_regs = vm->regs;
   vm->callinfo_tail = NULL;
+  vm->callinfo_top = vm->callinfo_stack;
   vm->target_class = mrbc_class_object;
 
   vm->exc = 0;
@@ -2694,6 +3043,7 @@ void mrbc_vm_begin( struct VM *vm )
 
   vm->error_code = 0;
   vm->flag_preemption = 0;
+  vm->flag_retry = 0;
 }
 
 
@@ -2772,144 +3122,314 @@ void output_opcode( uint8_t opcode )
 #endif
 
 
+//================================================================
+// Instruction dispatch for mrbc_vm_run().
+//  VM_NEXT() goes on to the next instruction unless preempted.
+//  VM_NEXT_EXC() is used after instructions that can leave an exception
+//  in top level (send, raise, return...), the others skip that check.
+#if defined(MRBC_NO_TIMER)
+#define VM_CONTINUE()	(!vm->flag_preemption && !(budget && --budget == 0))
+#else
+#define VM_CONTINUE()	(!vm->flag_preemption)
+#endif
+#define VM_TOPLEVEL_EXC() \
+  (vm->exception_tail == NULL && vm->callinfo_tail == NULL && vm->exc)
+
+#if defined(MRBC_COUNT_INSTRUCTIONS)
+#define VM_COUNT()	(vm->inst_count++)
+#else
+#define VM_COUNT()	((void)0)
+#endif
+
+#if MRBC_DIRECT_THREADED
+#define VM_CASE(op)	L_##op
+#define VM_DEFAULT	L_DEFAULT
+#define VM_NEXT() do {					\
+    if( !VM_CONTINUE() ) goto EXIT;			\
+    VM_COUNT();						\
+    regs = vm->current_regs;				\
+    goto *op_table[(vm->inst++)->op];			\
+  } while(0)
+#define VM_NEXT_EXC() do {				\
+    if( VM_TOPLEVEL_EXC() ) return 0;			\
+    VM_NEXT();						\
+  } while(0)
+#else
+#define VM_CASE(op)	case op
+#define VM_DEFAULT	default
+#define VM_NEXT()	continue	// to the loop condition.
+#define VM_NEXT_EXC()	break		// to the exception check.
+#endif
+
+
 //================================================================
 /*! Fetch a bytecode and execute
 
+  Without timer (MRBC_NO_TIMER), also returns after executing
+  vm->inst_budget instructions. Zero means no limit.
+  With MRBC_DIRECT_THREADED, each instruction jumps directly to the
+  next one through a table of label addresses (GCC computed goto).
+
   @param  vm    A pointer of VM.
   @retval 0  No error.
 */
 int mrbc_vm_run( struct VM *vm )
 {
   int ret = 0;
+#if defined(MRBC_NO_TIMER)
+  int budget = vm->inst_budget;
+#endif
+  mrbc_value *regs;
+
+#if MRBC_DIRECT_THREADED
+  static const void * const op_table[256] = {
+    [0 ... 255] = &&L_DEFAULT,
+    [OP_NOP]         = &&L_OP_NOP,
+    [OP_MOVE]        = &&L_OP_MOVE,
+    [OP_LOADL]       = &&L_OP_LOADL,
+    [OP_LOADI]       = &&L_OP_LOADI,
+    [OP_LOADINEG]    = &&L_OP_LOADINEG,
+    [OP_LOADI__1]    = &&L_OP_LOADI__1,
+    [OP_LOADI_0]     = &&L_OP_LOADI_0,
+    [OP_LOADI_1]     = &&L_OP_LOADI_1,
+    [OP_LOADI_2]     = &&L_OP_LOADI_2,
+    [OP_LOADI_3]     = &&L_OP_LOADI_3,
+    [OP_LOADI_4]     = &&L_OP_LOADI_4,
+    [OP_LOADI_5]     = &&L_OP_LOADI_5,
+    [OP_LOADI_6]     = &&L_OP_LOADI_6,
+    [OP_LOADI_7]     = &&L_OP_LOADI_7,
+    [OP_LOADSYM]     = &&L_OP_LOADSYM,
+    [OP_LOADNIL]     = &&L_OP_LOADNIL,
+    [OP_LOADSELF]    = &&L_OP_LOADSELF,
+    [OP_LOADT]       = &&L_OP_LOADT,
+    [OP_LOADF]       = &&L_OP_LOADF,
+    [OP_GETGV]       = &&L_OP_GETGV,
+    [OP_SETGV]       = &&L_OP_SETGV,
+    [OP_GETSV]       = &&L_OP_GETSV,
+    [OP_SETSV]       = &&L_OP_SETSV,
+    [OP_GETIV]       = &&L_OP_GETIV,
+    [OP_SETIV]       = &&L_OP_SETIV,
+    [OP_GETCV]       = &&L_OP_GETCV,
+    [OP_SETCV]       = &&L_OP_SETCV,
+    [OP_GETCONST]    = &&L_OP_GETCONST,
+    [OP_SETCONST]    = &&L_OP_SETCONST,
+    [OP_GETMCNST]    = &&L_OP_GETMCNST,
+    [OP_SETMCNST]    = &&L_OP_SETMCNST,
+    [OP_GETUPVAR]    = &&L_OP_GETUPVAR,
+    [OP_SETUPVAR]    = &&L_OP_SETUPVAR,
+    [OP_JMP]         = &&L_OP_JMP,
+    [OP_JMPIF]       = &&L_OP_JMPIF,
+    [OP_JMPNOT]      = &&L_OP_JMPNOT,
+    [OP_JMPNIL]      = &&L_OP_JMPNIL,
+    [OP_ONERR]       = &&L_OP_ONERR,
+    [OP_EXCEPT]      = &&L_OP_EXCEPT,
+    [OP_RESCUE]      = &&L_OP_RESCUE,
+    [OP_POPERR]      = &&L_OP_POPERR,
+    [OP_RAISE]       = &&L_OP_RAISE,
+    [OP_EPUSH]       = &&L_OP_EPUSH,
+    [OP_EPOP]        = &&L_OP_EPOP,
+    [OP_SENDV]       = &&L_OP_SENDV,
+    [OP_SENDVB]      = &&L_OP_SENDVB,
+    [OP_SEND]        = &&L_OP_SEND,
+    [OP_SENDB]       = &&L_OP_SENDB,
+    [OP_CALL]        = &&L_OP_CALL,
+    [OP_SUPER]       = &&L_OP_SUPER,
+    [OP_ARGARY]      = &&L_OP_ARGARY,
+    [OP_ENTER]       = &&L_OP_ENTER,
+    [OP_KEY_P]       = &&L_OP_KEY_P,
+    [OP_KEYEND]      = &&L_OP_KEYEND,
+    [OP_KARG]        = &&L_OP_KARG,
+    [OP_RETURN]      = &&L_OP_RETURN,
+    [OP_RETURN_BLK]  = &&L_OP_RETURN_BLK,
+    [OP_BREAK]       = &&L_OP_BREAK,
+    [OP_BLKPUSH]     = &&L_OP_BLKPUSH,
+    [OP_ADD]         = &&L_OP_ADD,
+    [OP_ADDI]        = &&L_OP_ADDI,
+    [OP_SUB]         = &&L_OP_SUB,
+    [OP_SUBI]        = &&L_OP_SUBI,
+    [OP_MUL]         = &&L_OP_MUL,
+    [OP_DIV]         = &&L_OP_DIV,
+    [OP_EQ]          = &&L_OP_EQ,
+    [OP_LT]          = &&L_OP_LT,
+    [OP_LE]          = &&L_OP_LE,
+    [OP_GT]          = &&L_OP_GT,
+    [OP_GE]          = &&L_OP_GE,
+    [OP_ARRAY]       = &&L_OP_ARRAY,
+    [OP_ARRAY2]      = &&L_OP_ARRAY2,
+    [OP_ARYCAT]      = &&L_OP_ARYCAT,
+    [OP_ARYPUSH]     = &&L_OP_ARYPUSH,
+    [OP_ARYDUP]      = &&L_OP_ARYDUP,
+    [OP_AREF]        = &&L_OP_AREF,
+    [OP_ASET]        = &&L_OP_ASET,
+    [OP_APOST]       = &&L_OP_APOST,
+    [OP_INTERN]      = &&L_OP_INTERN,
+    [OP_STRING]      = &&L_OP_STRING,
+    [OP_STRCAT]      = &&L_OP_STRCAT,
+    [OP_HASH]        = &&L_OP_HASH,
+    [OP_HASHADD]     = &&L_OP_HASHADD,
+    [OP_HASHCAT]     = &&L_OP_HASHCAT,
+    [OP_LAMBDA]      = &&L_OP_LAMBDA,
+    [OP_BLOCK]       = &&L_OP_BLOCK,
+    [OP_METHOD]      = &&L_OP_METHOD,
+    [OP_RANGE_INC]   = &&L_OP_RANGE_INC,
+    [OP_RANGE_EXC]   = &&L_OP_RANGE_EXC,
+    [OP_OCLASS]      = &&L_OP_OCLASS,
+    [OP_CLASS]       = &&L_OP_CLASS,
+    [OP_MODULE]      = &&L_OP_MODULE,
+    [OP_EXEC]        = &&L_OP_EXEC,
+    [OP_DEF]         = &&L_OP_DEF,
+    [OP_ALIAS]       = &&L_OP_ALIAS,
+    [OP_UNDEF]       = &&L_OP_UNDEF,
+    [OP_SCLASS]      = &&L_OP_SCLASS,
+    [OP_TCLASS]      = &&L_OP_TCLASS,
+    [OP_DEBUG]       = &&L_OP_DEBUG,
+    [OP_ERR]         = &&L_OP_ERR,
+    [OP_STOP]        = &&L_OP_STOP,
+    [OP_ABORT]       = &&L_OP_ABORT,
+  };
 
+  // Dispatch first instruction.
+  VM_COUNT();
+  regs = vm->current_regs;
+  goto *op_table[(vm->inst++)->op];
+#else
   do {
+    VM_COUNT();
+
     // regs
-    mrbc_value *regs = vm->current_regs;
+    regs = vm->current_regs;
 
     // Dispatch
-    uint8_t op = *vm->inst++;
+    uint8_t op = (vm->inst++)->op;
 
     // output OP_XXX for debug
     //if( vm->flag_debug_mode )output_opcode( op );
 
     switch( op ) {
-    case OP_NOP:        ret = op_nop       (vm, regs); break;
-    case OP_MOVE:       ret = op_move      (vm, regs); break;
-    case OP_LOADL:      ret = op_loadl     (vm, regs); break;
-    case OP_LOADI:      ret = op_loadi     (vm, regs); break;
-    case OP_LOADINEG:   ret = op_loadineg  (vm, regs); break;
-    case OP_LOADI__1:   // fall through
-    case OP_LOADI_0:    // fall through
-    case OP_LOADI_1:    // fall through
-    case OP_LOADI_2:    // fall through
-    case OP_LOADI_3:    // fall through
-    case OP_LOADI_4:    // fall through
-    case OP_LOADI_5:    // fall through
-    case OP_LOADI_6:    // fall through
-    case OP_LOADI_7:    ret = op_loadi_n   (vm, regs); break;
-    case OP_LOADSYM:    ret = op_loadsym   (vm, regs); break;
-    case OP_LOADNIL:    ret = op_loadnil   (vm, regs); break;
-    case OP_LOADSELF:   ret = op_loadself  (vm, regs); break;
-    case OP_LOADT:      ret = op_loadt     (vm, regs); break;
-    case OP_LOADF:      ret = op_loadf     (vm, regs); break;
-    case OP_GETGV:      ret = op_getgv     (vm, regs); break;
-    case OP_SETGV:      ret = op_setgv     (vm, regs); break;
-    case OP_GETSV:      ret = op_dummy_BB  (vm, regs); break;
-    case OP_SETSV:      ret = op_dummy_BB  (vm, regs); break;
-    case OP_GETIV:      ret = op_getiv     (vm, regs); break;
-    case OP_SETIV:      ret = op_setiv     (vm, regs); break;
-    case OP_GETCV:      ret = op_dummy_BB  (vm, regs); break;
-    case OP_SETCV:      ret = op_dummy_BB  (vm, regs); break;
-    case OP_GETCONST:   ret = op_getconst  (vm, regs); break;
-    case OP_SETCONST:   ret = op_setconst  (vm, regs); break;
-    case OP_GETMCNST:   ret = op_getmcnst  (vm, regs); break;
-    case OP_SETMCNST:   ret = op_dummy_BB  (vm, regs); break;
-    case OP_GETUPVAR:   ret = op_getupvar  (vm, regs); break;
-    case OP_SETUPVAR:   ret = op_setupvar  (vm, regs); break;
-    case OP_JMP:        ret = op_jmp       (vm, regs); break;
-    case OP_JMPIF:      ret = op_jmpif     (vm, regs); break;
-    case OP_JMPNOT:     ret = op_jmpnot    (vm, regs); break;
-    case OP_JMPNIL:     ret = op_jmpnil    (vm, regs); break;
-    case OP_ONERR:      ret = op_onerr     (vm, regs); break;
-    case OP_EXCEPT:     ret = op_except    (vm, regs); break;
-    case OP_RESCUE:     ret = op_rescue    (vm, regs); break;
-    case OP_POPERR:     ret = op_poperr    (vm, regs); break;
-    case OP_RAISE:      ret = op_raise     (vm, regs); break;
-    case OP_EPUSH:      ret = op_epush     (vm, regs); break;
-    case OP_EPOP:       ret = op_epop      (vm, regs); break;
-    case OP_SENDV:      ret = op_sendv     (vm, regs); break;
-    case OP_SENDVB:     ret = op_sendvb    (vm, regs); break;
-    case OP_SEND:       ret = op_send      (vm, regs); break;
-    case OP_SENDB:      ret = op_sendb     (vm, regs); break;
-    case OP_CALL:       ret = op_dummy_Z   (vm, regs); break;
-    case OP_SUPER:      ret = op_super     (vm, regs); break;
-    case OP_ARGARY:     ret = op_argary    (vm, regs); break;
-    case OP_ENTER:      ret = op_enter     (vm, regs); break;
-    case OP_KEY_P:      ret = op_dummy_BB  (vm, regs); break;
-    case OP_KEYEND:     ret = op_dummy_Z   (vm, regs); break;
-    case OP_KARG:       ret = op_dummy_BB  (vm, regs); break;
-    case OP_RETURN:     ret = op_return    (vm, regs); break;
-    case OP_RETURN_BLK: ret = op_return_blk(vm, regs); break;
-    case OP_BREAK:      ret = op_break     (vm, regs); break;
-    case OP_BLKPUSH:    ret = op_blkpush   (vm, regs); break;
-    case OP_ADD:        ret = op_add       (vm, regs); break;
-    case OP_ADDI:       ret = op_addi      (vm, regs); break;
-    case OP_SUB:        ret = op_sub       (vm, regs); break;
-    case OP_SUBI:       ret = op_subi      (vm, regs); break;
-    case OP_MUL:        ret = op_mul       (vm, regs); break;
-    case OP_DIV:        ret = op_div       (vm, regs); break;
-    case OP_EQ:         ret = op_eq        (vm, regs); break;
-    case OP_LT:         ret = op_lt        (vm, regs); break;
-    case OP_LE:         ret = op_le        (vm, regs); break;
-    case OP_GT:         ret = op_gt        (vm, regs); break;
-    case OP_GE:         ret = op_ge        (vm, regs); break;
-    case OP_ARRAY:      ret = op_array     (vm, regs); break;
-    case OP_ARRAY2:     ret = op_array2    (vm, regs); break;
-    case OP_ARYCAT:     ret = op_arycat    (vm, regs); break;
-    case OP_ARYPUSH:    ret = op_dummy_B   (vm, regs); break;
-    case OP_ARYDUP:     ret = op_arydup    (vm, regs); break;
-    case OP_AREF:       ret = op_aref      (vm, regs); break;
-    case OP_ASET:       ret = op_dummy_BBB (vm, regs); break;
-    case OP_APOST:      ret = op_apost     (vm, regs); break;
-    case OP_INTERN:     ret = op_intern    (vm, regs); break;
-    case OP_STRING:     ret = op_string    (vm, regs); break;
-    case OP_STRCAT:     ret = op_strcat    (vm, regs); break;
-    case OP_HASH:       ret = op_hash      (vm, regs); break;
-    case OP_HASHADD:    ret = op_dummy_BB  (vm, regs); break;
-    case OP_HASHCAT:    ret = op_dummy_B   (vm, regs); break;
-    case OP_LAMBDA:     ret = op_dummy_BB  (vm, regs); break;
-    case OP_BLOCK:      // fall through
-    case OP_METHOD:     ret = op_method    (vm, regs); break;
-    case OP_RANGE_INC:  // fall through
-    case OP_RANGE_EXC:  ret = op_range     (vm, regs); break;
-    case OP_OCLASS:     ret = op_dummy_B   (vm, regs); break;
-    case OP_CLASS:      ret = op_class     (vm, regs); break;
-    case OP_MODULE:     ret = op_dummy_BB  (vm, regs); break;
-    case OP_EXEC:       ret = op_exec      (vm, regs); break;
-    case OP_DEF:        ret = op_def       (vm, regs); break;
-    case OP_ALIAS:      ret = op_alias     (vm, regs); break;
-    case OP_UNDEF:      ret = op_dummy_B   (vm, regs); break;
-    case OP_SCLASS:     ret = op_sclass    (vm, regs); break;
-    case OP_TCLASS:     ret = op_tclass    (vm, regs); break;
-    case OP_DEBUG:      ret = op_dummy_BBB (vm, regs); break;
-    case OP_ERR:        ret = op_dummy_B   (vm, regs); break;
-    case OP_EXT1:       // fall through
-    case OP_EXT2:       // fall through
-    case OP_EXT3:       ret = op_ext       (vm, regs); break;
-    case OP_STOP:       ret = op_stop      (vm, regs); break;
-
-    case OP_ABORT:      ret = op_abort     (vm, regs); break;
-    default:
-      console_printf("Unknown OP 0x%02x\n", op);
-      break;
+#endif
+
+  VM_CASE(OP_NOP):        ret = op_nop       (vm, regs); VM_NEXT();
+  VM_CASE(OP_MOVE):       ret = op_move      (vm, regs); VM_NEXT();
+  VM_CASE(OP_LOADL):      ret = op_loadl     (vm, regs); VM_NEXT();
+  VM_CASE(OP_LOADI):      ret = op_loadi     (vm, regs); VM_NEXT();
+  VM_CASE(OP_LOADINEG):   ret = op_loadineg  (vm, regs); VM_NEXT();
+  VM_CASE(OP_LOADI__1):   // fall through
+  VM_CASE(OP_LOADI_0):    // fall through
+  VM_CASE(OP_LOADI_1):    // fall through
+  VM_CASE(OP_LOADI_2):    // fall through
+  VM_CASE(OP_LOADI_3):    // fall through
+  VM_CASE(OP_LOADI_4):    // fall through
+  VM_CASE(OP_LOADI_5):    // fall through
+  VM_CASE(OP_LOADI_6):    // fall through
+  VM_CASE(OP_LOADI_7):    ret = op_loadi_n   (vm, regs); VM_NEXT();
+  VM_CASE(OP_LOADSYM):    ret = op_loadsym   (vm, regs); VM_NEXT();
+  VM_CASE(OP_LOADNIL):    ret = op_loadnil   (vm, regs); VM_NEXT();
+  VM_CASE(OP_LOADSELF):   ret = op_loadself  (vm, regs); VM_NEXT();
+  VM_CASE(OP_LOADT):      ret = op_loadt     (vm, regs); VM_NEXT();
+  VM_CASE(OP_LOADF):      ret = op_loadf     (vm, regs); VM_NEXT();
+  VM_CASE(OP_GETGV):      ret = op_getgv     (vm, regs); VM_NEXT();
+  VM_CASE(OP_SETGV):      ret = op_setgv     (vm, regs); VM_NEXT();
+  VM_CASE(OP_GETSV):      ret = op_dummy_BB  (vm, regs); VM_NEXT();
+  VM_CASE(OP_SETSV):      ret = op_dummy_BB  (vm, regs); VM_NEXT();
+  VM_CASE(OP_GETIV):      ret = op_getiv     (vm, regs); VM_NEXT();
+  VM_CASE(OP_SETIV):      ret = op_setiv     (vm, regs); VM_NEXT();
+  VM_CASE(OP_GETCV):      ret = op_dummy_BB  (vm, regs); VM_NEXT();
+  VM_CASE(OP_SETCV):      ret = op_dummy_BB  (vm, regs); VM_NEXT();
+  VM_CASE(OP_GETCONST):   ret = op_getconst  (vm, regs); VM_NEXT();
+  VM_CASE(OP_SETCONST):   ret = op_setconst  (vm, regs); VM_NEXT();
+  VM_CASE(OP_GETMCNST):   ret = op_getmcnst  (vm, regs); VM_NEXT();
+  VM_CASE(OP_SETMCNST):   ret = op_dummy_BB  (vm, regs); VM_NEXT();
+  VM_CASE(OP_GETUPVAR):   ret = op_getupvar  (vm, regs); VM_NEXT();
+  VM_CASE(OP_SETUPVAR):   ret = op_setupvar  (vm, regs); VM_NEXT();
+  VM_CASE(OP_JMP):        ret = op_jmp       (vm, regs); VM_NEXT();
+  VM_CASE(OP_JMPIF):      ret = op_jmpif     (vm, regs); VM_NEXT();
+  VM_CASE(OP_JMPNOT):     ret = op_jmpnot    (vm, regs); VM_NEXT();
+  VM_CASE(OP_JMPNIL):     ret = op_jmpnil    (vm, regs); VM_NEXT();
+  VM_CASE(OP_ONERR):      ret = op_onerr     (vm, regs); VM_NEXT();
+  VM_CASE(OP_EXCEPT):     ret = op_except    (vm, regs); VM_NEXT();
+  VM_CASE(OP_RESCUE):     ret = op_rescue    (vm, regs); VM_NEXT();
+  VM_CASE(OP_POPERR):     ret = op_poperr    (vm, regs); VM_NEXT();
+  VM_CASE(OP_RAISE):      ret = op_raise     (vm, regs); VM_NEXT_EXC();
+  VM_CASE(OP_EPUSH):      ret = op_epush     (vm, regs); VM_NEXT();
+  VM_CASE(OP_EPOP):       ret = op_epop      (vm, regs); VM_NEXT();
+  VM_CASE(OP_SENDV):      ret = op_sendv     (vm, regs); VM_NEXT_EXC();
+  VM_CASE(OP_SENDVB):     ret = op_sendvb    (vm, regs); VM_NEXT_EXC();
+  VM_CASE(OP_SEND):       ret = op_send      (vm, regs); VM_NEXT_EXC();
+  VM_CASE(OP_SENDB):      ret = op_sendb     (vm, regs); VM_NEXT_EXC();
+  VM_CASE(OP_CALL):       ret = op_dummy_Z   (vm, regs); VM_NEXT();
+  VM_CASE(OP_SUPER):      ret = op_super     (vm, regs); VM_NEXT_EXC();
+  VM_CASE(OP_ARGARY):     ret = op_argary    (vm, regs); VM_NEXT();
+  VM_CASE(OP_ENTER):      ret = op_enter     (vm, regs); VM_NEXT();
+  VM_CASE(OP_KEY_P):      ret = op_dummy_BB  (vm, regs); VM_NEXT();
+  VM_CASE(OP_KEYEND):     ret = op_dummy_Z   (vm, regs); VM_NEXT();
+  VM_CASE(OP_KARG):       ret = op_dummy_BB  (vm, regs); VM_NEXT();
+  VM_CASE(OP_RETURN):     ret = op_return    (vm, regs); VM_NEXT_EXC();
+  VM_CASE(OP_RETURN_BLK): ret = op_return_blk(vm, regs); VM_NEXT_EXC();
+  VM_CASE(OP_BREAK):      ret = op_break     (vm, regs); VM_NEXT_EXC();
+  VM_CASE(OP_BLKPUSH):    ret = op_blkpush   (vm, regs); VM_NEXT();
+  VM_CASE(OP_ADD):        ret = op_add       (vm, regs); VM_NEXT_EXC();
+  VM_CASE(OP_ADDI):       ret = op_addi      (vm, regs); VM_NEXT();
+  VM_CASE(OP_SUB):        ret = op_sub       (vm, regs); VM_NEXT_EXC();
+  VM_CASE(OP_SUBI):       ret = op_subi      (vm, regs); VM_NEXT();
+  VM_CASE(OP_MUL):        ret = op_mul       (vm, regs); VM_NEXT_EXC();
+  VM_CASE(OP_DIV):        ret = op_div       (vm, regs); VM_NEXT_EXC();
+  VM_CASE(OP_EQ):         ret = op_eq        (vm, regs); VM_NEXT();
+  VM_CASE(OP_LT):         ret = op_lt        (vm, regs); VM_NEXT();
+  VM_CASE(OP_LE):         ret = op_le        (vm, regs); VM_NEXT();
+  VM_CASE(OP_GT):         ret = op_gt        (vm, regs); VM_NEXT();
+  VM_CASE(OP_GE):         ret = op_ge        (vm, regs); VM_NEXT();
+  VM_CASE(OP_ARRAY):      ret = op_array     (vm, regs); VM_NEXT();
+  VM_CASE(OP_ARRAY2):     ret = op_array2    (vm, regs); VM_NEXT();
+  VM_CASE(OP_ARYCAT):     ret = op_arycat    (vm, regs); VM_NEXT();
+  VM_CASE(OP_ARYPUSH):    ret = op_dummy_B   (vm, regs); VM_NEXT();
+  VM_CASE(OP_ARYDUP):     ret = op_arydup    (vm, regs); VM_NEXT();
+  VM_CASE(OP_AREF):       ret = op_aref      (vm, regs); VM_NEXT();
+  VM_CASE(OP_ASET):       ret = op_dummy_BBB (vm, regs); VM_NEXT();
+  VM_CASE(OP_APOST):      ret = op_apost     (vm, regs); VM_NEXT();
+  VM_CASE(OP_INTERN):     ret = op_intern    (vm, regs); VM_NEXT();
+  VM_CASE(OP_STRING):     ret = op_string    (vm, regs); VM_NEXT();
+  VM_CASE(OP_STRCAT):     ret = op_strcat    (vm, regs); VM_NEXT_EXC();
+  VM_CASE(OP_HASH):       ret = op_hash      (vm, regs); VM_NEXT();
+  VM_CASE(OP_HASHADD):    ret = op_dummy_BB  (vm, regs); VM_NEXT();
+  VM_CASE(OP_HASHCAT):    ret = op_dummy_B   (vm, regs); VM_NEXT();
+  VM_CASE(OP_LAMBDA):     ret = op_dummy_BB  (vm, regs); VM_NEXT();
+  VM_CASE(OP_BLOCK):      // fall through
+  VM_CASE(OP_METHOD):     ret = op_method    (vm, regs); VM_NEXT();
+  VM_CASE(OP_RANGE_INC):  // fall through
+  VM_CASE(OP_RANGE_EXC):  ret = op_range     (vm, regs); VM_NEXT();
+  VM_CASE(OP_OCLASS):     ret = op_dummy_B   (vm, regs); VM_NEXT();
+  VM_CASE(OP_CLASS):      ret = op_class     (vm, regs); VM_NEXT();
+  VM_CASE(OP_MODULE):     ret = op_dummy_BB  (vm, regs); VM_NEXT();
+  VM_CASE(OP_EXEC):       ret = op_exec      (vm, regs); VM_NEXT();
+  VM_CASE(OP_DEF):        ret = op_def       (vm, regs); VM_NEXT();
+  VM_CASE(OP_ALIAS):      ret = op_alias     (vm, regs); VM_NEXT();
+  VM_CASE(OP_UNDEF):      ret = op_dummy_B   (vm, regs); VM_NEXT();
+  VM_CASE(OP_SCLASS):     ret = op_sclass    (vm, regs); VM_NEXT();
+  VM_CASE(OP_TCLASS):     ret = op_tclass    (vm, regs); VM_NEXT();
+  VM_CASE(OP_DEBUG):      ret = op_dummy_BBB (vm, regs); VM_NEXT();
+  VM_CASE(OP_ERR):        ret = op_dummy_B   (vm, regs); VM_NEXT();
+  VM_CASE(OP_STOP):       ret = op_stop      (vm, regs); VM_NEXT();
+
+  VM_CASE(OP_ABORT):      ret = op_abort     (vm, regs); VM_NEXT();
+  VM_DEFAULT:
+    console_printf("Unknown OP 0x%02x\n", vm->inst[-1].op);
+    VM_NEXT();
+
+#if !MRBC_DIRECT_THREADED
     }
 
     // raise in top level
     // exit vm
-    if( vm->exception_tail == NULL && vm->callinfo_tail == NULL && vm->exc ) return 0;
-  } while( !vm->flag_preemption );
+    if( VM_TOPLEVEL_EXC() ) return 0;
+  } while( VM_CONTINUE() );
+#else
+ EXIT:
+#endif
 
   vm->flag_preemption = 0;
 
+  // stopped by error. (e.g. stack overflow)
+  if( vm->error_code ) return -1;
+
   return ret;
 }
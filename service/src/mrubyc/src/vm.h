@@ -19,6 +19,7 @@
 #include "vm_config.h"
 #include "value.h"
 #include "class.h"
+#include "opcode.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -37,13 +38,18 @@ typedef struct IREP {
   uint16_t nlocals;		//!< # of local variables
   uint16_t nregs;		//!< # of register variables
   uint16_t rlen;		//!< # of child IREP blocks
-  uint16_t ilen;		//!< # of irep
+  uint16_t ilen;		//!< # of instructions
   uint16_t plen;		//!< # of pool
+  uint16_t slen;		//!< # of symbols
+  uint16_t nsend;		//!< # of symbols used by OP_SEND family.
 
-  uint8_t     *code;		//!< ISEQ (code) BLOCK
+  mrbc_inst   *code;		//!< decoded ISEQ (code) BLOCK
   mrbc_object **pools;		//!< array of POOL objects pointer.
-  uint8_t     *ptr_to_sym;
+  mrbc_sym    *syms;		//!< array of symbol IDs. (SYMS BLOCK)
   struct IREP **reps;		//!< array of child IREP's pointer.
+  mrbc_method_cache *method_cache; //!< inline method cache for nsend symbols.
+  mrbc_ivar_cache *ivar_cache;	//!< inline ivar cache for each symbol.
+  struct RString **literal;	//!< shared String literal for each pool.
 
 } mrbc_irep;
 typedef struct IREP mrb_irep;
@@ -56,17 +62,30 @@ typedef struct IREP mrb_irep;
 typedef struct CALLINFO {
   struct CALLINFO *prev;	//!< previous linked list.
   mrbc_irep *pc_irep;		//!< copy from mrbc_vm.
-  uint8_t *inst;		//!< copy from mrbc_vm.
+  mrbc_inst *inst;		//!< copy from mrbc_vm.
   mrbc_value *current_regs;	//!< copy from mrbc_vm.
   mrbc_class *target_class;	//!< copy from mrbc_vm.
   mrbc_class *own_class;	//!< class that owns method.
   mrbc_sym method_id;		//!< called method ID.
   uint8_t reg_offset;		//!< register offset after call.
   uint8_t n_args;		//!< # of arguments.
+  mrbc_func_t iterator;		//!< native iterator resumed after the block.
 } mrbc_callinfo;
 typedef struct CALLINFO mrb_callinfo;
 
 
+//================================================================
+/*!@brief
+  Registers of the native iterator. (see mrbc_iterator_yield)
+
+  v[0]	self, and the return value.
+  v[1]	block.
+  v[2],v[3]	state of the iteration.
+  v[4]	registers of the block. (self, return value and arguments)
+*/
+#define MRBC_ITERATOR_REGS 4
+
+
 //================================================================
 /*!@brief
   Virtual Machine
@@ -78,12 +97,13 @@ typedef struct VM {
   const uint8_t *mrb;   // bytecode
 
   mrbc_irep *pc_irep;   // PC
-  uint8_t *inst;        // instruction
-  uint8_t ext_flag;     // 1:EXT1, 2:EXT2, 3:EXT3, 0:otherwize
+  mrbc_inst *inst;      // instruction
 
   mrbc_value    regs[MAX_REGS_SIZE];
   mrbc_value   *current_regs;
   mrbc_callinfo *callinfo_tail;
+  mrbc_callinfo *callinfo_top;	// next free frame in callinfo_stack
+  mrbc_callinfo callinfo_stack[MAX_CALLINFO_COUNT];
 
   mrbc_class *target_class;
 
@@ -99,6 +119,12 @@ typedef struct VM {
 
   volatile int8_t flag_preemption;
   int8_t flag_need_memfree;
+  int8_t flag_retry;	//!< the C method waits, send it again. (mrbc_wait_io)
+
+  // the layout does not depend on the build flags below, so that a
+  // library and an application built with different flags agree.
+  uint16_t inst_budget;	//!< max # of instructions in one mrbc_vm_run(). (MRBC_NO_TIMER)
+  uint32_t inst_count;	//!< # of executed instructions. (MRBC_COUNT_INSTRUCTIONS)
 } mrbc_vm;
 typedef struct VM mrb_vm;
 
@@ -108,8 +134,12 @@ void mrbc_cleanup_vm(void);
 const char *mrbc_get_callee_name(struct VM *vm);
 mrbc_irep *mrbc_irep_alloc(struct VM *vm);
 void mrbc_irep_free(mrbc_irep *irep);
+int mrbc_stack_overflow(struct VM *vm);
 mrbc_callinfo * mrbc_push_callinfo( struct VM *vm, mrbc_sym method_id, int reg_offset, int n_args );
 void mrbc_pop_callinfo(struct VM *vm);
+int mrbc_iterator_yield(struct VM *vm, mrbc_value v[], mrbc_func_t next, int argc, const mrbc_value *args);
+int mrbc_iterator_check_block(struct VM *vm, mrbc_value v[]);
+void mrbc_iterator_end(mrbc_value v[]);
 mrbc_vm *mrbc_vm_open(struct VM *vm_arg);
 void mrbc_vm_close(struct VM *vm);
 void mrbc_vm_begin(struct VM *vm);
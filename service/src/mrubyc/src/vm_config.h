@@ -25,9 +25,67 @@
 #define MAX_REGS_SIZE 100
 #endif
 
-// maximum number of symbols
+// maximum depth of method calls (size of the callinfo stack)
+#if !defined(MAX_CALLINFO_COUNT)
+#define MAX_CALLINFO_COUNT 32
+#endif
+
+// maximum number of runtime symbols
+//  the table grows up to this count, then String#to_sym and friends
+//  return nil and print "Overflow MAX_SYMBOLS_COUNT". other targets may
+//  go up to the range of mrbc_sym (32512), but hal_x86 keeps the
+//  original 255 to fit in its 30KB heap.
 #if !defined(MAX_SYMBOLS_COUNT)
-#define MAX_SYMBOLS_COUNT 255
+# if defined(MRBC_USE_HAL_X86)
+#  define MAX_SYMBOLS_COUNT 255
+# else
+#  define MAX_SYMBOLS_COUNT 32512
+# endif
+#endif
+
+// initial number of runtime symbols (grows by doubling)
+#if !defined(MRBC_SYMBOL_TABLE_INIT_SIZE)
+#define MRBC_SYMBOL_TABLE_INIT_SIZE 64
+#endif
+
+// Inline method cache for the OP_SEND family. (see send_by_irep_symbol)
+//  costs 20 bytes (32bit) per method name sent from each irep, and the
+//  String literal borrowing depends on it. hal_x86 runs the payload in a
+//  30KB heap, so it is off there by default.
+#if !defined(MRBC_USE_METHOD_CACHE)
+# if defined(MRBC_USE_HAL_X86)
+#  define MRBC_USE_METHOD_CACHE 0
+# else
+#  define MRBC_USE_METHOD_CACHE 1
+# endif
+#endif
+
+// max length of String stored in the same memory block as its handle.
+#if !defined(MRBC_STRING_INLINE_SIZE)
+#define MRBC_STRING_INLINE_SIZE 15
+#endif
+
+// max size of Array stored in the same memory block as its handle.
+#if !defined(MRBC_ARRAY_INLINE_SIZE)
+#define MRBC_ARRAY_INLINE_SIZE 6
+#endif
+
+// number of instructions executed in one timeslice without timer.
+//  (MRBC_NO_TIMER only)
+#if !defined(MRBC_INSTRUCTION_BUDGET)
+#define MRBC_INSTRUCTION_BUDGET 1000
+#endif
+
+// Dispatch instructions by computed goto (GCC "labels as values").
+//  define as 0 to use the switch statement.
+//  sample_c/benchmark.rb on i386 (32bit user mode): 152M instructions/s
+//  against 105M with the switch at -O2, and 34M for both at -O0.
+#if !defined(MRBC_DIRECT_THREADED)
+# if defined(__GNUC__)
+#  define MRBC_DIRECT_THREADED 1
+# else
+#  define MRBC_DIRECT_THREADED 0
+# endif
 #endif
 
 // maximum number of exception depth
@@ -35,6 +93,18 @@
 #define MAX_EXCEPTION_COUNT 16
 #endif
 
+// number of ready queues of the scheduler (power of 2, 1 to 256).
+//  task priority 0-255 is divided into this many levels. tasks sharing
+//  a level but not a priority are inserted by a linear search.
+#if !defined(MRBC_READY_QUEUE_LEVELS)
+#define MRBC_READY_QUEUE_LEVELS 32
+#endif
+
+// number of slots of the timer wheel for sleeping tasks (power of 2).
+#if !defined(MRBC_TIMER_WHEEL_SIZE)
+#define MRBC_TIMER_WHEEL_SIZE 32
+#endif
+
 
 // memory management
 //  MRBC_ALLOC_16BIT or MRBC_ALLOC_24BIT
@@ -97,4 +167,8 @@
 
 // #define MRBC_NO_TIMER
 
+// Count executed instructions in mrbc_vm::inst_count (for benchmark).
+//  see sample_c/sample_benchmark.c
+// #define MRBC_COUNT_INSTRUCTIONS
+
 #endif
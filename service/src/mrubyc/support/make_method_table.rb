@@ -11,9 +11,69 @@
 # (usage)
 # ruby make_method_table.rb TARGET_CLASS_FILE.c
 #
+#  symbol_builtin.h in the current directory must be up to date,
+#  because the table is indexed by built-in symbol ID.
+#
 
 require_relative "common_sub"
 
+SYMBOL_TABLE_FILENAME = "symbol_builtin.h"
+
+
+
+##
+# read symbol IDs from symbol_builtin.h
+#
+def read_symbol_id( filename = SYMBOL_TABLE_FILENAME )
+  ret = {}
+  File.open( filename ) {|file|
+    while txt = file.gets
+      ret[$1] = $2.to_i  if /^\s*MRBC_SYMID_(\S+)\s*=\s*(\d+),/ =~ txt
+    end
+  }
+  return ret
+
+rescue Errno::ENOENT
+  puts "File can't open. #{filename}"
+  exit 1
+end
+
+
+##
+# decide the size of the direct-indexed table.
+#
+# (note)
+#  index = symbol_id % size. find the smallest size without collision.
+#
+def decide_table_size( ids )
+  return 0  if ids.empty?
+
+  size = ids.size
+  while ids.map {|id| id % size }.uniq.size != ids.size
+    size += 1
+  end
+  return size
+end
+
+
+##
+# output an element of the table with #if condition.
+#
+def output_element( file, method, value, empty )
+  if !method
+    file.puts "    #{empty},"
+    return
+  end
+
+  if_exp = method[:if_exp] || []
+  file.puts if_exp.join  if !if_exp.empty?
+  file.puts "    #{value},"
+  if_exp.size.times {
+    file.puts "#else"
+    file.puts "    #{empty},"
+    file.puts "#endif"
+  }
+end
 
 
 ##
@@ -21,7 +81,17 @@ require_relative "common_sub"
 #
 def output_header_file( param )
   flag_error = false
-  param[:methods].sort_by! {|m| m[:name] }
+  table = []
+  param[:methods].each {|m|
+    id = $symbol_id[rename_for_symbol(m[:name])]
+    if !id
+      puts "Error: symbol '#{m[:name]}' is not found in #{SYMBOL_TABLE_FILENAME}."
+      return false
+    end
+    m[:id] = id
+  }
+  size = decide_table_size( param[:methods].map {|m| m[:id] } )
+  param[:methods].each {|m| table[m[:id] % size] = m }
 
   begin
     file = File.open( strip_double_quot(param[:file]), "w" )
@@ -35,19 +105,16 @@ def output_header_file( param )
   file.puts "struct RClass *#{strip_double_quot(param[:func])}(struct VM *vm)"
   file.puts "{"
   file.puts "  static const mrbc_sym method_symbols[] = {"
-
-  param[:methods].each {|m|
-    file.puts m[:if_exp].join  if m[:if_exp]
-    file.puts "    MRBC_SYMID_#{rename_for_symbol(m[:name])},"
-    m[:if_exp].size.times { file.puts "#endif" }  if m[:if_exp]
+  size.times {|i|
+    m = table[i]
+    output_element( file, m, m && "MRBC_SYMID_#{rename_for_symbol(m[:name])}", -1 )
   }
   file.puts "  };"
 
   file.puts "  static const mrbc_func_t method_functions[] = {"
-  param[:methods].each {|m|
-    file.puts m[:if_exp].join  if m[:if_exp]
-    file.puts "    #{m[:func]},"
-    m[:if_exp].size.times { file.puts "#endif" }  if m[:if_exp]
+  size.times {|i|
+    m = table[i]
+    output_element( file, m, m && m[:func], 0 )
   }
   file.puts "  };"
   file.puts
@@ -70,6 +137,7 @@ EOL
   exit 1
 end
 filename = ARGV[0]
+$symbol_id = read_symbol_id()
 
 begin
   file = File.open( filename )
@@ -20,7 +20,7 @@ require "optparse"
 require_relative "common_sub"
 
 OUTPUT_FILENAME = "symbol_builtin.h"
-APPEND_SYMBOL = ["initialize", "Exception", "message", "StandardError", "RuntimeError", "ZeroDivisionError", "ArgumentError", "IndexError", "TypeError", "collect", "map", "collect!", "map!", "delete_if", "each", "each_index", "each_with_index", "reject!", "reject", "sort!", "sort", "RUBY_VERSION", "MRUBYC_VERSION", "times", "loop", "each_byte", "each_char"]
+APPEND_SYMBOL = ["initialize", "Exception", "message", "StandardError", "RuntimeError", "ZeroDivisionError", "ArgumentError", "IndexError", "TypeError", "LocalJumpError", "collect", "map", "collect!", "map!", "delete_if", "each", "each_index", "each_with_index", "reject!", "reject", "sort!", "sort", "RUBY_VERSION", "MRUBYC_VERSION", "times", "loop", "each_byte", "each_char"]
 
 
 ##
@@ -31,6 +31,80 @@ def vp( s, level = 1 )
 end
 
 
+##
+# hash function. (FNV-1a)
+#  (note) same as calc_hash() in symbol.c
+#
+def calc_hash( s )
+  h = 2166136261
+  s.each_byte {|b|
+    h ^= b
+    h = (h * 16777619) & 0xffffffff
+  }
+  return h
+end
+
+
+##
+# secondary hash function with displacement.
+#  (note) same as calc_hash2() in symbol.c
+#
+def calc_hash2( h, d )
+  h = (h + d * 0x9e3779b9) & 0xffffffff
+  h ^= h >> 16
+  h = (h * 0x85ebca6b) & 0xffffffff
+  h ^= h >> 13
+  return h
+end
+
+
+##
+# make minimal perfect hash table. (hash and displace)
+#
+# (note)
+#  bucket = calc_hash(s) % n
+#  disp[bucket] >= 0 : index = calc_hash2( calc_hash(s), disp[bucket] ) % n
+#  disp[bucket] <  0 : index = -disp[bucket] - 1
+#
+def make_perfect_hash( symbols )
+  n = symbols.size
+  buckets = Array.new(n) { [] }
+  symbols.each {|s| buckets[calc_hash(s) % n] << s }
+
+  table = Array.new(n)
+  disp = Array.new(n, 0)
+  order = (0...n).sort_by {|b| -buckets[b].size }
+
+  order.each {|b|
+    bucket = buckets[b]
+    break if bucket.size <= 1
+
+    d = 0
+    while true
+      slots = bucket.map {|s| calc_hash2(calc_hash(s), d) % n }
+      break if slots.uniq.size == slots.size && slots.all? {|i| !table[i] }
+      d += 1
+      if d > 0x7fff
+        STDERR.puts "Can't make perfect hash table."
+        exit 1
+      end
+    end
+    bucket.each_with_index {|s,i| table[slots[i]] = s }
+    disp[b] = d
+  }
+
+  free_slots = (0...n).select {|i| !table[i] }
+  order.each {|b|
+    next if buckets[b].size != 1
+    i = free_slots.shift
+    table[i] = buckets[b][0]
+    disp[b] = -i - 1
+  }
+
+  return table, disp
+end
+
+
 ##
 # parse command line option
 #
@@ -105,6 +179,9 @@ if all_symbols.size > 256
   exit 1
 end
 
+# symbol ID is the position in the perfect hash table.
+all_symbols, disp = make_perfect_hash( all_symbols )
+
 # output symbol table file.
 output_filename = $options[:o] || OUTPUT_FILENAME
 vp("Output file '#{output_filename}'")
@@ -126,6 +203,16 @@ all_symbols.each {|s|
   file.puts %!  "#{s}",!
 }
 file.puts "};"
+file.puts "static const uint8_t builtin_symbols_len[] = {"
+all_symbols.each_slice(16) {|a|
+  file.puts "  " + a.map {|s| "#{s.bytesize}," }.join(" ")
+}
+file.puts "};"
+file.puts "static const int16_t builtin_symbols_disp[] = {"
+disp.each_slice(16) {|a|
+  file.puts "  " + a.map {|d| "#{d}," }.join(" ")
+}
+file.puts "};"
 file.puts "#endif"
 file.puts
 
@@ -145,6 +145,23 @@ class ArrayTest < MrubycTestCase
     assert_equal [1,2], a
   end
 
+  description "push / unshift to small array"
+  def grow_case
+    a = [1,2,3]
+    a.push(4)
+    a.push("five")
+    a.unshift(0)
+    a.push(6)
+    a.push(7)
+    assert_equal [0,1,2,3,4,"five",6,7], a
+    assert_equal 8, a.size
+
+    b = a.dup
+    b[10] = 10
+    assert_equal [0,1,2,3,4,"five",6,7,nil,nil,10], b
+    assert_equal [0,1,2,3,4,"five",6,7], a
+  end
+
   description "unshift / shift"
   def shift_case
     a = []
@@ -160,6 +177,35 @@ class ArrayTest < MrubycTestCase
     assert_equal [], a
   end
 
+  description "push / shift as a queue"
+  def queue_case
+    a = []
+    i = 0
+    while i < 40
+      a.push(i * 2)
+      a.push(i * 2 + 1)
+      assert_equal i, a.shift()
+      i += 1
+    end
+    assert_equal 40, a.size
+    assert_equal 40, a[0]
+    assert_equal 79, a[-1]
+
+    a.unshift(-1)
+    a.unshift(-2)
+    assert_equal [-2,-1,40,41], a[0,4]
+    assert_equal -1, a.delete_at(1)
+    assert_equal 41, a.delete_at(2)
+    assert_equal [-2,40,42], a[0,3]
+    assert_equal 40, a.size
+
+    a.clear
+    assert_equal [], a
+    a.unshift(1)
+    a.push(2)
+    assert_equal [1,2], a
+  end
+
   description "dup"
   def dup_case
     a = [1,2,3]
@@ -194,6 +240,36 @@ class ArrayTest < MrubycTestCase
     assert_equal [nil,nil], a.minmax
   end
 
+  description "sort, sort!"
+  def sort_case
+    a = [3,1,4,1,5,9,2,6,5,3,5,8,9,7,9,3,2,3,8,4,6,2,6,4,3]
+    assert_equal [1,1,2,2,2,3,3,3,3,3,4,4,4,5,5,5,6,6,6,7,8,8,9,9,9], a.sort
+    assert_equal 3, a[0]
+    assert_equal [9,9,9,8,8,7,6,6,6,5,5,5,4,4,4,3,3,3,3,3,2,2,2,1,1], a.sort {|x,y| y <=> x }
+
+    b = []
+    i = 0
+    while i < 100
+      b << (i * 37) % 101
+      i += 1
+    end
+    b.sort!
+    assert_equal 0, b[0]
+    assert_equal 100, b[-1]
+    assert_equal true, b == b.sort {|x,y| x <=> y }
+
+    assert_equal %w(ab abc b bc c), %w(bc abc c b ab).sort
+    assert_equal %w(c bc b abc ab), %w(bc abc c b ab).sort {|x,y| y <=> x }
+    assert_equal [], [].sort
+    assert_equal [1], [1].sort {|x,y| y <=> x }
+
+    c = [[2,"b"], [1,"a"], [2,"a"], [1,"b"]]
+    assert_equal [[1,"a"], [1,"b"], [2,"b"], [2,"a"]], c.sort {|x,y| x[0] <=> y[0] }
+    c.sort! {|x,y| y[0] <=> x[0] }
+    assert_equal [[2,"b"], [2,"a"], [1,"a"], [1,"b"]], c
+    assert_equal 42, [3,1,2].sort! {|x,y| break 42 }
+  end
+
   description "inspect, to_s, join"
   def inspect_case
     a = [1,2,3]
@@ -174,4 +174,70 @@ class HashTest < MrubycTestCase
     assert_equal( {}, h.to_h )
   end
 
+  description "大きなハッシュ"
+  def large_hash_case
+    h = {}
+    i = 0
+    while i < 100
+      h[i] = i * 2
+      h["s#{i}"] = i
+      i += 1
+    end
+    assert_equal( 200, h.size )
+    assert_equal( 0, h[0] )
+    assert_equal( 198, h[99] )
+    assert_equal( 50, h["s50"] )
+    assert_equal( 198, h[99.0] )
+    assert_equal( nil, h[100] )
+    assert_equal( nil, h["s100"] )
+    assert_equal( true, h.has_key?("s99") )
+
+    h[50] = "fifty"
+    assert_equal( "fifty", h[50] )
+    assert_equal( 200, h.size )
+  end
+
+  description "大きなハッシュの delete"
+  def large_hash_delete_case
+    h = {:a=>1, :b=>2, :c=>3, :d=>4, :e=>5, :f=>6, :g=>7, :h=>8}
+    assert_equal( 3, h.delete(:c) )
+    assert_equal( 6, h.delete(:f) )
+    assert_equal( nil, h.delete(:f) )
+    assert_equal( 6, h.size )
+    assert_equal( [:a, :b, :d, :e, :g, :h], h.keys )
+    assert_equal( nil, h[:c] )
+    assert_equal( 7, h[:g] )
+
+    h[:c] = 33
+    assert_equal( [:a, :b, :d, :e, :g, :h, :c], h.keys )
+    assert_equal( {:a=>1, :b=>2, :d=>4, :e=>5, :g=>7, :h=>8, :c=>33}, h )
+    assert_equal( h, h.dup )
+
+    h.delete(:a)
+    h.delete(:b)
+    h.delete(:d)
+    h.delete(:e)
+    assert_equal( {:g=>7, :h=>8, :c=>33}, h )
+    assert_equal( 8, h[:h] )
+
+    h.clear
+    assert_equal( 0, h.size )
+    assert_equal( nil, h[:g] )
+  end
+
+  description "大きなハッシュの delete と each"
+  def large_hash_delete_each_case
+    h = {:a=>1, :b=>2, :c=>3, :d=>4, :e=>5, :f=>6, :g=>7, :h=>8}
+    h.delete(:c)
+    h.delete(:f)
+
+    a = []
+    h.each {|k, v| a << k << v }
+    assert_equal( [:a, 1, :b, 2, :d, 4, :e, 5, :g, 7, :h, 8], a )
+
+    h.delete(:h)
+    a = []
+    h.each {|k, v| a << k }
+    assert_equal( [:a, :b, :d, :e, :g], a )
+  end
 end
@@ -20,4 +20,15 @@ class MyBlock
   def result
     @result
   end
+
+  def find_over(array, limit)
+    array.each do |v|
+      return v if v > limit
+    end
+    nil
+  end
+
+  def yield_twice
+    [1, 2].each {|v| yield v }
+  end
 end
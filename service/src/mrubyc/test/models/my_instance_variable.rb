@@ -6,4 +6,9 @@ class MyInstanceVariable
     @r1 = v1
     @r2 = v2
   end
+
+  def method2(v1,v2)
+    @r2 = v2
+    @r1 = v1
+  end
 end
@@ -0,0 +1,23 @@
+class MyMethod
+  # more methods than the initial size of the method table.
+  def m1; 1; end
+  def m2; 2; end
+  def m3; 3; end
+  def m4; 4; end
+  def m5; 5; end
+  def m6; 6; end
+  def m7; 7; end
+  def m8; 8; end
+  def m9; 9; end
+  def m10; 10; end
+  def m11; 11; end
+  def m12; 12; end
+
+  # redefinition
+  def m3; 30; end
+  def m11; 110; end
+end
+
+class MyMethodSub < MyMethod
+  def m4; 40; end
+end
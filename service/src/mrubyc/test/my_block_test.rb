@@ -18,4 +18,70 @@ class MyBlockTest < MrubycTestCase
     @obj.each_double([1, 2, 3])
     assert_equal [2, 4, 6], @obj.result
   end
+
+  description "break, next and return in the block of iterator"
+  def iterator_jump_case
+    sum = 0
+    ret = 10.times {|i|
+      next if i % 2 == 0
+      break i * 100 if i > 6
+      sum += i
+    }
+    assert_equal 700, ret
+    assert_equal 1 + 3 + 5, sum
+
+    assert_equal 3, [1, 2, 3, 4].each {|v| break v if v == 3 }
+    assert_equal [1, 2, 3], [1, 2, 3].each {|v| v }
+    assert_equal [1, 0, 3], [1, 2, 3].collect {|v| next 0 if v == 2; v }
+    assert_equal 5, @obj.find_over([1, 5, 9], 3)
+    assert_equal nil, @obj.find_over([1, 2], 3)
+  end
+
+  description "nested iterators"
+  def iterator_nested_case
+    a = []
+    (1..3).each {|i|
+      [10, 20].each_with_index {|v, j|
+        a << i * v + j
+      }
+    }
+    assert_equal [10, 21, 20, 41, 30, 61], a
+
+    h = {}
+    {:a => 1, :b => 2}.each {|k, v|
+      "xy".each_char {|c| h[c + k.to_s] = v }
+    }
+    assert_equal({"xa"=>1, "ya"=>1, "xb"=>2, "yb"=>2}, h)
+
+    b = []
+    @obj.yield_twice {|v| 2.times {|i| b << v * 10 + i } }
+    assert_equal [10, 11, 20, 21], b
+  end
+
+  description "iterator without block"
+  def iterator_without_block_case
+    e = nil
+    begin
+      [1, 2].each
+    rescue LocalJumpError
+      e = LocalJumpError
+    end
+    assert_equal LocalJumpError, e
+
+    e = nil
+    begin
+      3.times
+    rescue LocalJumpError
+      e = LocalJumpError
+    end
+    assert_equal LocalJumpError, e
+
+    e = nil
+    begin
+      (1.0..2.0).each {|v| }
+    rescue TypeError
+      e = TypeError
+    end
+    assert_equal TypeError, e
+  end
 end
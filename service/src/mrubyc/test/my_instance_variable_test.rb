@@ -27,4 +27,33 @@ class MyInstanceVariableTest < MrubycTestCase
     assert_equal [111,222,333,444], [obj1.r1, obj1.r2, obj1.rw1, obj1.rw2]
     assert_equal [nil,nil,2211,2222], [obj2.r1, obj2.r2, obj2.rw1, obj2.rw2]
   end
+
+  description 'instance variables in different order'
+  def order_case
+    obj1 = MyInstanceVariable.new
+    obj2 = MyInstanceVariable.new
+    obj1.method1( 1, 2 )
+    obj2.method2( 3, 4 )
+    assert_equal [1,2], [obj1.r1, obj1.r2]
+    assert_equal [3,4], [obj2.r1, obj2.r2]
+
+    obj2.rw1 = 5
+    obj1.method2( 6, 7 )
+    assert_equal [6,7,nil], [obj1.r1, obj1.r2, obj1.rw1]
+    assert_equal [3,4,5], [obj2.r1, obj2.r2, obj2.rw1]
+  end
+
+  description 'dup'
+  def dup_case
+    obj1 = MyInstanceVariable.new
+    obj1.method1( "a", "b" )
+    obj1.rw2 = [1,2]
+    obj2 = obj1.dup
+    assert_equal ["a","b",nil,[1,2]], [obj2.r1, obj2.r2, obj2.rw1, obj2.rw2]
+
+    obj2.rw1 = 10
+    obj2.rw2 = 20
+    assert_equal ["a","b",nil,[1,2]], [obj1.r1, obj1.r2, obj1.rw1, obj1.rw2]
+    assert_equal ["a","b",10,20], [obj2.r1, obj2.r2, obj2.rw1, obj2.rw2]
+  end
 end
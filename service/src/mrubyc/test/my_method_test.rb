@@ -0,0 +1,30 @@
+# frozen_string_literal: true
+
+class MyMethodTest < MrubycTestCase
+  def setup
+    @obj = MyMethod.new
+    @sub = MyMethodSub.new
+  end
+
+  description 'many methods'
+  def many_methods_case
+    assert_equal 1, @obj.m1
+    assert_equal 2, @obj.m2
+    assert_equal 5, @obj.m5
+    assert_equal 8, @obj.m8
+    assert_equal 12, @obj.m12
+  end
+
+  description 'redefine method'
+  def redefine_case
+    assert_equal 30, @obj.m3
+    assert_equal 110, @obj.m11
+  end
+
+  description 'method of super class'
+  def super_class_case
+    assert_equal 40, @sub.m4
+    assert_equal 1, @sub.m1
+    assert_equal 30, @sub.m3
+  end
+end
@@ -109,4 +109,21 @@ class StringSplitTest < MrubycTestCase
     assert_equal [""],      "  ".split(" ",-1)
   end
 
+  description "tokens share the buffer of the source"
+  def shared_buffer_case
+    s = "THERM set morning monday 23\n"
+    cmd = s.split(" ")
+    assert_equal ["THERM", "set", "morning", "monday", "23"], cmd
+
+    t = cmd[2]
+    t << "!"
+    s[0, 5] = "ALARM"
+    assert_equal "ALARM set morning monday 23\n", s
+    assert_equal ["THERM", "set", "morning!", "monday", "23"], cmd
+    assert_equal 23, cmd[4].to_i
+    assert_equal :monday, cmd[3].to_sym
+    assert_equal ["mon", "ay"], cmd[3].split("d")
+    assert_equal "set morning", s[6, 11]
+  end
+
 end
@@ -223,4 +223,23 @@ class StringStripTest < MrubycTestCase
     assert_equal "", s
   end
 
+  description "long string"
+  def long_string_case
+    s1 = "   long string to be stripped   \n"
+    s2 = s1.strip
+    s2 << "!"
+    assert_equal "   long string to be stripped   \n", s1
+    s1.strip!
+    assert_equal "long string to be stripped", s1
+    assert_equal "long string to be stripped!", s2
+
+    s1 = "line of the long command\r\n"
+    s2 = s1.chomp
+    s1.chomp!
+    assert_equal s2, s1
+    s2[0, 4] = "LINE"
+    assert_equal "LINE of the long command", s2
+    assert_equal "line of the long command", s1
+  end
+
 end
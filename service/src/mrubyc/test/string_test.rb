@@ -53,6 +53,27 @@ class StringTest < MrubycTestCase
     assert_equal "ABCDEFG0123456789abcA", s1
   end
 
+  description "self << other, many times"
+  def addi_many_case
+    s1 = ""
+    s2 = ""
+    i = 0
+    while i < 300
+      s1 << (i % 26 + 97)
+      s2 << "#{i % 10}"
+      i += 1
+    end
+    assert_equal 300, s1.size
+    assert_equal "abcdefghijklmnopqrstuvwxyza", s1[0, 27]
+    assert_equal "lmn", s1[-3, 3]
+    assert_equal "0123456789", s2[290, 10]
+
+    s2[0, 290] = "x"
+    assert_equal "x0123456789", s2
+    s2 << "y"
+    assert_equal "x0123456789y", s2
+  end
+
   description "self <=> other -> (minus) | 0 | (plus) | nil"
   def compare_case
     assert ("aaa" <=> "xxx") < 0
@@ -332,6 +353,90 @@ class StringTest < MrubycTestCase
     assert_equal 97, "abcde".ord
   end
 
+  description "literal"
+  def literal_case
+    a = []
+    n = 0
+    i = 0
+    while i < 3
+      s1 = "abc"
+      s1 << i.to_s
+      s2 = "long string literal"
+      s2[0, 4] = "LONG"
+      a << s1 << s2
+      n += 1 if s1 == "abc1"
+      n += 1 if "long string literal" == "long string literal"
+      i += 1
+    end
+    assert_equal ["abc0", "LONG string literal", "abc1", "LONG string literal",
+                  "abc2", "LONG string literal"], a
+    assert_equal 4, n
+    assert_equal "long string literal", "long string literal"
+  end
+
+  description "literal shared by the readers"
+  def literal_shared_case
+    ids = []
+    keep = []
+    base = "k" * 40
+    i = 0
+    while i < 4
+      ids << "shared literal, long enough".object_id
+      keep << base.dup
+      i += 1
+    end
+    assert_equal ids[1], ids[2]
+    assert_equal ids[1], ids[3]
+    assert_equal ["a", "b"], "a,b".split(",")
+  end
+
+  description "literal assigned in a condition"
+  def literal_in_condition_case
+    a = []
+    i = 0
+    while i < 3
+      if i == (s = "abc")
+      end
+      s << "Z"
+      a << s
+      i += 1
+    end
+    assert_equal ["abcZ", "abcZ", "abcZ"], a
+  end
+
+  description "one character"
+  def one_character_case
+    s1 = "abcde"
+    s2 = ""
+    i = 0
+    while i < s1.size
+      s2 << s1[i]
+      i += 1
+    end
+    assert_equal "abcde", s2
+    assert_equal "c", s1[2]
+    assert_equal "e", s1[-1]
+    assert_equal nil, s1[5]
+
+    s3 = s1[1].dup
+    s3 << "x"
+    assert_equal "bx", s3
+    assert_equal "b", s1[1]
+    assert_equal 255, 255.chr.ord
+
+    s4 = s1[1]
+    e = nil
+    begin
+      s4 << "z"
+    rescue RuntimeError
+      e = RuntimeError
+    end
+    assert_equal RuntimeError, e
+    assert_equal "b", s4
+    assert_equal "b", s1[1]
+    assert_equal "bz", s4 + "z"
+  end
+
   description "binary string"
   def binary_case
     s1 = "ABC\x00\x0d\x0e\x0f"
@@ -30,4 +30,88 @@ class SymbolTest < MrubycTestCase
     assert_equal "symbol", s.to_s
     assert_not_equal "symbol", s
   end
+
+  description "inspect"
+  def inspect_case
+    assert_equal ":symbol", :symbol.inspect
+  end
+
+  description "@ で始まるシンボル"
+  def ivar_name_symbol_case
+    assert_equal ":@foo", :@foo.inspect
+    assert_equal "@foo", :@foo.to_s
+    assert_equal true, :@x == "@x".to_sym
+    assert_not_equal :x, :@x
+
+    @sym_ivar = 10
+    assert_equal 10, @sym_ivar
+    assert_equal "@sym_ivar", :@sym_ivar.to_s
+  end
+
+  description "300 個のシンボルを参照するメソッド"
+  def many_symbol_literals_case
+    a = []
+    a << :sl_000 << :sl_001 << :sl_002 << :sl_003 << :sl_004 << :sl_005 << :sl_006 << :sl_007 << :sl_008 << :sl_009
+    a << :sl_010 << :sl_011 << :sl_012 << :sl_013 << :sl_014 << :sl_015 << :sl_016 << :sl_017 << :sl_018 << :sl_019
+    a << :sl_020 << :sl_021 << :sl_022 << :sl_023 << :sl_024 << :sl_025 << :sl_026 << :sl_027 << :sl_028 << :sl_029
+    a << :sl_030 << :sl_031 << :sl_032 << :sl_033 << :sl_034 << :sl_035 << :sl_036 << :sl_037 << :sl_038 << :sl_039
+    a << :sl_040 << :sl_041 << :sl_042 << :sl_043 << :sl_044 << :sl_045 << :sl_046 << :sl_047 << :sl_048 << :sl_049
+    a << :sl_050 << :sl_051 << :sl_052 << :sl_053 << :sl_054 << :sl_055 << :sl_056 << :sl_057 << :sl_058 << :sl_059
+    a << :sl_060 << :sl_061 << :sl_062 << :sl_063 << :sl_064 << :sl_065 << :sl_066 << :sl_067 << :sl_068 << :sl_069
+    a << :sl_070 << :sl_071 << :sl_072 << :sl_073 << :sl_074 << :sl_075 << :sl_076 << :sl_077 << :sl_078 << :sl_079
+    a << :sl_080 << :sl_081 << :sl_082 << :sl_083 << :sl_084 << :sl_085 << :sl_086 << :sl_087 << :sl_088 << :sl_089
+    a << :sl_090 << :sl_091 << :sl_092 << :sl_093 << :sl_094 << :sl_095 << :sl_096 << :sl_097 << :sl_098 << :sl_099
+    a << :sl_100 << :sl_101 << :sl_102 << :sl_103 << :sl_104 << :sl_105 << :sl_106 << :sl_107 << :sl_108 << :sl_109
+    a << :sl_110 << :sl_111 << :sl_112 << :sl_113 << :sl_114 << :sl_115 << :sl_116 << :sl_117 << :sl_118 << :sl_119
+    a << :sl_120 << :sl_121 << :sl_122 << :sl_123 << :sl_124 << :sl_125 << :sl_126 << :sl_127 << :sl_128 << :sl_129
+    a << :sl_130 << :sl_131 << :sl_132 << :sl_133 << :sl_134 << :sl_135 << :sl_136 << :sl_137 << :sl_138 << :sl_139
+    a << :sl_140 << :sl_141 << :sl_142 << :sl_143 << :sl_144 << :sl_145 << :sl_146 << :sl_147 << :sl_148 << :sl_149
+    a << :sl_150 << :sl_151 << :sl_152 << :sl_153 << :sl_154 << :sl_155 << :sl_156 << :sl_157 << :sl_158 << :sl_159
+    a << :sl_160 << :sl_161 << :sl_162 << :sl_163 << :sl_164 << :sl_165 << :sl_166 << :sl_167 << :sl_168 << :sl_169
+    a << :sl_170 << :sl_171 << :sl_172 << :sl_173 << :sl_174 << :sl_175 << :sl_176 << :sl_177 << :sl_178 << :sl_179
+    a << :sl_180 << :sl_181 << :sl_182 << :sl_183 << :sl_184 << :sl_185 << :sl_186 << :sl_187 << :sl_188 << :sl_189
+    a << :sl_190 << :sl_191 << :sl_192 << :sl_193 << :sl_194 << :sl_195 << :sl_196 << :sl_197 << :sl_198 << :sl_199
+    a << :sl_200 << :sl_201 << :sl_202 << :sl_203 << :sl_204 << :sl_205 << :sl_206 << :sl_207 << :sl_208 << :sl_209
+    a << :sl_210 << :sl_211 << :sl_212 << :sl_213 << :sl_214 << :sl_215 << :sl_216 << :sl_217 << :sl_218 << :sl_219
+    a << :sl_220 << :sl_221 << :sl_222 << :sl_223 << :sl_224 << :sl_225 << :sl_226 << :sl_227 << :sl_228 << :sl_229
+    a << :sl_230 << :sl_231 << :sl_232 << :sl_233 << :sl_234 << :sl_235 << :sl_236 << :sl_237 << :sl_238 << :sl_239
+    a << :sl_240 << :sl_241 << :sl_242 << :sl_243 << :sl_244 << :sl_245 << :sl_246 << :sl_247 << :sl_248 << :sl_249
+    a << :sl_250 << :sl_251 << :sl_252 << :sl_253 << :sl_254 << :sl_255 << :sl_256 << :sl_257 << :sl_258 << :sl_259
+    a << :sl_260 << :sl_261 << :sl_262 << :sl_263 << :sl_264 << :sl_265 << :sl_266 << :sl_267 << :sl_268 << :sl_269
+    a << :sl_270 << :sl_271 << :sl_272 << :sl_273 << :sl_274 << :sl_275 << :sl_276 << :sl_277 << :sl_278 << :sl_279
+    a << :sl_280 << :sl_281 << :sl_282 << :sl_283 << :sl_284 << :sl_285 << :sl_286 << :sl_287 << :sl_288 << :sl_289
+    a << :sl_290 << :sl_291 << :sl_292 << :sl_293 << :sl_294 << :sl_295 << :sl_296 << :sl_297 << :sl_298 << :sl_299
+    assert_equal 300, a.size
+    assert_equal :sl_000, a[0]
+    assert_equal :sl_299, a[299]
+    assert_equal "sl_150", a[150].to_s
+    assert_equal "1", 1.to_s
+  end
+
+  description "多数のシンボル"
+  def many_symbols_case
+    i = 0
+    while i < 100
+      s = "many_symbols_#{i}"
+      assert_equal s, s.to_sym.to_s
+      i += 1
+    end
+    assert_equal :many_symbols_0, "many_symbols_0".to_sym
+    assert_equal :many_symbols_99, "many_symbols_99".to_sym
+    assert_not_equal :many_symbols_1, "many_symbols_10".to_sym
+  end
+
+  description "シンボルテーブルが一杯になった時"
+  def symbol_table_full_case
+    i = 0
+    while "symbol_full_#{i}".to_sym
+      i += 1
+    end
+    n = Symbol.all_symbols.size
+    assert_nil "symbol_full_#{i}".to_sym
+    assert_nil "symbol_full_x".to_sym
+    assert_equal n, Symbol.all_symbols.size
+    assert_equal :symbol_full_0, "symbol_full_0".to_sym
+    assert_equal "symbol_full_#{i - 1}", "symbol_full_#{i - 1}".to_sym.to_s
+  end
 end
@@ -21,10 +21,11 @@ static void c_debugprint(mrb_vm *vm, mrb_value *v, int argc){
   for( int i = 0; i < 79; i++ ) { console_putchar('='); }
   console_putchar('\n');
   unsigned char *message = GET_STRING_ARG(1);
-  console_printf("%s\n", message);
-  int total, used, free, fragment;
-  mrbc_alloc_statistics( &total, &used, &free, &fragment );
-  console_printf("Memory total:%d, used:%d, free:%d, fragment:%d\n", total, used, free, fragment );
+  if( message ) console_printf("%s\n", message);
+  struct MRBC_ALLOC_STATISTICS mem;
+  mrbc_alloc_statistics( &mem );
+  console_printf("Memory total:%d, used:%d, free:%d, fragment:%d\n", mem.total, mem.used, mem.free, mem.fragmentation );
+  console_printf("Slab slots:%d/%d, pages:%d\n", mem.slab_used, mem.slab_slots, mem.slab_pages );
   for( int i = 0; i < 79; i++ ) { console_putchar('='); }
   console_putchar('\n');
   console_putchar('\n');
@@ -72,6 +72,11 @@ static int UnBase64(unsigned char *dest, const unsigned char *src, int srclen) {
 static void c_b64_decode(mrbc_vm *vm, mrbc_value v[], int argc) {
 	mrbc_value ret;
 	unsigned char *instr = (unsigned char *)GET_STRING_ARG(1);
+	if (!instr) {
+		ret = mrbc_nil_value();
+		SET_RETURN(ret);
+		return;
+	}
 	unsigned char *outbuf = mrbc_alloc(vm , strlen((char *)instr));
 	if (!outbuf) {
 		ret = mrbc_nil_value();
@@ -0,0 +1,112 @@
+#!/bin/bash
+#
+# Boot the verify image under qemu with the same options as ../../wrapper,
+# drive the built-in payload REPL and check that the console and idle
+# behaviour still hold.
+#
+#   QEMU      qemu binary               (default: qemu-system-i386)
+#   KERNEL    image to boot             (default: ./verify)
+#   IDLE_SEC  idle measurement window   (default: 5)
+#   IDLE_MAX  max qemu CPU % while idle (default: 20)
+#   TIMEOUT   seconds to wait for output (default: 60)
+#
+QEMU=${QEMU:-qemu-system-i386}
+KERNEL=${KERNEL:-./verify}
+IDLE_SEC=${IDLE_SEC:-5}
+IDLE_MAX=${IDLE_MAX:-20}
+TIMEOUT=${TIMEOUT:-60}
+
+WORK=$(mktemp -d)
+FIFO=$WORK/stdin
+LOG=$WORK/console
+QPID=
+
+function cleanup {
+	exec 3>&- 2>/dev/null
+	[[ -n $QPID ]] && kill $QPID 2>/dev/null && wait $QPID 2>/dev/null
+	rm -rf "$WORK"
+}
+trap cleanup EXIT
+
+function check_cond {
+	local ACTUAL=$1
+	local EXPECTED=$2
+
+	if [[ $ACTUAL == $EXPECTED ]]; then
+		echo "Test OK"
+	else
+		echo "Test FAIL"
+		echo "[*] console output:"
+		cat -v "$LOG"
+		exit 1
+	fi
+
+	echo "----------------------------------------------------------"
+}
+
+# wait_for <count> <string>: wait until <string> has appeared <count> times.
+function wait_for {
+	local i
+	for (( i = 0; i < TIMEOUT * 10; i++ )); do
+		if (( $(grep -aoF -- "$2" "$LOG" | wc -l) >= $1 )); then
+			return 0
+		fi
+		kill -0 $QPID 2>/dev/null || return 1
+		sleep 0.1
+	done
+	return 1
+}
+
+function cpu_ticks {
+	awk '{ print $14 + $15 }' /proc/$QPID/stat
+}
+
+echo "[*] Boot testing $KERNEL"
+echo "----------------------------------------------------------"
+
+mkfifo "$FIFO"
+"$QEMU" \
+  -display none \
+  -monitor none \
+  -no-reboot \
+  -nodefaults -snapshot \
+  -chardev stdio,id=char0,mux=off,signal=off -serial chardev:char0 \
+  -m 64M \
+  -kernel "$KERNEL" \
+  $EXTRA_QEMU_FLAGS <"$FIFO" >"$LOG" 2>&1 &
+QPID=$!
+exec 3>"$FIFO"
+
+# Flag followed by a zero payload length selects the built-in payload.
+cat flag >&3
+printf '\0\0\0\0' >&3
+
+echo "[*] prompt"
+wait_for 1 "barbOS> "
+check_cond $? 0
+
+echo "[*] INFO"
+echo "INFO" >&3
+wait_for 1 "DEBUG: barbOS v0.0"
+check_cond $? 0
+
+echo "[*] HELP"
+echo "HELP" >&3
+wait_for 1 "try reversing it..."
+check_cond $? 0
+
+echo "[*] burst of commands in a single write"
+printf 'HELP\nINFO\nHELP\n' >&3
+wait_for 6 "barbOS> "
+check_cond $? 0
+ORDER=$(grep -aoE "try reversing it\.\.\.|DEBUG: barbOS v0\.0" "$LOG" | tail -n 3 | tr '\n' '|')
+check_cond "$ORDER" "try reversing it...|DEBUG: barbOS v0.0|try reversing it...|"
+
+echo "[*] idle CPU over ${IDLE_SEC}s"
+HZ=$(getconf CLK_TCK)
+T0=$(cpu_ticks)
+sleep "$IDLE_SEC"
+T1=$(cpu_ticks)
+PCT=$(( (T1 - T0) * 100 / (HZ * IDLE_SEC) ))
+echo "qemu used ${PCT}% CPU (limit ${IDLE_MAX}%)"
+check_cond $(( PCT < IDLE_MAX )) 1
@@ -7,24 +7,42 @@
 #define MRBC_NUM_UART 1
 #endif
 
-#define SERIAL_THR 0
-#define SERIAL_RBR 0
-#define SERIAL_LSR 5
-static uint8_t inb(uint16_t port)
-{
-	uint8_t val;
-	asm volatile ("inb %%dx, %%al;" : "=a" (val) : "d" (port));
-	return val;
-}
+// a task waits until this many bytes are buffered at most,
+// the rest of a longer read blocks.
+#if defined(MRBC_NO_TIMER)
+#define UART_RX_WAIT_MAX 1
+#else
+#define UART_RX_WAIT_MAX (HAL_UART_RX_BUFSIZE - 1)
+#endif
 
+// bytes are received by IRQ4 into the hal ring buffer.
+// hal_getchar() and hal_read() sleep by hlt while it is empty.
 static int getchar(void) {
-	const int serial_port = 0x3f8;
-	while ((inb(serial_port + SERIAL_LSR) & 1) == 0);
-	return inb(serial_port + SERIAL_RBR);
+	return hal_getchar();
 }
 
 static void read_bytes(unsigned char *buf, size_t len) {
-	while(len--) { *buf++ = getchar(); }
+	hal_read(0, buf, len);
+}
+
+// called by the scheduler with interrupts disabled.
+static int uart_ready(int need) {
+	return hal_read_available() >= need;
+}
+
+static int uart_line_ready(int need) {
+	return hal_read_until(13) > 0 || hal_read_available() >= need;
+}
+
+/* Park the calling task on the waiting queue until ready(need).
+ * The method is called again then, so return at once without
+ * touching the arguments if this returns 1.
+ */
+static int uart_wait(mrbc_vm *vm, int (*ready)(int), int need) {
+	if (need > UART_RX_WAIT_MAX) need = UART_RX_WAIT_MAX;
+	if (ready(need)) return 0;
+	mrbc_wait_io(vm, ready, need);
+	return 1;
 }
 
 static void c_uart_new(mrbc_vm *vm, mrbc_value v[], int argc) {
@@ -43,6 +61,13 @@ static void c_uart_new(mrbc_vm *vm, mrbc_value v[], int argc) {
 static void c_uart_read(mrbc_vm *vm, mrbc_value v[], int argc) {
 	mrbc_value ret;
 	int need_length = GET_INT_ARG(1);
+	if (uart_wait(vm, uart_ready, need_length)) return;
+	if (need_length == 1) {
+		// one character string is shared, not allocated.
+		ret = mrbc_string_char(getchar());
+		SET_RETURN(ret);
+		return;
+	}
 	char *buf = mrbc_alloc(vm , need_length + 1);
 	if (!buf) {
 		ret = mrbc_nil_value();
@@ -66,6 +91,7 @@ static void c_uart_gets(mrbc_vm *vm, mrbc_value v[], int argc) {
 	mrbc_value ret;
 	int cnt = 32;
 	int i = 0;
+	if (uart_wait(vm, uart_line_ready, UART_RX_WAIT_MAX)) return;
 	char *buf = mrbc_alloc(vm , cnt);
 	if (!buf) {
 		goto RETNULL;
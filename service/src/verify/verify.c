@@ -213,29 +213,21 @@ uint8_t inb(uint16_t port)
 	return val;
 }
 
-#define SERIAL_THR 0
-#define SERIAL_RBR 0
-#define SERIAL_LSR 5
-const int serial_port = 0x3f8;
-
+// printf output shares the hal transmit buffer with the mruby/c console.
 void _putchar(char ch)
 {
-	while ((inb(serial_port + SERIAL_LSR) & (1<<5)) == 0);
-	outb(serial_port + SERIAL_THR, ch);
+	hal_write(1, &ch, 1);
 }
 
+// received by IRQ4 into the hal ring buffer, see hal_x86/hal.c
 int getchar(void)
 {
-	const int serial_port = 0x3f8;
-	while ((inb(serial_port + SERIAL_LSR) & 1) == 0);
-	return inb(serial_port + SERIAL_RBR);
+	return hal_getchar();
 }
 
 void read_bytes(unsigned char *buf, size_t len)
 {
-	while (len--) {
-		*buf++ = getchar();
-	}
+	hal_read(0, buf, len);
 }
 
 static void shutdown(void)
@@ -255,6 +247,7 @@ void _start(void)
 {
 	asm volatile ("mov $stack_top, %esp;");
 	memset(&_bss_start_addr, 0, &_bss_end_addr-&_bss_start_addr);
+	hal_init();	// interrupts for UART receive. mrbc_init() skips it later.
 	read_flag();
 
 	printf("OOO Boootloader\n");